@@ -3,62 +3,249 @@
 
 #include <library/cpp/yson/node/node_io.h>
 
+#include <algorithm>
+
 namespace DFormats {
 
-TNode GetDataFromArray(std::shared_ptr<Array> array, int index) {
-    Y_ENSURE(0 <= index && index < array->length(),
-             "Invalid index. It must be in range [0; " + std::to_string(array->length()) + ").");
-
-    if (array->IsNull(index)) {
-        return TNode::CreateEntity();
-    }
-
-    switch (array->type_id()) {
-    case Type::BOOL:
-        return TNode(std::static_pointer_cast<BooleanArray>(array)->Value(index));
-    case Type::INT8:
-        return TNode(std::static_pointer_cast<NumericArray<Int8Type>>(array)->Value(index));
-    case Type::INT16:
-        return TNode(std::static_pointer_cast<NumericArray<Int16Type>>(array)->Value(index));
-    case Type::INT32:
-    case Type::DATE32:
-        return TNode(std::static_pointer_cast<NumericArray<Int32Type>>(array)->Value(index));
-    case Type::INT64:
-    case Type::DATE64:
-    case Type::TIMESTAMP:
-        return TNode(std::static_pointer_cast<NumericArray<Int64Type>>(array)->Value(index));
-    case Type::UINT8:
-        return TNode(static_cast<uint64_t>(std::static_pointer_cast<NumericArray<UInt8Type>>(array)->Value(index)));
-    case Type::UINT16:
-        return TNode(static_cast<uint64_t>(std::static_pointer_cast<NumericArray<UInt16Type>>(array)->Value(index)));
-    case Type::UINT32:
-        return TNode(static_cast<uint64_t>(std::static_pointer_cast<NumericArray<UInt32Type>>(array)->Value(index)));
-    case Type::UINT64:
-        return TNode(std::static_pointer_cast<NumericArray<UInt64Type>>(array)->Value(index));
-    case Type::FLOAT:
-        return TNode(std::static_pointer_cast<NumericArray<FloatType>>(array)->Value(index));
-    case Type::DOUBLE:
-        return TNode(std::static_pointer_cast<NumericArray<DoubleType>>(array)->Value(index));
-    case Type::STRING:
-        return TNode(std::static_pointer_cast<StringArray>(array)->GetString(index));
-    case Type::BINARY:
-        return TNode(std::static_pointer_cast<BinaryArray>(array)->GetString(index));
-    case Type::DICTIONARY: {
-        auto dictArray = std::static_pointer_cast<DictionaryArray>(array);
-        if (dictArray->indices()->IsNull(index)) {
-            return TNode::CreateEntity();
+template <typename T>
+T NodeToValue(const TNode& node) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return node.AsBool();
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return node.AsDouble();
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+        const auto& str = node.AsString();
+        return {str.data(), str.size()};
+    } else if constexpr (std::is_unsigned_v<T>) {
+        return node.IsUint64() ? node.AsUint64() : node.AsInt64();
+    } else {
+        return node.AsInt64();
+    }
+}
+
+namespace {
+
+bool MatchesNode(const TResolvedPredicate& predicate, const TNode& node) {
+    if (!node.HasValue()) {
+        return false;
+    }
+
+    return std::visit([&] (const auto& constant) {
+        using T = std::decay_t<decltype(constant)>;
+
+        if constexpr (std::is_same_v<T, std::string>) {
+            return predicate.Matches(NodeToValue<std::string_view>(node));
+        } else {
+            return predicate.Matches(NodeToValue<T>(node));
+        }
+    }, predicate.Value);
+}
+
+void ClearNulls(const Array& array, uint8_t* selection) {
+    if (array.null_count() == 0) {
+        return;
+    }
+
+    for (int64_t i = 0; i < array.length(); ++i) {
+        if (array.IsNull(i)) {
+            selection[i] = 0;
+        }
+    }
+}
+
+// Returns false if the physical type of the array doesn't match the predicate's value
+template <typename T, typename TConstant>
+bool SelectFixed(const TResolvedPredicate& predicate, const Array& array, uint8_t* selection) {
+    const auto* constant = std::get_if<TConstant>(&predicate.Value);
+    if (!constant) {
+        return false;
+    }
+
+    SelectMatching(array.data()->template GetValues<T>(1), array.length(), predicate.Op, *constant, selection);
+    ClearNulls(array, selection);
+    return true;
+}
+
+bool SelectStrings(const TResolvedPredicate& predicate, const Array& array, uint8_t* selection) {
+    if (!std::holds_alternative<std::string>(predicate.Value)) {
+        return false;
+    }
+
+    // StringArray is derived from BinaryArray
+    const auto& binaryArray = static_cast<const BinaryArray&>(array);
+    for (int64_t i = 0; i < array.length(); ++i) {
+        if (selection[i]) {
+            selection[i] = predicate.Matches(std::string_view(binaryArray.GetView(i)));
+        }
+    }
+
+    ClearNulls(array, selection);
+    return true;
+}
+
+bool SelectBooleans(const TResolvedPredicate& predicate, const Array& array, uint8_t* selection) {
+    if (!std::holds_alternative<bool>(predicate.Value)) {
+        return false;
+    }
+
+    const auto& booleanArray = static_cast<const BooleanArray&>(array);
+    for (int64_t i = 0; i < array.length(); ++i) {
+        selection[i] &= predicate.Matches(booleanArray.Value(i));
+    }
+
+    ClearNulls(array, selection);
+    return true;
+}
+
+}
+
+TArrowBatchColumnsPtr MakeBatchColumns(const std::shared_ptr<RecordBatch>& batch) {
+    auto res = std::make_shared<TArrowBatchColumns>();
+    res->Batch = batch;
+
+    for (int i = 0; i < batch->num_columns(); ++i) {
+        if (!IsReadingContextColumnName(batch->schema()->field(i)->name())) {
+            res->Columns.push_back(batch->column(i));
         }
-        auto arrIndex = dictArray->GetValueIndex(index);
-        return GetDataFromArray(dictArray->dictionary(), arrIndex);
     }
-    default:
-        ythrow yexception() << "Trying to read unsopported ARROW type " << array->type()->ToString();
+
+    return res;
+}
+
+// TArrowColumnBatch
+
+TArrowColumnBatch::TArrowColumnBatch(size_t tableIndex, std::shared_ptr<RecordBatch> batch, std::vector<int> columnIds)
+  : TableIndex_(tableIndex), Batch_(std::move(batch)), ColumnIds_(std::move(columnIds))
+  , Materialized_(ColumnIds_.size()) { }
+
+size_t TArrowColumnBatch::GetTableIndex() const {
+    return TableIndex_;
+}
+
+size_t TArrowColumnBatch::RowsCount() const {
+    return Batch_->num_rows();
+}
+
+size_t TArrowColumnBatch::ColumnsCount() const {
+    return ColumnIds_.size();
+}
+
+template <typename T>
+TColumnView<T> TArrowColumnBatch::GetFixedColumn(size_t column, std::initializer_list<Type::type> types) const {
+    const auto& array = Batch_->column(ColumnIds_[column]);
+
+    if (std::find(types.begin(), types.end(), array->type_id()) == types.end()) {
+        return Materialize<T>(column);
+    }
+
+    TColumnView<T> res;
+    res.Values = array->data()->template GetValues<T>(1);
+    res.Size = array->length();
+    if (array->null_count() > 0) {
+        res.Nulls = {array->null_bitmap_data(), static_cast<size_t>(array->offset())};
+    }
+
+    return res;
+}
+
+template <typename T>
+TColumnView<T> TArrowColumnBatch::Materialize(size_t column) const {
+    auto& cached = Materialized_[column];
+
+    if (auto* builder = std::get_if<TColumnBuilder<T>>(&cached)) {
+        return builder->View();
+    }
+
+    const auto& array = Batch_->column(ColumnIds_[column]);
+    auto& builder = cached.emplace<TColumnBuilder<T>>(array->length());
+
+    for (int i = 0; i < array->length(); ++i) {
+        auto data = GetDataFromArray(array, i);
+        if (data.HasValue()) {
+            builder.Append(NodeToValue<T>(data));
+        } else {
+            builder.AppendNull();
+        }
     }
+
+    return builder.View();
+}
+
+TColumnView<bool> TArrowColumnBatch::GetBoolColumn(size_t column) const {
+    return Materialize<bool>(column);  // Arrow booleans are bit-packed
+}
+
+TColumnView<int8_t> TArrowColumnBatch::GetInt8Column(size_t column) const {
+    return GetFixedColumn<int8_t>(column, {Type::INT8});
+}
+
+TColumnView<int16_t> TArrowColumnBatch::GetInt16Column(size_t column) const {
+    return GetFixedColumn<int16_t>(column, {Type::INT16});
+}
+
+TColumnView<int32_t> TArrowColumnBatch::GetInt32Column(size_t column) const {
+    return GetFixedColumn<int32_t>(column, {Type::INT32, Type::DATE32});
+}
+
+TColumnView<int64_t> TArrowColumnBatch::GetInt64Column(size_t column) const {
+    return GetFixedColumn<int64_t>(column, {Type::INT64, Type::DATE64, Type::TIMESTAMP});
 }
 
+TColumnView<uint8_t> TArrowColumnBatch::GetUInt8Column(size_t column) const {
+    return GetFixedColumn<uint8_t>(column, {Type::UINT8});
+}
+
+TColumnView<uint16_t> TArrowColumnBatch::GetUInt16Column(size_t column) const {
+    return GetFixedColumn<uint16_t>(column, {Type::UINT16});
+}
+
+TColumnView<uint32_t> TArrowColumnBatch::GetUInt32Column(size_t column) const {
+    return GetFixedColumn<uint32_t>(column, {Type::UINT32});
+}
+
+TColumnView<uint64_t> TArrowColumnBatch::GetUInt64Column(size_t column) const {
+    return GetFixedColumn<uint64_t>(column, {Type::UINT64, Type::TIMESTAMP});
+}
+
+TColumnView<float> TArrowColumnBatch::GetFloatColumn(size_t column) const {
+    return GetFixedColumn<float>(column, {Type::FLOAT});
+}
+
+TColumnView<double> TArrowColumnBatch::GetDoubleColumn(size_t column) const {
+    return GetFixedColumn<double>(column, {Type::DOUBLE});
+}
+
+TColumnView<std::string_view> TArrowColumnBatch::GetStringColumn(size_t column) const {
+    const auto& array = Batch_->column(ColumnIds_[column]);
+
+    if (array->type_id() != Type::STRING && array->type_id() != Type::BINARY) {
+        return Materialize<std::string_view>(column);
+    }
+
+    // StringArray is derived from BinaryArray, offsets are already shifted by array's offset
+    auto binaryArray = std::static_pointer_cast<BinaryArray>(array);
+
+    TColumnView<std::string_view> res;
+    res.Offsets = binaryArray->raw_value_offsets();
+    res.Data = binaryArray->value_data() ? reinterpret_cast<const char*>(binaryArray->value_data()->data()) : nullptr;
+    res.Size = array->length();
+    if (array->null_count() > 0) {
+        res.Nulls = {array->null_bitmap_data(), static_cast<size_t>(array->offset())};
+    }
+
+    return res;
+}
+
+// TArrowRowReader
+
 TArrowRowReader::TArrowRowReader(::TIntrusivePtr<TRawTableReader> input, std::vector<NYT::TTableSchema> schemas)
   : Underlying_(std::move(input)), TableSchemas_(std::move(schemas)) {
 
+    RowTypes_.reserve(TableSchemas_.size());
+    for (const auto& tableSchema : TableSchemas_) {
+        RowTypes_.push_back(TableSchemaToStructType(tableSchema));
+    }
+
     auto result = ipc::RecordBatchStreamReader::Open(std::make_shared<TArrowInputStreamAdapter>(Underlying_.Get()));
     Y_ENSURE(result.ok(), "Error occured while openning Arrow stream reader: " << result.status().ToString());
     ArrowStream_ = *result;
@@ -69,21 +256,81 @@ TArrowRowReader::TArrowRowReader(::TIntrusivePtr<TRawTableReader> input, std::ve
 IRowPtr TArrowRowReader::ReadRow() {
     Y_ENSURE(IsValid(), "Trying to read row from empty batch");
 
-    auto schema = GetArrowSchema();
-    auto row = std::make_shared<TArrowRow>(TableSchemas_[ReadingContext_.TableIndex]);
-    auto fieldsNames = row->FieldsNames();
+    return std::make_shared<TArrowBatchRow>(RowTypes_[ReadingContext_.TableIndex], CurrentColumns_, CurrentBatchRowId_);
+}
+
+size_t TArrowRowReader::ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                                 std::vector<TReadingContext>* contexts) {
+    if (contexts) {
+        contexts->clear();
+    }
 
-    for (int i = 0, excluded = 0; i < schema->num_fields(); ++i) {
-        if (IsReadingContextColumnName(schema->field(i)->name())) {
-            ++excluded;
-            continue;
+    size_t count = 0;
+    for (; count < maxCount && IsValid(); ++count, Next()) {
+        if (count == rows.size()) {
+            rows.emplace_back();
         }
 
-        auto column = CurrentBatch_->column(i);
-        row->Underlying()[fieldsNames[i - excluded]] = GetDataFromArray(std::move(column), CurrentBatchRowId_);
+        const auto& rowType = RowTypes_[ReadingContext_.TableIndex];
+        auto& row = rows[count];
+        auto* batchRow = row.use_count() == 1 ? dynamic_cast<TArrowBatchRow*>(row.get()) : nullptr;
+
+        if (batchRow && batchRow->GetSchema().Get() == rowType.Get()) {
+            batchRow->Reset(CurrentColumns_, CurrentBatchRowId_);
+        } else {
+            row = std::make_shared<TArrowBatchRow>(rowType, CurrentColumns_, CurrentBatchRowId_);
+        }
+
+        if (contexts) {
+            contexts->push_back(ReadingContext_);
+        }
     }
 
-    return std::move(row);
+    rows.resize(count);
+    return count;
+}
+
+IColumnBatchPtr TArrowRowReader::ReadBatch(size_t maxRows) {
+    Y_ENSURE(maxRows > 0, "Batch must contain at least one row");
+
+    if (!IsValid()) {
+        return nullptr;
+    }
+
+    // Batch is a slice of the current record batch, so it ends where the record batch
+    // or the current table does, or before a row rejected by the filter
+    const auto tableIndexColumn = CurrentBatch_->GetColumnByName("$table_index");
+    auto rowTableIndex = [&](int rowId) -> size_t {
+        if (!tableIndexColumn) {
+            return 0;
+        }
+        auto data = GetDataFromArray(tableIndexColumn, rowId);
+        return data.HasValue() ? data.AsInt64() : 0;
+    };
+
+    const auto tableIndex = ReadingContext_.TableIndex;
+    const auto begin = CurrentBatchRowId_;
+    auto end = begin + 1;
+    while (end < CurrentBatch_->num_rows() && static_cast<size_t>(end - begin) < maxRows &&
+           rowTableIndex(end) == tableIndex && (Filter_.empty() || Selection_[end])) {
+        ++end;
+    }
+
+    std::vector<int> columnIds;
+    const auto& schema = *CurrentBatch_->schema();
+    for (int i = 0; i < schema.num_fields(); ++i) {
+        if (!IsReadingContextColumnName(schema.field(i)->name())) {
+            columnIds.push_back(i);
+        }
+    }
+
+    auto batch = std::make_shared<TArrowColumnBatch>(
+        tableIndex, CurrentBatch_->Slice(begin, end - begin), std::move(columnIds));
+
+    CurrentBatchRowId_ = end - 1;
+    Next();
+
+    return batch;
 }
 
 bool TArrowRowReader::IsValid() const {
@@ -94,14 +341,109 @@ bool TArrowRowReader::IsEndOfStream() const {
     return !CurrentBatch_;
 }
 
-void TArrowRowReader::Next() {
+bool TArrowRowReader::PushDownFilter(const TRowFilter& filter) {
+    // Columns of record batches are matched with the table schema by position, which is known
+    // only for a single table
+    if (GetTablesCount() != 1) {
+        return false;
+    }
+
+    Filter_ = ResolveFilter(filter, TableSchemas_[0]);
+
+    if (!Filter_.empty() && !IsEndOfStream()) {
+        SelectRows();
+        if (!IsValid() || !IsSelected()) {
+            Next();
+        }
+    }
+
+    return true;
+}
+
+void TArrowRowReader::SelectRows() {
+    const auto rowsCount = CurrentBatch_->num_rows();
+    Selection_.assign(rowsCount, 1);
+
+    for (const auto& predicate : Filter_) {
+        const auto& array = *CurrentColumns_->Columns[predicate.Column];
+        auto* selection = Selection_.data();
+
+        bool selected = false;
+        switch (array.type_id()) {
+        case Type::INT8:
+            selected = SelectFixed<int8_t, int64_t>(predicate, array, selection);
+            break;
+        case Type::INT16:
+            selected = SelectFixed<int16_t, int64_t>(predicate, array, selection);
+            break;
+        case Type::INT32:
+            selected = SelectFixed<int32_t, int64_t>(predicate, array, selection);
+            break;
+        case Type::INT64:
+            selected = SelectFixed<int64_t, int64_t>(predicate, array, selection);
+            break;
+        case Type::UINT8:
+            selected = SelectFixed<uint8_t, uint64_t>(predicate, array, selection);
+            break;
+        case Type::UINT16:
+            selected = SelectFixed<uint16_t, uint64_t>(predicate, array, selection);
+            break;
+        case Type::UINT32:
+            selected = SelectFixed<uint32_t, uint64_t>(predicate, array, selection);
+            break;
+        case Type::UINT64:
+            selected = SelectFixed<uint64_t, uint64_t>(predicate, array, selection);
+            break;
+        case Type::FLOAT:
+            selected = SelectFixed<float, double>(predicate, array, selection);
+            break;
+        case Type::DOUBLE:
+            selected = SelectFixed<double, double>(predicate, array, selection);
+            break;
+        case Type::BOOL:
+            selected = SelectBooleans(predicate, array, selection);
+            break;
+        case Type::STRING:
+        case Type::BINARY:
+            selected = SelectStrings(predicate, array, selection);
+            break;
+        default:
+            break;
+        }
+
+        // Other physical types (e.g. dictionary-encoded strings) are compared value by value
+        if (!selected) {
+            const auto& column = CurrentColumns_->Columns[predicate.Column];
+            for (int64_t i = 0; i < rowsCount; ++i) {
+                if (selection[i]) {
+                    selection[i] = MatchesNode(predicate, GetDataFromArray(column, i));
+                }
+            }
+        }
+    }
+}
+
+void TArrowRowReader::NextRow() {
     ++CurrentBatchRowId_;
 
     if (!IsValid()) {
         auto result = ArrowStream_->ReadNext(&CurrentBatch_);
         Y_ENSURE(result.ok(), "Reading ARROW-batch error: " + result.ToString());
         CurrentBatchRowId_ = 0;
+
+        // Rows read before keep the previous batch alive through their own pointer
+        CurrentColumns_ = CurrentBatch_ ? MakeBatchColumns(CurrentBatch_) : nullptr;
+
+        if (CurrentBatch_ && !Filter_.empty()) {
+            SelectRows();
+        }
     }
+}
+
+void TArrowRowReader::Next() {
+    do {
+        NextRow();
+    } while (!Filter_.empty() && !IsEndOfStream() && (!IsValid() || !IsSelected()));
 
     ReadingContext_ = {};
 
@@ -9,12 +9,51 @@
 #include "arrow_types.h"
 #include "arrow_schema.h"
 #include <dformats/interface/io.h>
+#include <dformats/interface/column_batch.h>
 
 using namespace arrow;
 
 namespace DFormats {
 
-class TArrowRowReader : public IRowReader {
+// Batch viewing columns of a record batch slice in place. Columns of other physical types
+// than requested (e.g. dictionary-encoded or bit-packed booleans) are materialized on first access
+class TArrowColumnBatch : public IColumnBatch {
+public:
+    TArrowColumnBatch(size_t tableIndex, std::shared_ptr<RecordBatch> batch, std::vector<int> columnIds);
+
+    size_t GetTableIndex() const override;
+    size_t RowsCount() const override;
+    size_t ColumnsCount() const override;
+
+protected:
+    TColumnView<bool> GetBoolColumn(size_t column) const override;
+    TColumnView<int8_t> GetInt8Column(size_t column) const override;
+    TColumnView<int16_t> GetInt16Column(size_t column) const override;
+    TColumnView<int32_t> GetInt32Column(size_t column) const override;
+    TColumnView<int64_t> GetInt64Column(size_t column) const override;
+    TColumnView<uint8_t> GetUInt8Column(size_t column) const override;
+    TColumnView<uint16_t> GetUInt16Column(size_t column) const override;
+    TColumnView<uint32_t> GetUInt32Column(size_t column) const override;
+    TColumnView<uint64_t> GetUInt64Column(size_t column) const override;
+    TColumnView<float> GetFloatColumn(size_t column) const override;
+    TColumnView<double> GetDoubleColumn(size_t column) const override;
+    TColumnView<std::string_view> GetStringColumn(size_t column) const override;
+
+private:
+    template <typename T>
+    TColumnView<T> GetFixedColumn(size_t column, std::initializer_list<Type::type> types) const;
+
+    template <typename T>
+    TColumnView<T> Materialize(size_t column) const;
+
+private:
+    size_t TableIndex_;
+    std::shared_ptr<RecordBatch> Batch_;
+    std::vector<int> ColumnIds_;  // Indexes of table columns in the record batch
+    mutable std::vector<TAnyColumnBuilder> Materialized_;
+};
+
+class TArrowRowReader : public IRowReader, public IColumnBatchReader {
 public:
     TArrowRowReader(::TIntrusivePtr<TRawTableReader> input, std::vector<NYT::TTableSchema> schemas);
 
@@ -22,6 +61,18 @@ public:
     TArrowRowReader& operator=(TArrowRowReader&& rhs) = default;
 
     IRowPtr ReadRow() override;
+    size_t ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                    std::vector<TReadingContext>* contexts) override;
+    using IRowReader::ReadRows;
+
+    IColumnBatchPtr ReadBatch(size_t maxRows) override;
+
+    inline IColumnBatchReader* GetColumnBatchReader() override {
+        return this;
+    }
+
+    // Supported for a single input table. Predicates are evaluated column-wise once per record batch
+    bool PushDownFilter(const TRowFilter& filter) override;
 
     bool IsValid() const override;
     bool IsEndOfStream() const override;
@@ -34,13 +85,25 @@ public:
 
     TArrowSchemaPtr GetArrowSchema() const;
 
+private:
+    void NextRow();
+    void SelectRows();
+    inline bool IsSelected() const {
+        return Filter_.empty() || Selection_[CurrentBatchRowId_];
+    }
+
 private:
     ::TIntrusivePtr<TRawTableReader> Underlying_;
     std::shared_ptr<ipc::RecordBatchStreamReader> ArrowStream_;
     std::shared_ptr<RecordBatch> CurrentBatch_;
+    TArrowBatchColumnsPtr CurrentColumns_;
     std::vector<NYT::TTableSchema> TableSchemas_;
+    std::vector<NTi::TTypePtr> RowTypes_;
     TReadingContext ReadingContext_;
     int CurrentBatchRowId_; 
+
+    std::vector<TResolvedPredicate> Filter_;
+    std::vector<uint8_t> Selection_;  // Whether rows of the current batch match Filter_
 };
 
 }
@@ -1,9 +1,45 @@
 #include "arrow_types.h"
 
 #include <library/cpp/yson/node/node_io.h>
+#include <util/system/type_name.h>
+
+using namespace arrow;
 
 namespace DFormats {
 
+namespace {
+
+// Whether values of the physical Arrow type are stored as T. Dates and timestamps are integers of
+// their width, as in TArrowColumnBatch
+template <typename T>
+bool IsArrowTypeOf(Type::type type) {
+    if constexpr (std::is_same_v<T, int8_t>) {
+        return type == Type::INT8;
+    } else if constexpr (std::is_same_v<T, int16_t>) {
+        return type == Type::INT16;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+        return type == Type::INT32 || type == Type::DATE32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return type == Type::INT64 || type == Type::DATE64 || type == Type::TIMESTAMP;
+    } else if constexpr (std::is_same_v<T, uint8_t>) {
+        return type == Type::UINT8;
+    } else if constexpr (std::is_same_v<T, uint16_t>) {
+        return type == Type::UINT16;
+    } else if constexpr (std::is_same_v<T, uint32_t>) {
+        return type == Type::UINT32;
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+        return type == Type::UINT64 || type == Type::TIMESTAMP;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return type == Type::FLOAT;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return type == Type::DOUBLE;
+    } else {
+        static_assert(false, "Unsupported type");
+    }
+}
+
+}
+
 TArrowRow::TArrowRow(NTi::TTypePtr schema) : TYsonStruct(schema) { }
 
 TArrowRow::TArrowRow(NTi::TTypePtr schema, TNode underlying)
@@ -41,6 +77,10 @@ void TArrowRow::SerializeComplexNodes() {
     }
 }
 
+bool TArrowRow::IsNull(size_t ind) const {
+    return !GetData(ind).HasValue();
+}
+
 IStructConstPtr TArrowRow::GetStruct(size_t ind) const {
     TNode dataNode = GetData(ind);
     if (dataNode.IsString()) {
@@ -127,4 +167,243 @@ IOptionalConstPtr TArrowRow::GetOptional(std::string_view ind) const {
     return std::make_shared<TArrowOptional>(GetSchema(ind), std::move(dataNode));
 }
 
+TNode GetDataFromArray(std::shared_ptr<Array> array, int index) {
+    Y_ENSURE(0 <= index && index < array->length(),
+             "Invalid index. It must be in range [0; " + std::to_string(array->length()) + ").");
+
+    if (array->IsNull(index)) {
+        return TNode::CreateEntity();
+    }
+
+    switch (array->type_id()) {
+    case Type::BOOL:
+        return TNode(std::static_pointer_cast<BooleanArray>(array)->Value(index));
+    case Type::INT8:
+        return TNode(std::static_pointer_cast<NumericArray<Int8Type>>(array)->Value(index));
+    case Type::INT16:
+        return TNode(std::static_pointer_cast<NumericArray<Int16Type>>(array)->Value(index));
+    case Type::INT32:
+    case Type::DATE32:
+        return TNode(std::static_pointer_cast<NumericArray<Int32Type>>(array)->Value(index));
+    case Type::INT64:
+    case Type::DATE64:
+    case Type::TIMESTAMP:
+        return TNode(std::static_pointer_cast<NumericArray<Int64Type>>(array)->Value(index));
+    case Type::UINT8:
+        return TNode(static_cast<uint64_t>(std::static_pointer_cast<NumericArray<UInt8Type>>(array)->Value(index)));
+    case Type::UINT16:
+        return TNode(static_cast<uint64_t>(std::static_pointer_cast<NumericArray<UInt16Type>>(array)->Value(index)));
+    case Type::UINT32:
+        return TNode(static_cast<uint64_t>(std::static_pointer_cast<NumericArray<UInt32Type>>(array)->Value(index)));
+    case Type::UINT64:
+        return TNode(std::static_pointer_cast<NumericArray<UInt64Type>>(array)->Value(index));
+    case Type::FLOAT:
+        return TNode(std::static_pointer_cast<NumericArray<FloatType>>(array)->Value(index));
+    case Type::DOUBLE:
+        return TNode(std::static_pointer_cast<NumericArray<DoubleType>>(array)->Value(index));
+    case Type::STRING:
+        return TNode(std::static_pointer_cast<StringArray>(array)->GetString(index));
+    case Type::BINARY:
+        return TNode(std::static_pointer_cast<BinaryArray>(array)->GetString(index));
+    case Type::DICTIONARY: {
+        auto dictArray = std::static_pointer_cast<DictionaryArray>(array);
+        if (dictArray->indices()->IsNull(index)) {
+            return TNode::CreateEntity();
+        }
+        auto arrIndex = dictArray->GetValueIndex(index);
+        return GetDataFromArray(dictArray->dictionary(), arrIndex);
+    }
+    default:
+        ythrow yexception() << "Trying to read unsopported ARROW type " << array->type()->ToString();
+    }
+}
+
+// TArrowBatchRow
+
+TArrowBatchRow::TArrowBatchRow(NTi::TTypePtr schema, TArrowBatchColumnsPtr columns, int rowId)
+  : TYsonStruct(std::move(schema), TNode()), Columns_(std::move(columns)), RowId_(rowId) { }
+
+TArrowBatchRow::TArrowBatchRow(const TArrowBatchRow& rhs)
+  : TYsonStruct(rhs), TArrowRow(rhs), Columns_(rhs.Columns_), RowId_(rhs.RowId_), Materialized_(rhs.Materialized_) { }
+
+IRowPtr TArrowBatchRow::CopyRow() const {
+    return std::make_shared<TArrowBatchRow>(*this);
+}
+
+void TArrowBatchRow::Reset(TArrowBatchColumnsPtr columns, int rowId) {
+    Columns_ = std::move(columns);
+    RowId_ = rowId;
+    Underlying() = TNode();
+    Materialized_ = false;
+}
+
+void TArrowBatchRow::Materialize() {
+    if (Materialized_) {
+        return;
+    }
+
+    const auto& members = GetSchema()->AsStruct()->GetMembers();
+    auto& node = Underlying();
+
+    for (size_t i = 0; i < members.size(); ++i) {
+        node[members[i].GetName()] = GetDataFromArray(Columns_->Columns[i], RowId_);
+    }
+
+    Materialized_ = true;
+}
+
+void TArrowBatchRow::SerializeComplexNodes() {
+    // Until materialization complex values are YSON strings read from the batch
+    if (Materialized_) {
+        TArrowRow::SerializeComplexNodes();
+    }
+}
+
+bool TArrowBatchRow::IsNull(size_t ind) const {
+    return Materialized_ ? TArrowRow::IsNull(ind) : Columns_->Columns[ind]->IsNull(RowId_);
+}
+
+const TNode& TArrowBatchRow::GetData(std::string_view ind) const {
+    // Values are converted on demand and cached in the underlying node, which is logically const
+    auto& node = const_cast<TNode&>(Underlying());
+    if (!Materialized_ && !(node.IsMap() && node.HasKey(ind))) {
+        node[ind] = GetDataFromArray(Columns_->Columns[ColumnIndex(ind)], RowId_);
+    }
+
+    return TArrowRow::GetData(ind);
+}
+
+TNode& TArrowBatchRow::GetData(std::string_view ind) {
+    Materialize();
+    return TArrowRow::GetData(ind);
+}
+
+const TNode& TArrowBatchRow::GetData(size_t ind) const {
+    // Values are converted on demand, so columns can't be resolved by position before materialization
+    if (!Materialized_) {
+        return GetData(GetSchema()->AsStruct()->GetMembers()[ind].GetName());
+    }
+    return TArrowRow::GetData(ind);
+}
+
+TNode& TArrowBatchRow::GetData(size_t ind) {
+    Materialize();
+    return TArrowRow::GetData(ind);
+}
+
+size_t TArrowBatchRow::FieldsCount() const {
+    return Columns_->Columns.size();
+}
+
+size_t TArrowBatchRow::ColumnIndex(std::string_view name) const {
+    return GetSchema()->AsStruct()->GetMemberIndex(name);
+}
+
+template <typename T>
+T TArrowBatchRow::GetArrowValue(size_t ind) const {
+    const Array* array = Columns_->Columns[ind].get();
+    int64_t rowId = RowId_;
+
+    Y_ENSURE(!array->IsNull(rowId), "Trying to get value of null field");
+
+    if (array->type_id() == Type::DICTIONARY) {
+        const auto& dictArray = static_cast<const DictionaryArray&>(*array);
+        rowId = dictArray.GetValueIndex(rowId);
+        array = dictArray.dictionary().get();
+    }
+
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        Y_ENSURE(array->type_id() == Type::STRING || array->type_id() == Type::BINARY,
+                 "Trying to read ARROW type " << array->type()->ToString() << " as string");
+
+        int32_t length;
+        const auto* data = static_cast<const BinaryArray*>(array)->GetValue(rowId, &length);
+        return {reinterpret_cast<const char*>(data), static_cast<size_t>(length)};
+    } else if constexpr (std::is_same_v<T, bool>) {
+        Y_ENSURE(array->type_id() == Type::BOOL,
+                 "Trying to read ARROW type " << array->type()->ToString() << " as bool");
+
+        return static_cast<const BooleanArray*>(array)->Value(rowId);
+    } else {
+        // Values are read only as their own type: narrowing them silently would hide schema mismatches
+        Y_ENSURE(IsArrowTypeOf<T>(array->type_id()),
+                 "Trying to read ARROW type " << array->type()->ToString() << " as " << TypeName<T>());
+
+        return array->data()->template GetValues<T>(1)[rowId];
+    }
+}
+
+bool TArrowBatchRow::GetBool(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetBool(ind) : GetArrowValue<bool>(ind);
+}
+int8_t TArrowBatchRow::GetInt8(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetInt8(ind) : GetArrowValue<int8_t>(ind);
+}
+int16_t TArrowBatchRow::GetInt16(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetInt16(ind) : GetArrowValue<int16_t>(ind);
+}
+int32_t TArrowBatchRow::GetInt32(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetInt32(ind) : GetArrowValue<int32_t>(ind);
+}
+int64_t TArrowBatchRow::GetInt64(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetInt64(ind) : GetArrowValue<int64_t>(ind);
+}
+uint8_t TArrowBatchRow::GetUInt8(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetUInt8(ind) : GetArrowValue<uint8_t>(ind);
+}
+uint16_t TArrowBatchRow::GetUInt16(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetUInt16(ind) : GetArrowValue<uint16_t>(ind);
+}
+uint32_t TArrowBatchRow::GetUInt32(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetUInt32(ind) : GetArrowValue<uint32_t>(ind);
+}
+uint64_t TArrowBatchRow::GetUInt64(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetUInt64(ind) : GetArrowValue<uint64_t>(ind);
+}
+float TArrowBatchRow::GetFloat(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetFloat(ind) : GetArrowValue<float>(ind);
+}
+double TArrowBatchRow::GetDouble(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetDouble(ind) : GetArrowValue<double>(ind);
+}
+std::string_view TArrowBatchRow::GetString(size_t ind) const {
+    return Materialized_ ? IYsonIndexed<size_t>::GetString(ind) : GetArrowValue<std::string_view>(ind);
+}
+bool TArrowBatchRow::GetBool(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetBool(ind) : GetArrowValue<bool>(ColumnIndex(ind));
+}
+int8_t TArrowBatchRow::GetInt8(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetInt8(ind) : GetArrowValue<int8_t>(ColumnIndex(ind));
+}
+int16_t TArrowBatchRow::GetInt16(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetInt16(ind) : GetArrowValue<int16_t>(ColumnIndex(ind));
+}
+int32_t TArrowBatchRow::GetInt32(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetInt32(ind) : GetArrowValue<int32_t>(ColumnIndex(ind));
+}
+int64_t TArrowBatchRow::GetInt64(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetInt64(ind) : GetArrowValue<int64_t>(ColumnIndex(ind));
+}
+uint8_t TArrowBatchRow::GetUInt8(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetUInt8(ind) : GetArrowValue<uint8_t>(ColumnIndex(ind));
+}
+uint16_t TArrowBatchRow::GetUInt16(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetUInt16(ind) : GetArrowValue<uint16_t>(ColumnIndex(ind));
+}
+uint32_t TArrowBatchRow::GetUInt32(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetUInt32(ind) : GetArrowValue<uint32_t>(ColumnIndex(ind));
+}
+uint64_t TArrowBatchRow::GetUInt64(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetUInt64(ind) : GetArrowValue<uint64_t>(ColumnIndex(ind));
+}
+float TArrowBatchRow::GetFloat(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetFloat(ind) : GetArrowValue<float>(ColumnIndex(ind));
+}
+double TArrowBatchRow::GetDouble(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetDouble(ind) : GetArrowValue<double>(ColumnIndex(ind));
+}
+std::string_view TArrowBatchRow::GetString(std::string_view ind) const {
+    return Materialized_ ? IYsonIndexed<std::string_view>::GetString(ind) : GetArrowValue<std::string_view>(ColumnIndex(ind));
+}
+
 }
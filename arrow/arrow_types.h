@@ -32,7 +32,10 @@ public:
 
     IRowPtr CopyRow() const override;
 
-    void SerializeComplexNodes();
+    // Replaces complex values with their YSON serialization
+    virtual void SerializeComplexNodes();
+
+    virtual bool IsNull(size_t ind) const;
 
     inline size_t Size() const {
         return Underlying().Size();
@@ -58,4 +61,82 @@ protected:
     IOptionalConstPtr GetOptional(std::string_view ind) const override;
 };
 
+TNode GetDataFromArray(std::shared_ptr<arrow::Array> array, int index);
+
+// Data columns of a record batch in the order of table schema columns
+struct TArrowBatchColumns {
+    std::shared_ptr<arrow::RecordBatch> Batch;
+    std::vector<std::shared_ptr<arrow::Array>> Columns;
+};
+
+using TArrowBatchColumnsPtr = std::shared_ptr<const TArrowBatchColumns>;
+
+// Handle to a row of a record batch. Scalar values are read from Arrow arrays directly,
+// complex ones are converted to TNode on access. Whole row is converted to TNode
+// on first modification, and TArrowRow methods work on it from then on
+class TArrowBatchRow : public TArrowRow {
+public:
+    TArrowBatchRow(NTi::TTypePtr schema, TArrowBatchColumnsPtr columns, int rowId);
+    TArrowBatchRow(const TArrowBatchRow& rhs);
+
+    IRowPtr CopyRow() const override;
+
+    // Points the handle to another row dropping all modifications
+    void Reset(TArrowBatchColumnsPtr columns, int rowId);
+
+    // Converts all values to TNode, so Underlying() holds the whole row
+    void Materialize();
+
+    void SerializeComplexNodes() override;
+
+    bool IsNull(size_t ind) const override;
+
+protected:
+    using TArrowRow::GetData;
+
+    const TNode& GetData(std::string_view ind) const override;
+    TNode& GetData(std::string_view ind) override;
+    const TNode& GetData(size_t ind) const override;
+    TNode& GetData(size_t ind) override;
+
+    size_t FieldsCount() const override;
+
+    bool GetBool(size_t ind) const override;
+    int8_t GetInt8(size_t ind) const override;
+    int16_t GetInt16(size_t ind) const override;
+    int32_t GetInt32(size_t ind) const override;
+    int64_t GetInt64(size_t ind) const override;
+    uint8_t GetUInt8(size_t ind) const override;
+    uint16_t GetUInt16(size_t ind) const override;
+    uint32_t GetUInt32(size_t ind) const override;
+    uint64_t GetUInt64(size_t ind) const override;
+    float GetFloat(size_t ind) const override;
+    double GetDouble(size_t ind) const override;
+    std::string_view GetString(size_t ind) const override;
+
+    bool GetBool(std::string_view ind) const override;
+    int8_t GetInt8(std::string_view ind) const override;
+    int16_t GetInt16(std::string_view ind) const override;
+    int32_t GetInt32(std::string_view ind) const override;
+    int64_t GetInt64(std::string_view ind) const override;
+    uint8_t GetUInt8(std::string_view ind) const override;
+    uint16_t GetUInt16(std::string_view ind) const override;
+    uint32_t GetUInt32(std::string_view ind) const override;
+    uint64_t GetUInt64(std::string_view ind) const override;
+    float GetFloat(std::string_view ind) const override;
+    double GetDouble(std::string_view ind) const override;
+    std::string_view GetString(std::string_view ind) const override;
+
+private:
+    template <typename T>
+    T GetArrowValue(size_t ind) const;
+
+    size_t ColumnIndex(std::string_view name) const;
+
+private:
+    TArrowBatchColumnsPtr Columns_;
+    int RowId_;
+    bool Materialized_ = false;
+};
+
 }
@@ -1,83 +1,38 @@
 #include "arrow_writer.h"
 
-using namespace DFormats;
+#include <algorithm>
 
-std::shared_ptr<Scalar> MakeScalar(const TArrowRow& row, TArrowSchemaPtr arrowSchema, int fieldInd) {
-    Y_ENSURE(fieldInd < arrowSchema->num_fields(), "Invalid field index");
+using namespace DFormats;
 
-    if (!row.Underlying()[arrowSchema->field(fieldInd)->name()].HasValue()) {
-        return nullptr;
-    }
+// Creates the builder of a column together with the function appending the column's value from a row
+template <typename TBuilder, typename TValue = typename TBuilder::value_type>
+void AddColumn(std::vector<std::shared_ptr<ArrayBuilder>>& builders,
+               std::vector<TArrowRowWriter::TColumnAppender>& appenders) {
+    auto builder = std::make_shared<TBuilder>();
 
-    std::shared_ptr<DataType> fieldType = arrowSchema->field(fieldInd)->type();
-    Result<std::shared_ptr<Scalar>> result;
-
-    switch (fieldType->id()) {
-    case Type::INT8:
-        result = MakeScalar(row.GetValue<int8_t>(fieldInd));
-        break;
-    case Type::INT16:
-        result = MakeScalar(row.GetValue<int16_t>(fieldInd));
-        break;
-    case Type::INT32:
-        result = MakeScalar(row.GetValue<int32_t>(fieldInd));
-        break;
-    case Type::INT64:
-        result = MakeScalar(row.GetValue<int64_t>(fieldInd));
-        break;
-    case Type::UINT8:
-        result = MakeScalar(row.GetValue<uint8_t>(fieldInd));
-        break;
-    case Type::UINT16:
-        result = MakeScalar(row.GetValue<uint16_t>(fieldInd));
-        break;
-    case Type::UINT32:
-        result = MakeScalar(row.GetValue<uint32_t>(fieldInd));
-        break;
-    case Type::UINT64:
-        result = MakeScalar(row.GetValue<uint64_t>(fieldInd));
-        break;
-    case Type::BOOL:
-        result = MakeScalar(row.GetValue<bool>(fieldInd));
-        break;
-    case Type::FLOAT:
-        result = MakeScalar(row.GetValue<float>(fieldInd));
-        break;
-    case Type::DOUBLE:
-        result = MakeScalar(row.GetValue<double>(fieldInd));
-        break;
-    case Type::BINARY:
-    // {
-    //     auto scalar = std::make_shared<BinaryScalar>(
-    //         std::make_shared<Buffer>(util::string_view(row.GetValue<std::string>(fieldInd))));
-    //     result = Result<std::shared_ptr<Scalar>>(scalar);
-    //     break;
-    // } 
-    case Type::STRING:
-        result = MakeScalar(std::string(row.GetValue<std::string_view>(fieldInd)));
-        break;
-    case Type::DATE32:
-        result = MakeScalar(row.GetValue<int32_t>(fieldInd));
-        break;
-    case Type::DATE64:
-        result = MakeScalar(row.GetValue<int64_t>(fieldInd));
-        break;
-    case Type::TIMESTAMP:
-        result = MakeScalar<uint64_t>(row.GetValue<int64_t>(fieldInd));
-        break;
-    default:
-        ythrow yexception() << "Unsupported type: " << fieldType->ToString();
-    }
+    appenders.push_back([builder = builder.get(), column = builders.size()](const TArrowRow& row) -> Status {
+        if (row.IsNull(column)) {
+            return builder->AppendNull();
+        }
 
-    Y_ENSURE(result.ok(), "Error while making scalar from row data: " << result.status().ToString());
+        if constexpr (std::is_same_v<TValue, std::string_view>) {
+            auto value = row.GetValue<std::string_view>(column);
+            return builder->Append(reinterpret_cast<const uint8_t*>(value.data()), static_cast<int32_t>(value.size()));
+        } else {
+            return builder->Append(static_cast<typename TBuilder::value_type>(row.GetValue<TValue>(column)));
+        }
+    });
 
-    return *result;
+    builders.push_back(std::move(builder));
 }
 
 // TArrowRowWriter
 
 TArrowRowWriter::TArrowRowWriter(THolder<IProxyOutput> output, std::vector<NYT::TTableSchema> schemas,
-    std::vector<size_t> batchSizes) : Underlying_(std::move(output)), TableSchemas_(std::move(schemas)) {
+    std::vector<size_t> batchSizes)
+  : Underlying_(std::move(output))
+  , TableSchemas_(std::move(schemas))
+  , RowPools_(TableSchemas_.size()) {
     
     BatchSizes_ = !batchSizes.empty() ? std::move(batchSizes) : 
         std::vector<size_t>(TableSchemas_.size(), TArrowRowWriter::kDefaultBatchSize);
@@ -95,6 +50,12 @@ TArrowRowWriter::TArrowRowWriter(THolder<IProxyOutput> output, std::vector<NYT::
                               << i << "]: " << result.status().ToString());
                 
         ArrowStreams_.emplace_back(*result);
+
+        RowTypes_.push_back(TableSchemaToStructType(TableSchemas_[i]));
+        HasComplexColumns_.push_back(std::any_of(
+            TableSchemas_[i].Columns().begin(), TableSchemas_[i].Columns().end(),
+            [](const auto& column) { return column.Type() == EValueType::VT_ANY; }));
+        RowTemplates_.push_back(ConstructNode(RowTypes_.back()));
     }
 
     InitArrayBuilders();
@@ -102,59 +63,61 @@ TArrowRowWriter::TArrowRowWriter(THolder<IProxyOutput> output, std::vector<NYT::
 
 void TArrowRowWriter::InitArrayBuilders() {
     ArrayBuilders_.clear();
+    ColumnAppenders_.clear();
 
     for (const auto& schema : ArrowSchemas_) {
-        ArrayBuilders_.emplace_back();
+        auto& builders = ArrayBuilders_.emplace_back();
+        auto& appenders = ColumnAppenders_.emplace_back();
 
         for (const auto& field : schema->fields()) {
             switch (field->type()->id()) {
             case Type::INT8:
-                ArrayBuilders_.back().push_back(std::make_shared<Int8Builder>());
+                AddColumn<Int8Builder>(builders, appenders);
                 break;
             case Type::INT16:
-                ArrayBuilders_.back().push_back(std::make_shared<Int16Builder>());
+                AddColumn<Int16Builder>(builders, appenders);
                 break;
             case Type::INT32:
-                ArrayBuilders_.back().push_back(std::make_shared<Int32Builder>());
+                AddColumn<Int32Builder>(builders, appenders);
                 break;
             case Type::INT64:
-                ArrayBuilders_.back().push_back(std::make_shared<Int64Builder>());
+                AddColumn<Int64Builder>(builders, appenders);
                 break;
             case Type::UINT8:
-                ArrayBuilders_.back().push_back(std::make_shared<UInt8Builder>());
+                AddColumn<UInt8Builder>(builders, appenders);
                 break;
             case Type::UINT16:
-                ArrayBuilders_.back().push_back(std::make_shared<UInt16Builder>());
+                AddColumn<UInt16Builder>(builders, appenders);
                 break;
             case Type::UINT32:
-                ArrayBuilders_.back().push_back(std::make_shared<UInt32Builder>());
+                AddColumn<UInt32Builder>(builders, appenders);
                 break;
             case Type::UINT64:
-                ArrayBuilders_.back().push_back(std::make_shared<UInt64Builder>());
+                AddColumn<UInt64Builder>(builders, appenders);
                 break;
             case Type::BOOL:
-                ArrayBuilders_.back().push_back(std::make_shared<BooleanBuilder>());
+                AddColumn<BooleanBuilder>(builders, appenders);
                 break;
             case Type::FLOAT:
-                ArrayBuilders_.back().push_back(std::make_shared<FloatBuilder>());
+                AddColumn<FloatBuilder>(builders, appenders);
                 break;
             case Type::DOUBLE:
-                ArrayBuilders_.back().push_back(std::make_shared<DoubleBuilder>());
+                AddColumn<DoubleBuilder>(builders, appenders);
                 break;
             case Type::BINARY:
-                // ArrayBuilders_.back().push_back(std::make_shared<BinaryBuilder>());
+                // AddColumn<BinaryBuilder, std::string_view>(builders, appenders);
                 // break;
             case Type::STRING:
-                ArrayBuilders_.back().push_back(std::make_shared<StringBuilder>());
+                AddColumn<StringBuilder, std::string_view>(builders, appenders);
                 break;
             case Type::DATE32:
-                ArrayBuilders_.back().push_back(std::make_shared<Int32Builder>());
+                AddColumn<Int32Builder>(builders, appenders);
                 break;
             case Type::DATE64:
-                ArrayBuilders_.back().push_back(std::make_shared<Int64Builder>());
+                AddColumn<Int64Builder>(builders, appenders);
                 break;
             case Type::TIMESTAMP:
-                ArrayBuilders_.back().push_back(std::make_shared<UInt64Builder>());
+                AddColumn<UInt64Builder, int64_t>(builders, appenders);
                 break;
             default:
                 ythrow yexception() << "Unsupported type: " << field->type()->ToString();
@@ -164,21 +127,30 @@ void TArrowRowWriter::InitArrayBuilders() {
 }
 
 void TArrowRowWriter::WriteRow(const IRowConstPtr& row, size_t tableIndex) {
-    WriteRow(row->CopyRow(), tableIndex);
+    if (HasComplexColumns_[tableIndex]) {
+        // Complex values are serialized in place, so the row is copied
+        WriteRow(row->CopyRow(), tableIndex);
+        return;
+    }
+
+    AppendRow(dynamic_cast<const TArrowRow&>(*row), tableIndex);
 }
 
 void TArrowRowWriter::WriteRow(IRowPtr&& row, size_t tableIndex) {
-    Y_ENSURE(tableIndex < ArrowStreams_.size(), "Invalid table index");
+    auto& arrowRow = dynamic_cast<TArrowRow&>(*row);
+    if (HasComplexColumns_[tableIndex]) {
+        arrowRow.SerializeComplexNodes();
+    }
 
-    auto arrowRow = std::dynamic_pointer_cast<TArrowRow>(row);
-    arrowRow->SerializeComplexNodes();
+    AppendRow(arrowRow, tableIndex);
+    RecycleRow(std::move(row), tableIndex);
+}
 
-    for (int colId = 0; colId < ArrowSchemas_[tableIndex]->num_fields(); ++colId) {
-        auto scalar = MakeScalar(*arrowRow, ArrowSchemas_[tableIndex], colId);
-        auto status = scalar 
-            ? ArrayBuilders_[tableIndex][colId]->AppendScalar(*scalar)
-            : ArrayBuilders_[tableIndex][colId]->AppendNull();
-                    
+void TArrowRowWriter::AppendRow(const TArrowRow& row, size_t tableIndex) {
+    Y_ENSURE(tableIndex < ArrowStreams_.size(), "Invalid table index");
+
+    for (const auto& appender : ColumnAppenders_[tableIndex]) {
+        auto status = appender(row);
         Y_ENSURE(status.ok(), "Builder append error: " << status.ToString());
     }
 
@@ -187,6 +159,25 @@ void TArrowRowWriter::WriteRow(IRowPtr&& row, size_t tableIndex) {
     }
 }
 
+void TArrowRowWriter::RecycleRow(IRowPtr&& row, size_t tableIndex) {
+    if (row.use_count() != 1) {
+        return;
+    }
+
+    auto& arrowRow = dynamic_cast<TArrowRow&>(*row);
+    if (arrowRow.GetSchema().Get() != RowTypes_[tableIndex].Get()) {
+        return;
+    }
+
+    // Values may have been modified or replaced by SerializeComplexNodes(), so every column is reset
+    auto& node = arrowRow.Underlying();
+    for (const auto& [name, value] : RowTemplates_[tableIndex].AsMap()) {
+        node[name] = value;
+    }
+
+    RowPools_[tableIndex].Release(std::move(row));
+}
+
 void TArrowRowWriter::FinishTable(size_t tableIndex) {
     Y_ENSURE(tableIndex < ArrowStreams_.size(), "Invalid table index");
 
@@ -209,7 +200,11 @@ const NYT::TTableSchema& TArrowRowWriter::GetTableSchema(size_t tableIndex) cons
 }
 
 IRowPtr TArrowRowWriter::CreateObjectForWrite(size_t tableIndex) const {
-    return std::make_shared<TArrowRow>(GetTableSchema(tableIndex));
+    if (auto row = RowPools_[tableIndex].Acquire()) {
+        return row;
+    }
+
+    return std::make_shared<TArrowRow>(RowTypes_[tableIndex]);
 }
 
 TArrowSchemaPtr TArrowRowWriter::GetArrowSchema(size_t tableIndex) const {
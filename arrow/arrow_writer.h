@@ -6,10 +6,13 @@
 #include <arrow/io/api.h>
 #include <arrow/ipc/api.h>
 
+#include <functional>
+
 #include "arrow_adapter.h"
 #include "arrow_types.h"
 #include "arrow_schema.h"
 #include <dformats/interface/io.h>
+#include <dformats/common/row_pool.h>
 
 using namespace arrow;
 
@@ -19,6 +22,9 @@ class TArrowRowWriter : public IRowWriter {
 public:
     size_t kDefaultBatchSize = 1000;
 
+    // Appends value of a certain column of the row to the column's builder
+    using TColumnAppender = std::function<Status(const TArrowRow&)>;
+
 public:
     TArrowRowWriter(THolder<IProxyOutput> output, 
         std::vector<NYT::TTableSchema> schemas, std::vector<size_t> batchSizes = {});
@@ -39,7 +45,9 @@ public:
 
 protected:
     void InitArrayBuilders();
+    void AppendRow(const TArrowRow& row, size_t tableIndex);
     void WriteBatch(size_t tableIndex);
+    void RecycleRow(IRowPtr&& row, size_t tableIndex);
 
 protected:
     THolder<IProxyOutput> Underlying_;
@@ -48,6 +56,13 @@ protected:
     std::vector<NYT::TTableSchema> TableSchemas_;
     std::vector<TArrowSchemaPtr> ArrowSchemas_;
     std::vector<std::vector<std::shared_ptr<ArrayBuilder>>> ArrayBuilders_;
+    std::vector<std::vector<TColumnAppender>> ColumnAppenders_;
+    std::vector<NTi::TTypePtr> RowTypes_;
+    std::vector<bool> HasComplexColumns_;  // Such columns are written as YSON strings
+
+    // Nodes with default values used for resetting rows returned to the pools
+    std::vector<TNode> RowTemplates_;
+    mutable std::vector<TRowPool> RowPools_;
 };
 
 }
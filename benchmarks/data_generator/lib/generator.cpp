@@ -0,0 +1,736 @@
+#include "generator.h"
+
+#include <dformats/arrow/arrow_adapter.h>
+#include <dformats/arrow/arrow_schema.h>
+
+#include <library/cpp/yson/writer.h>
+
+#include <util/generic/yexception.h>
+#include <util/stream/buffered.h>
+#include <util/stream/str.h>
+
+namespace DFormats {
+
+namespace {
+
+constexpr size_t kFlushSize = 1 << 20;
+
+// Type of a value with tags stripped, laid out for traversing it for every generated row
+struct TValuePlan {
+    NTi::ETypeName Type;
+    std::vector<TValuePlan> Children;  // Item of optional or list, key and value of dict, elements of struct or tuple
+    std::vector<TString> Names;  // Names of struct members
+};
+
+TValuePlan MakeValuePlan(NTi::TTypePtr type) {
+    type = type->StripTags();
+    TValuePlan res{type->GetTypeName(), {}, {}};
+
+    switch (res.Type) {
+    case NTi::ETypeName::Bool:
+    case NTi::ETypeName::Int8:
+    case NTi::ETypeName::Int16:
+    case NTi::ETypeName::Int32:
+    case NTi::ETypeName::Int64:
+    case NTi::ETypeName::Uint8:
+    case NTi::ETypeName::Uint16:
+    case NTi::ETypeName::Uint32:
+    case NTi::ETypeName::Uint64:
+    case NTi::ETypeName::Float:
+    case NTi::ETypeName::Double:
+    case NTi::ETypeName::String:
+    case NTi::ETypeName::Utf8:
+        break;
+    case NTi::ETypeName::Optional:
+        res.Children.push_back(MakeValuePlan(type->AsOptional()->GetItemType()));
+        break;
+    case NTi::ETypeName::List:
+        res.Children.push_back(MakeValuePlan(type->AsList()->GetItemType()));
+        break;
+    case NTi::ETypeName::Dict:
+        res.Children.push_back(MakeValuePlan(type->AsDict()->GetKeyType()));
+        res.Children.push_back(MakeValuePlan(type->AsDict()->GetValueType()));
+        break;
+    case NTi::ETypeName::Struct:
+        for (const auto& member : type->AsStruct()->GetMembers()) {
+            res.Children.push_back(MakeValuePlan(member.GetType()));
+            res.Names.emplace_back(member.GetName());
+        }
+        break;
+    case NTi::ETypeName::Tuple:
+        for (const auto& element : type->AsTuple()->GetElements()) {
+            res.Children.push_back(MakeValuePlan(element.GetType()));
+        }
+        break;
+    default:
+        ythrow yexception() << "Type " << type->GetTypeName() << " isn't supported by the generator";
+    }
+
+    return res;
+}
+
+// Source of values following column's distribution. Based on splitmix64, which is cheap
+// and bijective, so values of limited cardinality are distinct
+class TValueSampler {
+public:
+    TValueSampler(const TColumnDistribution& distribution, ui64 seed)
+      : Distribution_(distribution), State_(seed), Salt_(Mix(seed)) { }
+
+    bool NextIsNull() {
+        return Distribution_.NullRatio > 0 &&
+            static_cast<double>(Next() >> 11) * 0x1.0p-53 < Distribution_.NullRatio;
+    }
+
+    size_t NextSize() {
+        return Distribution_.MinListSize + Next() % (Distribution_.MaxListSize - Distribution_.MinListSize + 1);
+    }
+
+    // Bits of the next scalar. Values with the same bits are equal
+    ui64 NextBits() {
+        const auto bits = Next();
+        return Distribution_.Cardinality ? Mix(bits % Distribution_.Cardinality + Salt_) : bits;
+    }
+
+    double NextDouble() {
+        return static_cast<double>(NextBits() >> 11) * 0x1.0p-53 * 2e9 - 1e9;
+    }
+
+    // Returned view is valid until the next call
+    std::string_view NextString() {
+        static constexpr std::string_view letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+        auto bits = NextBits();
+        String_.resize(Distribution_.MinStringLength +
+            bits % (Distribution_.MaxStringLength - Distribution_.MinStringLength + 1));
+
+        for (size_t i = 0; i < String_.size(); ++i) {
+            if (i % 8 == 0) {
+                bits = Mix(bits);
+            }
+            String_[i] = letters[(bits >> (i % 8 * 8) & 0xFF) % letters.size()];
+        }
+
+        return String_;
+    }
+
+private:
+    static ui64 Mix(ui64 x) {
+        x += 0x9e3779b97f4a7c15;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    }
+
+    ui64 Next() {
+        return Mix(State_++);
+    }
+
+private:
+    TColumnDistribution Distribution_;
+    ui64 State_;
+    ui64 Salt_;
+    std::string String_;
+};
+
+struct TColumnGenerator {
+    TString Name;
+    bool IsComplex;  // Column is written as YSON string by Arrow
+    TValuePlan Plan;
+    TValueSampler Sampler;
+};
+
+// Walks the value's type passing generated values to the encoder. Every encoder gets the same
+// sequence of calls for the same sampler state, so rows are the same for every format
+template <typename TEncoder>
+void GenerateValue(TEncoder& encoder, const TValuePlan& plan, TValueSampler& sampler) {
+    switch (plan.Type) {
+    case NTi::ETypeName::Bool:
+        return encoder.Value(static_cast<bool>(sampler.NextBits() & 1));
+    case NTi::ETypeName::Int8:
+        return encoder.Value(static_cast<int8_t>(sampler.NextBits()));
+    case NTi::ETypeName::Int16:
+        return encoder.Value(static_cast<int16_t>(sampler.NextBits()));
+    case NTi::ETypeName::Int32:
+        return encoder.Value(static_cast<int32_t>(sampler.NextBits()));
+    case NTi::ETypeName::Int64:
+        return encoder.Value(static_cast<int64_t>(sampler.NextBits()));
+    case NTi::ETypeName::Uint8:
+        return encoder.Value(static_cast<uint8_t>(sampler.NextBits()));
+    case NTi::ETypeName::Uint16:
+        return encoder.Value(static_cast<uint16_t>(sampler.NextBits()));
+    case NTi::ETypeName::Uint32:
+        return encoder.Value(static_cast<uint32_t>(sampler.NextBits()));
+    case NTi::ETypeName::Uint64:
+        return encoder.Value(static_cast<uint64_t>(sampler.NextBits()));
+    case NTi::ETypeName::Float:
+        return encoder.Value(static_cast<float>(sampler.NextDouble()));
+    case NTi::ETypeName::Double:
+        return encoder.Value(sampler.NextDouble());
+    case NTi::ETypeName::String:
+    case NTi::ETypeName::Utf8:
+        return encoder.Value(sampler.NextString());
+
+    case NTi::ETypeName::Optional:
+        if (sampler.NextIsNull()) {
+            return encoder.Null();
+        }
+        encoder.BeginOptional();
+        GenerateValue(encoder, plan.Children[0], sampler);
+        return encoder.EndOptional();
+
+    case NTi::ETypeName::List:
+        encoder.BeginList();
+        for (size_t i = 0, size = sampler.NextSize(); i < size; ++i) {
+            encoder.Item();
+            GenerateValue(encoder, plan.Children[0], sampler);
+        }
+        return encoder.EndList();
+
+    case NTi::ETypeName::Dict:
+        // Dict is a list of (key, value) tuples for every format
+        encoder.BeginList();
+        for (size_t i = 0, size = sampler.NextSize(); i < size; ++i) {
+            encoder.Item();
+            encoder.BeginTuple();
+            for (size_t j = 0; j < 2; ++j) {
+                encoder.Member(j, {});
+                GenerateValue(encoder, plan.Children[j], sampler);
+            }
+            encoder.EndTuple();
+        }
+        return encoder.EndList();
+
+    case NTi::ETypeName::Struct:
+        encoder.BeginStruct();
+        for (size_t i = 0; i < plan.Children.size(); ++i) {
+            encoder.Member(i, plan.Names[i]);
+            GenerateValue(encoder, plan.Children[i], sampler);
+        }
+        return encoder.EndStruct();
+
+    case NTi::ETypeName::Tuple:
+        encoder.BeginTuple();
+        for (size_t i = 0; i < plan.Children.size(); ++i) {
+            encoder.Member(i, {});
+            GenerateValue(encoder, plan.Children[i], sampler);
+        }
+        return encoder.EndTuple();
+
+    default:
+        ythrow yexception() << "Type " << plan.Type << " isn't supported by the generator";
+    }
+}
+
+// Encoders
+
+class TSkiffEncoder {
+public:
+    explicit TSkiffEncoder(std::string& buffer) : Buffer_(buffer) { }
+
+    void BeginRow() {
+        Put<ui16>(0);  // Table index
+        Put<ui8>(0);  // Row index is missing
+    }
+
+    template <typename T>
+    void Value(T value) {
+        Put(value);
+    }
+    void Value(bool value) {
+        Put<ui8>(value);
+    }
+    void Value(float value) {
+        Put<double>(value);
+    }
+    void Value(std::string_view value) {
+        Put<ui32>(value.size());
+        Buffer_.append(value);
+    }
+
+    void Null() {
+        Put<ui8>(0);
+    }
+    void BeginOptional() {
+        Put<ui8>(1);
+    }
+    void EndOptional() { }
+
+    void BeginList() { }
+    void Item() {
+        Put<ui8>(0);
+    }
+    void EndList() {
+        Put<ui8>(0xFF);
+    }
+
+    void BeginStruct() { }
+    void BeginTuple() { }
+    void Member(size_t, TStringBuf) { }
+    void EndStruct() { }
+    void EndTuple() { }
+
+private:
+    template <typename T>
+    void Put(T value) {
+        Buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+private:
+    std::string& Buffer_;
+};
+
+class TYsonEncoder {
+public:
+    explicit TYsonEncoder(::NYson::TYsonWriter& writer) : Writer_(writer) { }
+
+    template <typename T>
+    void Value(T value) {
+        if constexpr (std::is_signed_v<T>) {
+            Writer_.OnInt64Scalar(value);
+        } else {
+            Writer_.OnUint64Scalar(value);
+        }
+    }
+    void Value(bool value) {
+        Writer_.OnBooleanScalar(value);
+    }
+    void Value(float value) {
+        Writer_.OnDoubleScalar(value);
+    }
+    void Value(double value) {
+        Writer_.OnDoubleScalar(value);
+    }
+    void Value(std::string_view value) {
+        Writer_.OnStringScalar(TStringBuf(value.data(), value.size()));
+    }
+
+    void Null() {
+        Writer_.OnEntity();
+    }
+    void BeginOptional() { }
+    void EndOptional() { }
+
+    void BeginList() {
+        Writer_.OnBeginList();
+    }
+    void Item() {
+        Writer_.OnListItem();
+    }
+    void EndList() {
+        Writer_.OnEndList();
+    }
+
+    void BeginStruct() {
+        Writer_.OnBeginMap();
+        InMap_.push_back(true);
+    }
+    void BeginTuple() {
+        Writer_.OnBeginList();
+        InMap_.push_back(false);
+    }
+    void Member(size_t, TStringBuf name) {
+        if (InMap_.back()) {
+            Writer_.OnKeyedItem(name);
+        } else {
+            Writer_.OnListItem();
+        }
+    }
+    void EndStruct() {
+        Writer_.OnEndMap();
+        InMap_.pop_back();
+    }
+    void EndTuple() {
+        Writer_.OnEndList();
+        InMap_.pop_back();
+    }
+
+private:
+    ::NYson::TYsonWriter& Writer_;
+    std::vector<bool> InMap_;
+};
+
+// Encodes rows as protobuf messages built by MakeDescriptorPool: fields are numbered by position
+// starting from 1, structs and dict entries are nested messages, lists are repeated fields
+class TProtobufEncoder {
+public:
+    void BeginRow() {
+        Depth_ = 0;
+        Enter();
+    }
+    const std::string& Message() const {
+        return Frames_.front().Data;
+    }
+
+    template <typename T>
+    void Value(T value) {
+        PutTag(0);
+        PutVarint(static_cast<ui64>(static_cast<std::conditional_t<std::is_signed_v<T>, i64, ui64>>(value)));
+    }
+    void Value(bool value) {
+        PutTag(0);
+        PutVarint(value);
+    }
+    void Value(float value) {
+        PutTag(5);
+        Top().Data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    void Value(double value) {
+        PutTag(1);
+        Top().Data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    void Value(std::string_view value) {
+        PutTag(2);
+        PutVarint(value.size());
+        Top().Data.append(value);
+    }
+
+    // Null values are omitted, list items are repeated fields
+    void Null() { }
+    void BeginOptional() { }
+    void EndOptional() { }
+    void BeginList() { }
+    void Item() { }
+    void EndList() { }
+
+    void BeginStruct() {
+        ++Depth_;
+        Enter();
+    }
+    void BeginTuple() {
+        BeginStruct();
+    }
+    void Member(size_t index, TStringBuf) {
+        Top().Field = index + 1;
+    }
+    void EndStruct() {
+        const auto& nested = Frames_[Depth_--].Data;
+
+        PutTag(2);
+        PutVarint(nested.size());
+        Top().Data.append(nested);
+    }
+    void EndTuple() {
+        EndStruct();
+    }
+
+private:
+    struct TFrame {
+        std::string Data;
+        ui32 Field = 0;
+    };
+
+    TFrame& Top() {
+        return Frames_[Depth_];
+    }
+
+    // Frames are reused for nested messages of next rows
+    void Enter() {
+        if (Frames_.size() <= Depth_) {
+            Frames_.emplace_back();
+        }
+        Top().Data.clear();
+        Top().Field = 0;
+    }
+
+    void PutTag(ui32 wireType) {
+        PutVarint(Top().Field << 3 | wireType);
+    }
+
+    void PutVarint(ui64 value) {
+        auto& data = Top().Data;
+        while (value >= 0x80) {
+            data.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<char>(value));
+    }
+
+private:
+    std::vector<TFrame> Frames_;
+    size_t Depth_ = 0;
+};
+
+// Appends values of a scalar column to its Arrow builder
+class TArrowScalarEncoder {
+public:
+    explicit TArrowScalarEncoder(arrow::ArrayBuilder* builder) : Builder_(builder) { }
+
+    template <typename T>
+    void Value(T value) {
+        Check(static_cast<typename arrow::CTypeTraits<T>::BuilderType*>(Builder_)->Append(value));
+    }
+    void Value(std::string_view value) {
+        Check(static_cast<arrow::BinaryBuilder*>(Builder_)->Append(
+            reinterpret_cast<const uint8_t*>(value.data()), static_cast<int32_t>(value.size())));
+    }
+
+    void Null() {
+        Check(Builder_->AppendNull());
+    }
+    void BeginOptional() { }
+    void EndOptional() { }
+
+    // Columns with nested values are encoded by TYsonEncoder
+    void BeginList() { Unexpected(); }
+    void Item() { Unexpected(); }
+    void EndList() { Unexpected(); }
+    void BeginStruct() { Unexpected(); }
+    void BeginTuple() { Unexpected(); }
+    void Member(size_t, TStringBuf) { Unexpected(); }
+    void EndStruct() { Unexpected(); }
+    void EndTuple() { Unexpected(); }
+
+private:
+    static void Check(const arrow::Status& status) {
+        Y_ENSURE(status.ok(), "Builder append error: " << status.ToString());
+    }
+
+    [[noreturn]] static void Unexpected() {
+        ythrow yexception() << "Nested value in scalar Arrow column";
+    }
+
+private:
+    arrow::ArrayBuilder* Builder_;
+};
+
+// Generation for each format
+
+void GenerateSkiff(std::vector<TColumnGenerator>& columns, IOutputStream* output, size_t rowsCount) {
+    std::string buffer;
+    buffer.reserve(kFlushSize * 2);
+    TSkiffEncoder encoder(buffer);
+
+    for (size_t i = 0; i < rowsCount; ++i) {
+        encoder.BeginRow();
+        for (auto& column : columns) {
+            GenerateValue(encoder, column.Plan, column.Sampler);
+        }
+
+        if (buffer.size() >= kFlushSize) {
+            output->Write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    output->Write(buffer.data(), buffer.size());
+    output->Flush();
+}
+
+void GenerateYson(std::vector<TColumnGenerator>& columns, IOutputStream* output, size_t rowsCount) {
+    TBufferedOutput buffered(output, kFlushSize);
+    ::NYson::TYsonWriter writer(&buffered, ::NYson::EYsonFormat::Binary, ::NYson::EYsonType::ListFragment);
+    TYsonEncoder encoder(writer);
+
+    for (size_t i = 0; i < rowsCount; ++i) {
+        writer.OnListItem();
+        encoder.BeginStruct();
+        for (size_t j = 0; j < columns.size(); ++j) {
+            encoder.Member(j, columns[j].Name);
+            GenerateValue(encoder, columns[j].Plan, columns[j].Sampler);
+        }
+        encoder.EndStruct();
+    }
+
+    buffered.Flush();
+}
+
+void GenerateProtobuf(std::vector<TColumnGenerator>& columns, IOutputStream* output, size_t rowsCount) {
+    std::string buffer;
+    buffer.reserve(kFlushSize * 2);
+    TProtobufEncoder encoder;
+
+    for (size_t i = 0; i < rowsCount; ++i) {
+        encoder.BeginRow();
+        for (size_t j = 0; j < columns.size(); ++j) {
+            encoder.Member(j, {});
+            GenerateValue(encoder, columns[j].Plan, columns[j].Sampler);
+        }
+
+        // Lenval: little-endian length followed by the message
+        const auto& message = encoder.Message();
+        const ui32 length = message.size();
+        buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        buffer.append(message);
+
+        if (buffer.size() >= kFlushSize) {
+            output->Write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    output->Write(buffer.data(), buffer.size());
+    output->Flush();
+}
+
+void GenerateArrow(std::vector<TColumnGenerator>& columns, const NYT::TTableSchema& tableSchema,
+                   IOutputStream* output, size_t rowsCount, size_t batchSize) {
+
+    auto schema = MakeArrowSchema(tableSchema);
+
+    auto streamResult = arrow::ipc::MakeStreamWriter(std::make_shared<TArrowOutputStreamAdapter>(output), schema);
+    Y_ENSURE(streamResult.ok(), "Error occured while openning Arrow stream writer: " << streamResult.status().ToString());
+    auto stream = *streamResult;
+
+    std::vector<std::shared_ptr<arrow::ArrayBuilder>> builders;
+    for (const auto& field : schema->fields()) {
+        auto builder = arrow::MakeBuilder(field->type());
+        Y_ENSURE(builder.ok(), "Error while creating builder of " << field->type()->ToString());
+        builders.push_back(std::move(*builder));
+    }
+
+    auto writeBatch = [&] {
+        std::vector<std::shared_ptr<arrow::Array>> arrays(builders.size());
+        for (size_t i = 0; i < builders.size(); ++i) {
+            auto status = builders[i]->Finish(&arrays[i]);
+            Y_ENSURE(status.ok(), "Error while building array: " << status.ToString());
+        }
+
+        auto status = stream->WriteRecordBatch(*arrow::RecordBatch::Make(schema, arrays.front()->length(), arrays));
+        Y_ENSURE(status.ok(), "Error while writing batch: " << status.ToString());
+    };
+
+    TString complexValue;
+    for (size_t i = 0; i < rowsCount; ++i) {
+        for (size_t j = 0; j < columns.size(); ++j) {
+            auto& column = columns[j];
+
+            if (!column.IsComplex) {
+                TArrowScalarEncoder encoder(builders[j].get());
+                GenerateValue(encoder, column.Plan, column.Sampler);
+                continue;
+            }
+
+            complexValue.clear();
+            {
+                TStringOutput valueOutput(complexValue);
+                ::NYson::TYsonWriter writer(&valueOutput, ::NYson::EYsonFormat::Binary);
+                TYsonEncoder encoder(writer);
+                GenerateValue(encoder, column.Plan, column.Sampler);
+            }
+
+            auto status = static_cast<arrow::BinaryBuilder*>(builders[j].get())->Append(
+                reinterpret_cast<const uint8_t*>(complexValue.data()), static_cast<int32_t>(complexValue.size()));
+            Y_ENSURE(status.ok(), "Builder append error: " << status.ToString());
+        }
+
+        if ((i + 1) % batchSize == 0) {
+            writeBatch();
+        }
+    }
+
+    if (rowsCount % batchSize != 0 && !builders.empty()) {
+        writeBatch();
+    }
+
+    auto status = stream->Close();
+    Y_ENSURE(status.ok(), "Error while closing stream: " << status.ToString());
+}
+
+double AsDouble(const NYT::TNode& node) {
+    return node.IsDouble() ? node.AsDouble() : node.IntCast<i64>();
+}
+
+TColumnDistribution ColumnDistributionFromNode(const NYT::TNode& node, TColumnDistribution res) {
+    if (node.HasKey("cardinality")) {
+        res.Cardinality = node["cardinality"].IntCast<ui64>();
+    }
+    if (node.HasKey("min_string_length")) {
+        res.MinStringLength = node["min_string_length"].IntCast<ui64>();
+    }
+    if (node.HasKey("max_string_length")) {
+        res.MaxStringLength = node["max_string_length"].IntCast<ui64>();
+    }
+    if (node.HasKey("null_ratio")) {
+        res.NullRatio = AsDouble(node["null_ratio"]);
+    }
+    if (node.HasKey("min_list_size")) {
+        res.MinListSize = node["min_list_size"].IntCast<ui64>();
+    }
+    if (node.HasKey("max_list_size")) {
+        res.MaxListSize = node["max_list_size"].IntCast<ui64>();
+    }
+
+    return res;
+}
+
+void ValidateDistribution(const TColumnDistribution& distribution) {
+    Y_ENSURE(distribution.MinStringLength <= distribution.MaxStringLength, "Invalid range of string lengths");
+    Y_ENSURE(distribution.MinListSize <= distribution.MaxListSize, "Invalid range of list sizes");
+    Y_ENSURE(distribution.NullRatio >= 0 && distribution.NullRatio <= 1, "Null ratio must be in [0, 1]");
+}
+
+}
+
+// TDataSpec
+
+const TColumnDistribution& TDataSpec::GetDistribution(const std::string& column) const {
+    auto it = Columns.find(column);
+    return it != Columns.end() ? it->second : Default;
+}
+
+TDataSpec DataSpecFromNode(const NYT::TNode& node) {
+    TDataSpec res;
+
+    if (node.HasKey("seed")) {
+        res.Seed = node["seed"].IntCast<ui64>();
+    }
+    if (node.HasKey("arrow_batch_size")) {
+        res.ArrowBatchSize = node["arrow_batch_size"].IntCast<ui64>();
+    }
+    if (node.HasKey("default")) {
+        res.Default = ColumnDistributionFromNode(node["default"], res.Default);
+    }
+    if (node.HasKey("columns")) {
+        // Columns' distributions override only the fields set
+        for (const auto& [name, distribution] : node["columns"].AsMap()) {
+            res.Columns[name] = ColumnDistributionFromNode(distribution, res.Default);
+        }
+    }
+
+    return res;
+}
+
+// TDataGenerator
+
+TDataGenerator::TDataGenerator(NYT::TTableSchema schema, TDataSpec spec)
+  : Schema_(std::move(schema)), Spec_(std::move(spec)) {
+
+    Y_ENSURE(Spec_.ArrowBatchSize > 0, "Arrow batch size must be positive");
+
+    ValidateDistribution(Spec_.Default);
+    for (const auto& [name, distribution] : Spec_.Columns) {
+        ValidateDistribution(distribution);
+    }
+}
+
+void TDataGenerator::Generate(enum Format format, IOutputStream* output, size_t rowsCount) const {
+    std::vector<TColumnGenerator> columns;
+    columns.reserve(Schema_.Columns().size());
+
+    for (size_t i = 0; i < Schema_.Columns().size(); ++i) {
+        const auto& column = Schema_.Columns()[i];
+
+        columns.push_back({
+            column.Name(),
+            column.Type() == NYT::EValueType::VT_ANY,
+            MakeValuePlan(column.TypeV3()),
+            TValueSampler(Spec_.GetDistribution(column.Name()), Spec_.Seed * Schema_.Columns().size() + i)});
+    }
+
+    switch (format) {
+    case Format::Skiff:
+        return GenerateSkiff(columns, output, rowsCount);
+    case Format::Protobuf:
+        return GenerateProtobuf(columns, output, rowsCount);
+    case Format::Yson:
+        return GenerateYson(columns, output, rowsCount);
+    case Format::Arrow:
+        return GenerateArrow(columns, Schema_, output, rowsCount, Spec_.ArrowBatchSize);
+    }
+}
+
+const NYT::TTableSchema& TDataGenerator::GetTableSchema() const {
+    return Schema_;
+}
+
+}
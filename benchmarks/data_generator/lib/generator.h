@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include <yt/cpp/mapreduce/interface/common.h>
+#include <library/cpp/yson/node/node.h>
+
+#include <util/stream/output.h>
+
+#include <dformats/interface/io.h>
+
+namespace DFormats {
+
+// Distribution of column's values. Nested values of complex columns are distributed the same way
+struct TColumnDistribution {
+    // Number of distinct values of each scalar. Zero means values are drawn from the whole range of the type
+    size_t Cardinality = 0;
+
+    // Lengths of strings are uniform in [MinStringLength, MaxStringLength]
+    size_t MinStringLength = 1;
+    size_t MaxStringLength = 50;
+
+    // Probability of optional value to be null
+    double NullRatio = 0.1;
+
+    // Sizes of lists and dicts are uniform in [MinListSize, MaxListSize]
+    size_t MinListSize = 1;
+    size_t MaxListSize = 50;
+};
+
+struct TDataSpec {
+    TColumnDistribution Default;
+    std::unordered_map<std::string, TColumnDistribution> Columns;  // Overrides of the default by column name
+
+    ui64 Seed = 42;
+
+    // Rows in each record batch of Arrow stream
+    size_t ArrowBatchSize = 1000;
+
+    const TColumnDistribution& GetDistribution(const std::string& column) const;
+};
+
+// Spec is described as
+// {seed=42; arrow_batch_size=1000; default={cardinality=0; min_string_length=1; max_string_length=50;
+//  null_ratio=0.1; min_list_size=1; max_list_size=50}; columns={column_1={cardinality=10}}}.
+// Every field may be omitted
+TDataSpec DataSpecFromNode(const NYT::TNode& node);
+
+// Generates random rows of a table and encodes them right into the stream, without creating row objects.
+// Data is encoded the way a job gets it as input (e.g. Skiff rows have row_index tags). Rows generated
+// with the same spec are the same for every format
+class TDataGenerator {
+public:
+    TDataGenerator(NYT::TTableSchema schema, TDataSpec spec = {});
+
+    void Generate(enum Format format, IOutputStream* output, size_t rowsCount) const;
+
+    const NYT::TTableSchema& GetTableSchema() const;
+
+private:
+    NYT::TTableSchema Schema_;
+    TDataSpec Spec_;
+};
+
+}
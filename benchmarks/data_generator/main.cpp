@@ -0,0 +1,63 @@
+#include <library/cpp/yson/node/node_io.h>
+
+#include <util/generic/yexception.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+
+#include <dformats/benchmarks/data_generator/lib/generator.h>
+
+using namespace DFormats;
+
+namespace {
+
+// Schema files look like `<schema=[...]>`, so they are completed with an entity before parsing
+NYT::TNode ReadYsonFile(const TString& path) {
+    auto text = TFileInput(path).ReadAll();
+    if (text.StartsWith('<')) {
+        text += "#";
+    }
+
+    return NYT::NodeFromYsonString(text);
+}
+
+enum Format ParseFormat(const TString& name) {
+    if (name == "skiff") {
+        return Format::Skiff;
+    }
+    if (name == "protobuf") {
+        return Format::Protobuf;
+    }
+    if (name == "yson") {
+        return Format::Yson;
+    }
+    if (name == "arrow") {
+        return Format::Arrow;
+    }
+
+    ythrow yexception() << "Unknown format \"" << name << "\". Format must be skiff/protobuf/yson/arrow.";
+}
+
+}
+
+// Generates table's rows in the form a job gets them as input.
+// Usage: data_generator <schema file> <skiff|protobuf|yson|arrow> <rows count> [spec file]
+int main(int argc, char** argv) {
+    Y_ENSURE(argc >= 4, "Usage: data_generator <schema file> <skiff|protobuf|yson|arrow> <rows count> [spec file]");
+
+    auto schemaNode = ReadYsonFile(argv[1]);
+    if (schemaNode.HasAttributes() && schemaNode.GetAttributes().HasKey("schema")) {
+        schemaNode = schemaNode.GetAttributes()["schema"];
+    }
+
+    NYT::TTableSchema schema;
+    Deserialize(schema, schemaNode);
+
+    TDataSpec spec;
+    if (argc > 4) {
+        spec = DataSpecFromNode(ReadYsonFile(argv[4]));
+    }
+
+    TDataGenerator(std::move(schema), std::move(spec)).Generate(ParseFormat(argv[2]), &Cout, FromString<size_t>(argv[3]));
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "data.h"
+
+#include <dformats/benchmarks/data_generator/lib/generator.h>
+
+#include <util/generic/yexception.h>
+#include <util/stream/str.h>
+#include <util/string/cast.h>
+
+#include <algorithm>
+
+namespace DFormats {
+
+namespace {
+
+NYT::TTableSchema MakeSchema(const std::vector<std::pair<TString, NTi::TTypePtr>>& columns) {
+    NYT::TTableSchema res;
+    for (const auto& [name, type] : columns) {
+        res.AddColumn(NYT::TColumnSchema().Name(name).TypeV3(type));
+    }
+
+    return res;
+}
+
+NYT::TTableSchema MakeThousandNumericSchema() {
+    // Types are distributed like in the generated schema: mostly small integers
+    static const std::vector<std::pair<NTi::TTypePtr, size_t>> types = {
+        {NTi::Int8(), 332}, {NTi::Int16(), 374}, {NTi::Int32(), 33}, {NTi::Int64(), 32},
+        {NTi::Uint8(), 28}, {NTi::Uint16(), 42}, {NTi::Uint32(), 45}, {NTi::Uint64(), 34},
+        {NTi::Float(), 39}, {NTi::Double(), 41}};
+
+    std::vector<NTi::TTypePtr> columnTypes;
+    for (const auto& [type, count] : types) {
+        columnTypes.insert(columnTypes.end(), count, type);
+    }
+    std::shuffle(columnTypes.begin(), columnTypes.end(), std::mt19937_64(1000));
+
+    std::vector<std::pair<TString, NTi::TTypePtr>> columns;
+    for (size_t i = 0; i < columnTypes.size(); ++i) {
+        columns.emplace_back("column_" + ToString(i + 1), columnTypes[i]);
+    }
+
+    return MakeSchema(columns);
+}
+
+}
+
+NYT::TTableSchema MakeBenchmarkSchema(std::string_view name) {
+    if (name == "thousand_numeric") {
+        return MakeThousandNumericSchema();
+    }
+    if (name == "simple_two") {
+        return MakeSchema({{"id", NTi::Uint32()}, {"data", NTi::String()}});
+    }
+    if (name == "simple_ten") {
+        return MakeSchema({
+            {"column_1", NTi::Int64()}, {"column_2", NTi::Bool()}, {"column_3", NTi::Int16()},
+            {"column_4", NTi::Double()}, {"column_5", NTi::String()}, {"column_6", NTi::Uint32()},
+            {"column_7", NTi::Uint64()}, {"column_8", NTi::Utf8()}, {"column_9", NTi::Bool()},
+            {"column_10", NTi::Uint16()}});
+    }
+    if (name == "complex_types") {
+        return MakeSchema({
+            {"optional", NTi::Optional(NTi::String())},
+            {"list", NTi::List(NTi::Double())},
+            {"struct", NTi::Struct({{"foo", NTi::Int32()}, {"bar", NTi::String()}})},
+            {"dict", NTi::Dict(NTi::Int64(), NTi::String())}});
+    }
+
+    ythrow yexception() << "Unknown benchmark schema \"" << name << "\"";
+}
+
+TString SynthesizeInput(enum Format format, const NYT::TTableSchema& schema, size_t rowsCount, ui64 seed) {
+    TDataSpec spec;
+    spec.Seed = seed;
+
+    TString res;
+    TStringOutput output(res);
+    TDataGenerator(schema, std::move(spec)).Generate(format, &output, rowsCount);
+
+    return res;
+}
+
+}
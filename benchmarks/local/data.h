@@ -0,0 +1,21 @@
+#pragma once
+
+#include <random>
+#include <string_view>
+
+#include <yt/cpp/mapreduce/interface/common.h>
+
+#include <util/generic/string.h>
+
+#include <dformats/interface/io.h>
+
+namespace DFormats {
+
+// Schemas of the tables used by the cluster benchmarks (see data_generator/*_schema.txt):
+// thousand_numeric, simple_two, simple_ten and complex_types
+NYT::TTableSchema MakeBenchmarkSchema(std::string_view name);
+
+// Encodes rows with random values the way the job gets them as input in the given format
+TString SynthesizeInput(enum Format format, const NYT::TTableSchema& schema, size_t rowsCount, ui64 seed = 42);
+
+}
@@ -0,0 +1,379 @@
+#include <yt/cpp/mapreduce/interface/client.h>
+
+#include <util/generic/yexception.h>
+#include <util/string/cast.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <optional>
+
+#include <dformats/interface/mapreduce.h>
+#include <dformats/mapreduce/typed_row.h>
+#include <dformats/skiff/skiff_reader.h>
+
+#include "data.h"
+#include "memory_io.h"
+
+using namespace NYT;
+using namespace DFormats;
+
+// Allocations made with operator new. Arrow's memory pool isn't counted
+static std::atomic<size_t> AllocationsCount = 0;
+
+void* operator new(size_t size) {
+    AllocationsCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+// Jobs below do the same as the ones of the cluster benchmarks b1..b6
+
+class TNotNullCountJob : public TJob {
+public:
+    using TJob::TJob;
+
+    void DoImpl(IRowReader* reader, IRowWriter* writer) override {
+        size_t notNullCount = 0;
+        const auto& schema = reader->GetTableSchema(0);
+
+        for (; reader->IsValid(); reader->Next()) {
+            auto row = reader->ReadRow();
+
+            for (size_t i = 0; i < schema.Columns().size(); ++i) {
+                switch(schema.Columns()[i].Type()) {
+                case EValueType::VT_INT8:
+                    notNullCount += static_cast<bool>(row->GetValue<int8_t>(i));
+                    break;
+                case EValueType::VT_INT16:
+                    notNullCount += static_cast<bool>(row->GetValue<int16_t>(i));
+                    break;
+                case EValueType::VT_INT32:
+                    notNullCount += static_cast<bool>(row->GetValue<int32_t>(i));
+                    break;
+                case EValueType::VT_INT64:
+                    notNullCount += static_cast<bool>(row->GetValue<int64_t>(i));
+                    break;
+                case EValueType::VT_UINT8:
+                    notNullCount += static_cast<bool>(row->GetValue<uint8_t>(i));
+                    break;
+                case EValueType::VT_UINT16:
+                    notNullCount += static_cast<bool>(row->GetValue<uint16_t>(i));
+                    break;
+                case EValueType::VT_UINT32:
+                    notNullCount += static_cast<bool>(row->GetValue<uint32_t>(i));
+                    break;
+                case EValueType::VT_UINT64:
+                    notNullCount += static_cast<bool>(row->GetValue<uint64_t>(i));
+                    break;
+                case EValueType::VT_BOOLEAN:
+                    notNullCount += row->GetValue<bool>(i);
+                    break;
+                case EValueType::VT_FLOAT:
+                    notNullCount += static_cast<bool>(row->GetValue<float>(i));
+                    break;
+                case EValueType::VT_DOUBLE:
+                    notNullCount += static_cast<bool>(row->GetValue<double>(i));
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        auto outputRow = writer->CreateObjectForWrite(0);
+        outputRow->SetValue("not_null_count", static_cast<uint64_t>(notNullCount));
+        writer->WriteRow(std::move(outputRow), 0);
+
+        writer->FinishTable(0);
+    }
+};
+
+class TTotalSizeJob : public TJob {
+public:
+    using TJob::TJob;
+
+    void DoImpl(IRowReader* reader, IRowWriter* writer) override {
+        size_t totalSize = 0;
+        for (; reader->IsValid(); reader->Next()) {
+            auto row = reader->ReadRow();
+
+            totalSize += 8;
+            totalSize += row->GetValue<std::string_view>(1).size();
+        }
+
+        auto outputRow = writer->CreateObjectForWrite(0);
+        outputRow->SetValue("total_size", static_cast<uint64_t>(totalSize));
+        writer->WriteRow(std::move(outputRow), 0);
+
+        writer->FinishTable(0);
+    }
+};
+
+class TIncrementJob : public TJob {
+public:
+    using TJob::TJob;
+
+    void DoImpl(IRowReader* reader, IRowWriter* writer) override {
+        for (; reader->IsValid(); reader->Next()) {
+            auto row = reader->ReadRow();
+            row->SetValue(0, row->GetValue<int64_t>(0) + 1);
+
+            writer->WriteRow(std::move(row), 0);
+        }
+
+        writer->FinishTable(0);
+    }
+};
+
+// Same as TIncrementJob, but through statically typed accessors
+class TTypedIncrementJob : public TJob {
+public:
+    using TJob::TJob;
+
+    using TSchema = TRowSchema<TColumn<"column_1", int64_t>>;
+
+    void DoImpl(IRowReader* reader, IRowWriter* writer) override {
+        TTypedRow<TSchema>::Validate(reader->GetTableSchema(0));
+
+        for (; reader->IsValid(); reader->Next()) {
+            TTypedRow<TSchema> row(reader->ReadRow());
+            row.Set<"column_1">(row.Get<"column_1">() + 1);
+
+            writer->WriteRow(std::move(row).Row(), 0);
+        }
+
+        writer->FinishTable(0);
+    }
+};
+
+// Same as TIncrementJob, but Skiff rows are patched in the input block and written as is
+class TPatchIncrementJob : public TIncrementJob {
+public:
+    using TIncrementJob::TIncrementJob;
+
+    void DoImpl(IRowReader* reader, IRowWriter* writer) override {
+        if (reader->Format() != Format::Skiff || writer->Format() != Format::Skiff) {
+            return TIncrementJob::DoImpl(reader, writer);
+        }
+
+        // Throws if the Skiff reader is hidden by a wrapper reading ahead of it
+        auto& skiffReader = GetFormatReader<TSkiffRowReader>(reader);
+
+        for (; reader->IsValid(); reader->Next()) {
+            auto row = skiffReader.ReadRawRow();
+            row.SetValue(0, row.GetValue<int64_t>(0) + 1);
+
+            writer->WriteRawRow(row.Data(), 0);
+        }
+
+        writer->FinishTable(0);
+    }
+};
+
+class TSetColumnJob : public TJob {
+public:
+    using TJob::TJob;
+
+    void DoImpl(IRowReader* reader, IRowWriter* writer) override {
+        for (; reader->IsValid(); reader->Next()) {
+            auto row = reader->ReadRow();
+            row->SetValue<uint16_t>(9, 42);
+
+            writer->WriteRow(std::move(row), 0);
+        }
+
+        writer->FinishTable(0);
+    }
+};
+
+class TIncrementListJob : public TJob {
+public:
+    using TJob::TJob;
+
+    void DoImpl(IRowReader* reader, IRowWriter* writer) override {
+        for (; reader->IsValid(); reader->Next()) {
+            auto row = reader->ReadRow();
+            auto list = row->GetValue<IListPtr>(1);
+
+            size_t size = list->Size();
+            for (size_t i = 0; i < size; ++i) {
+                list->SetValue(i, list->GetValue<double>(i) + 1);
+            }
+
+            row->SetValue(1, std::move(list));
+
+            writer->WriteRow(std::move(row), 0);
+        }
+
+        writer->FinishTable(0);
+    }
+};
+
+class TWriteOnlyJob : public TJob {
+public:
+    TWriteOnlyJob(MapReduceIOSchema ioSchema, size_t rowsCount)
+      : TJob(std::move(ioSchema)), RowsCount_(rowsCount) { }
+
+    void DoImpl(IRowReader* /* reader */, IRowWriter* writer) override {
+        auto row = writer->CreateObjectForWrite(0);
+
+        row->SetValue<int64_t>(0, -234234324);
+        row->SetValue<bool>(1, true);
+        row->SetValue<int16_t>(2, -42);
+        row->SetValue<double>(3, 3.1415926);
+        row->SetValue<std::string>(4, "Hello world!");
+        row->SetValue<uint32_t>(5, 45423456);
+        row->SetValue<uint64_t>(6, 34567);
+        row->SetValue<std::string>(7, "YTsaurus");
+        row->SetValue<bool>(8, false);
+        row->SetValue<uint16_t>(9, 42);
+
+        for (size_t i = 0; i < RowsCount_; ++i) {
+            writer->WriteRow(row, 0);
+        }
+
+        writer->FinishTable(0);
+    }
+
+private:
+    size_t RowsCount_;
+};
+
+struct TBenchmark {
+    std::string Name;
+    std::string InputSchema;
+    std::optional<TTableSchema> OutputSchema;  // Jobs write rows of input schema if not set
+    size_t DefaultRowsCount;
+    std::function<std::unique_ptr<TJob>(MapReduceIOSchema, size_t)> MakeJob;
+};
+
+template <typename TBenchmarkJob>
+std::unique_ptr<TJob> MakeJob(MapReduceIOSchema ioSchema, size_t /* rowsCount */) {
+    return std::make_unique<TBenchmarkJob>(std::move(ioSchema));
+}
+
+const std::vector<TBenchmark>& Benchmarks() {
+    static const std::vector<TBenchmark> benchmarks = {
+        {"b1", "thousand_numeric", TTableSchema().AddColumn("not_null_count", EValueType::VT_UINT64),
+            10'000, MakeJob<TNotNullCountJob>},
+        {"b2", "simple_two", TTableSchema().AddColumn("total_size", EValueType::VT_UINT64),
+            1'000'000, MakeJob<TTotalSizeJob>},
+        {"b3", "simple_ten", std::nullopt, 1'000'000, MakeJob<TIncrementJob>},
+        {"b3-typed", "simple_ten", std::nullopt, 1'000'000, MakeJob<TTypedIncrementJob>},
+        {"b3-patch", "simple_ten", std::nullopt, 1'000'000, MakeJob<TPatchIncrementJob>},
+        {"b4", "simple_ten", std::nullopt, 1'000'000, MakeJob<TSetColumnJob>},
+        {"b5", "complex_types", std::nullopt, 100'000, MakeJob<TIncrementListJob>},
+        {"b6", "simple_ten", std::nullopt, 1'000'000,
+            [] (MapReduceIOSchema ioSchema, size_t rowsCount) -> std::unique_ptr<TJob> {
+                return std::make_unique<TWriteOnlyJob>(std::move(ioSchema), rowsCount);
+            }},
+    };
+
+    return benchmarks;
+}
+
+const std::vector<std::pair<std::string, enum Format>>& Formats() {
+    static const std::vector<std::pair<std::string, enum Format>> formats = {
+        {"skiff", Format::Skiff},
+        {"dynamic-protobuf", Format::Protobuf},
+        {"yson", Format::Yson},
+        {"arrow", Format::Arrow},
+    };
+
+    return formats;
+}
+
+void RunBenchmark(const TBenchmark& benchmark, const std::string& formatName,
+                  enum Format format, size_t rowsCount) {
+
+    auto inputSchema = MakeBenchmarkSchema(benchmark.InputSchema);
+    const bool writeOnly = benchmark.Name == "b6";
+
+    // Small results of aggregating jobs are written in YSON, like the cluster benchmarks do
+    MapReduceIOSchema ioSchema = {{inputSchema}, format, {0}, format, {0}};
+    if (benchmark.OutputSchema) {
+        ioSchema.TableSchemas.push_back(*benchmark.OutputSchema);
+        ioSchema.OutputFormat = Format::Yson;
+        ioSchema.OutputSchemaIndexes = {1};
+    }
+
+    // Write-only job still needs some valid input to create the reader
+    auto input = SynthesizeInput(format, inputSchema, writeOnly ? 1 : rowsCount);
+    auto job = benchmark.MakeJob(std::move(ioSchema), rowsCount);
+    TMemoryTables output(1);
+
+    const auto allocationsBefore = AllocationsCount.load();
+    const auto start = std::chrono::steady_clock::now();
+
+    job->Run(MakeIntrusive<TMemoryTableReader>(std::string_view(input.data(), input.size())),
+             MakeHolder<TMemoryProxyOutput>(output));
+
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    const auto allocations = AllocationsCount.load() - allocationsBefore;
+
+    const auto bytesCount = (writeOnly ? 0 : input.size()) + output.BytesCount();
+
+    std::cout << std::left << std::setw(10) << benchmark.Name
+              << std::setw(18) << formatName
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << rowsCount / duration.count() << " rows/s"
+              << std::setw(12) << bytesCount / duration.count() / (1 << 20) << " MiB/s"
+              << std::setw(10) << static_cast<double>(allocations) / rowsCount << " allocs/row"
+              << std::endl;
+}
+
+}
+
+// Runs the benchmarks locally over in-memory input and output.
+// Usage: local [benchmark|all] [format|all] [rows count]
+int main(int argc, char** argv) {
+    std::string benchmarkName = argc > 1 ? argv[1] : "all";
+    std::string formatName = argc > 2 ? argv[2] : "all";
+    std::optional<size_t> rowsCount;
+    if (argc > 3) {
+        rowsCount = FromString<size_t>(argv[3]);
+    }
+
+    bool found = false;
+    for (const auto& benchmark : Benchmarks()) {
+        if (benchmarkName != "all" && benchmarkName != benchmark.Name) {
+            continue;
+        }
+
+        for (const auto& [name, format] : Formats()) {
+            if (formatName != "all" && formatName != name) {
+                continue;
+            }
+
+            RunBenchmark(benchmark, name, format, rowsCount.value_or(benchmark.DefaultRowsCount));
+            found = true;
+        }
+    }
+
+    Y_ENSURE(found, "Unknown benchmark \"" << benchmarkName << "\" or format \"" << formatName <<
+             "\". Benchmark must be b1..b6/b3-typed/b3-patch/all, format must be skiff/dynamic-protobuf/yson/arrow/all.");
+
+    return 0;
+}
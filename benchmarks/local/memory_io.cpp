@@ -0,0 +1,65 @@
+#include "memory_io.h"
+
+#include <cstring>
+
+namespace DFormats {
+
+// TMemoryTableReader
+
+TMemoryTableReader::TMemoryTableReader(std::string_view data) : Data_(data) { }
+
+bool TMemoryTableReader::Retry(const TMaybe<ui32>&, const TMaybe<ui64>&, const std::exception_ptr&) {
+    return false;
+}
+
+void TMemoryTableReader::ResetRetries() { }
+
+bool TMemoryTableReader::HasRangeIndices() const {
+    return false;
+}
+
+size_t TMemoryTableReader::DoRead(void* buf, size_t len) {
+    len = std::min(len, Data_.size() - Position_);
+    std::memcpy(buf, Data_.data() + Position_, len);
+    Position_ += len;
+
+    return len;
+}
+
+// TMemoryTables
+
+size_t TMemoryTables::BytesCount() const {
+    size_t res = 0;
+    for (const auto& data : Data) {
+        res += data.size();
+    }
+
+    return res;
+}
+
+// TMemoryProxyOutput
+
+TMemoryProxyOutput::TMemoryProxyOutput(TMemoryTables& tables, bool trackRows)
+  : Tables_(tables), TrackRows_(trackRows) {
+
+    Streams_.reserve(Tables_.Data.size());
+    for (auto& data : Tables_.Data) {
+        Streams_.push_back(std::make_unique<TStringOutput>(data));
+    }
+}
+
+size_t TMemoryProxyOutput::GetStreamCount() const {
+    return Streams_.size();
+}
+
+IOutputStream* TMemoryProxyOutput::GetStream(size_t tableIndex) const {
+    return Streams_.at(tableIndex).get();
+}
+
+void TMemoryProxyOutput::OnRowFinished(size_t tableIndex) {
+    if (TrackRows_) {
+        Tables_.RowEnds[tableIndex].push_back(Tables_.Data[tableIndex].size());
+    }
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <yt/cpp/mapreduce/interface/io.h>
+#include <yt/cpp/mapreduce/io/proxy_output.h>
+
+#include <util/generic/string.h>
+#include <util/stream/str.h>
+
+namespace DFormats {
+
+// Stand-in for job's input stream reading bytes kept in memory. Data isn't copied,
+// so it must outlive the reader
+class TMemoryTableReader : public NYT::TRawTableReader {
+public:
+    explicit TMemoryTableReader(std::string_view data);
+
+    bool Retry(const TMaybe<ui32>& rangeIndex, const TMaybe<ui64>& rowIndex,
+               const std::exception_ptr& error) override;
+    void ResetRetries() override;
+    bool HasRangeIndices() const override;
+
+protected:
+    size_t DoRead(void* buf, size_t len) override;
+
+private:
+    std::string_view Data_;
+    size_t Position_ = 0;
+};
+
+// Tables collected by TMemoryProxyOutput. Kept apart from the output, since the output is owned
+// by a writer and destroyed with it
+struct TMemoryTables {
+    explicit TMemoryTables(size_t count) : Data(count), RowEnds(count) { }
+
+    size_t BytesCount() const;
+
+    std::vector<TString> Data;
+    std::vector<std::vector<size_t>> RowEnds;  // Offsets where rows end, if they are tracked
+};
+
+// Stand-in for job's output files writing tables to memory
+class TMemoryProxyOutput : public NYT::IProxyOutput {
+public:
+    explicit TMemoryProxyOutput(TMemoryTables& tables, bool trackRows = false);
+
+    size_t GetStreamCount() const override;
+    IOutputStream* GetStream(size_t tableIndex) const override;
+    void OnRowFinished(size_t tableIndex) override;
+
+private:
+    TMemoryTables& Tables_;
+    std::vector<std::unique_ptr<TStringOutput>> Streams_;
+    const bool TrackRows_;
+};
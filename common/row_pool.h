@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <dformats/interface/types.h>
+
+namespace DFormats {
+
+// Keeps rows already consumed by a writer, so CreateObjectForWrite can hand them out again instead of
+// allocating new ones. Writer is responsible for resetting rows before releasing them to the pool.
+// Pool is synchronized: rows may be released by a thread other than the one acquiring them
+class TRowPool {
+public:
+    static constexpr size_t kDefaultCapacity = 64;
+
+    explicit TRowPool(size_t capacity = kDefaultCapacity) : Capacity_(capacity) {
+        Rows_.reserve(Capacity_);
+    }
+
+    inline IRowPtr Acquire() {
+        std::lock_guard lock(Mutex_);
+
+        if (Rows_.empty()) {
+            return nullptr;
+        }
+
+        auto row = std::move(Rows_.back());
+        Rows_.pop_back();
+        return row;
+    }
+
+    inline bool Release(IRowPtr&& row) {
+        std::lock_guard lock(Mutex_);
+
+        if (Rows_.size() >= Capacity_) {
+            return false;
+        }
+
+        Rows_.push_back(std::move(row));
+        return true;
+    }
+
+private:
+    std::vector<IRowPtr> Rows_;
+    size_t Capacity_;
+    std::mutex Mutex_;
+};
+
+}
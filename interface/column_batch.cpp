@@ -0,0 +1,153 @@
+#include "column_batch.h"
+
+#include <util/generic/yexception.h>
+
+namespace DFormats {
+
+// TTransposedColumnBatch
+
+TTransposedColumnBatch::TTransposedColumnBatch(
+    size_t tableIndex, const NYT::TTableSchema& schema, std::vector<IRowPtr> rows)
+  : TableIndex_(tableIndex), Rows_(std::move(rows)), Columns_(schema.Columns().size()) {
+
+    OptionalColumns_.reserve(schema.Columns().size());
+    for (const auto& column : schema.Columns()) {
+        OptionalColumns_.push_back(column.TypeV3()->StripTags()->IsOptional());
+    }
+}
+
+size_t TTransposedColumnBatch::GetTableIndex() const {
+    return TableIndex_;
+}
+
+size_t TTransposedColumnBatch::RowsCount() const {
+    return Rows_.size();
+}
+
+size_t TTransposedColumnBatch::ColumnsCount() const {
+    return Columns_.size();
+}
+
+template <typename T>
+TColumnView<T> TTransposedColumnBatch::Transpose(size_t column) const {
+    auto& cached = Columns_[column];
+
+    // Column is gathered again only if it is requested with another type than before
+    if (auto* builder = std::get_if<TColumnBuilder<T>>(&cached)) {
+        return builder->View();
+    }
+
+    auto& builder = cached.emplace<TColumnBuilder<T>>(Rows_.size());
+
+    if (!OptionalColumns_[column]) {
+        for (const auto& row : Rows_) {
+            builder.Append(row->GetValue<T>(column));
+        }
+    } else {
+        for (const auto& row : Rows_) {
+            auto value = row->GetValue<IOptionalConstPtr>(column);
+            if (value->HasValue()) {
+                builder.Append(value->GetValue<T>());
+            } else {
+                builder.AppendNull();
+            }
+        }
+    }
+
+    return builder.View();
+}
+
+TColumnView<bool> TTransposedColumnBatch::GetBoolColumn(size_t column) const {
+    return Transpose<bool>(column);
+}
+
+TColumnView<int8_t> TTransposedColumnBatch::GetInt8Column(size_t column) const {
+    return Transpose<int8_t>(column);
+}
+
+TColumnView<int16_t> TTransposedColumnBatch::GetInt16Column(size_t column) const {
+    return Transpose<int16_t>(column);
+}
+
+TColumnView<int32_t> TTransposedColumnBatch::GetInt32Column(size_t column) const {
+    return Transpose<int32_t>(column);
+}
+
+TColumnView<int64_t> TTransposedColumnBatch::GetInt64Column(size_t column) const {
+    return Transpose<int64_t>(column);
+}
+
+TColumnView<uint8_t> TTransposedColumnBatch::GetUInt8Column(size_t column) const {
+    return Transpose<uint8_t>(column);
+}
+
+TColumnView<uint16_t> TTransposedColumnBatch::GetUInt16Column(size_t column) const {
+    return Transpose<uint16_t>(column);
+}
+
+TColumnView<uint32_t> TTransposedColumnBatch::GetUInt32Column(size_t column) const {
+    return Transpose<uint32_t>(column);
+}
+
+TColumnView<uint64_t> TTransposedColumnBatch::GetUInt64Column(size_t column) const {
+    return Transpose<uint64_t>(column);
+}
+
+TColumnView<float> TTransposedColumnBatch::GetFloatColumn(size_t column) const {
+    return Transpose<float>(column);
+}
+
+TColumnView<double> TTransposedColumnBatch::GetDoubleColumn(size_t column) const {
+    return Transpose<double>(column);
+}
+
+TColumnView<std::string_view> TTransposedColumnBatch::GetStringColumn(size_t column) const {
+    return Transpose<std::string_view>(column);
+}
+
+// TTransposingColumnBatchReader
+
+TTransposingColumnBatchReader::TTransposingColumnBatchReader(IRowReader* underlying)
+  : Underlying_(underlying) { }
+
+IColumnBatchPtr TTransposingColumnBatchReader::ReadBatch(size_t maxRows) {
+    Y_ENSURE(maxRows > 0, "Batch must contain at least one row");
+
+    if (Position_ == Rows_.size()) {
+        Position_ = 0;
+        if (!Underlying_->ReadRows(Rows_, maxRows, &Contexts_)) {
+            return nullptr;
+        }
+    }
+
+    // Rows read at once may belong to different tables, so they are split into several batches
+    const auto tableIndex = Contexts_[Position_].TableIndex;
+    auto end = Position_;
+    while (end < Rows_.size() && end - Position_ < maxRows && Contexts_[end].TableIndex == tableIndex) {
+        ++end;
+    }
+
+    std::vector<IRowPtr> rows(Rows_.begin() + Position_, Rows_.begin() + end);
+    Position_ = end;
+
+    return std::make_shared<TTransposedColumnBatch>(
+        tableIndex, Underlying_->GetTableSchema(tableIndex), std::move(rows));
+}
+
+size_t TTransposingColumnBatchReader::GetTablesCount() const {
+    return Underlying_->GetTablesCount();
+}
+
+const NYT::TTableSchema& TTransposingColumnBatchReader::GetTableSchema(size_t tableIndex) const {
+    return Underlying_->GetTableSchema(tableIndex);
+}
+
+std::shared_ptr<IColumnBatchReader> MakeColumnBatchReader(IRowReader* reader) {
+    if (auto* native = reader->GetColumnBatchReader()) {
+        return std::shared_ptr<IColumnBatchReader>(std::shared_ptr<IColumnBatchReader>(), native);
+    }
+
+    return std::make_shared<TTransposingColumnBatchReader>(reader);
+}
+
+}
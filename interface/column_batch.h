@@ -0,0 +1,277 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <yt/cpp/mapreduce/interface/common.h>
+
+#include "io.h"
+
+namespace DFormats {
+
+class IColumnBatch;
+class IColumnBatchReader;
+
+using IColumnBatchPtr = std::shared_ptr<IColumnBatch>;
+
+// Null bitmap in Arrow layout: bit is set for rows having a value. Null Data means there are no nulls
+struct TNullBitmap {
+    const uint8_t* Data = nullptr;
+    size_t Offset = 0;  // In bits
+
+    inline bool IsNull(size_t ind) const {
+        return Data && !((Data[(Offset + ind) >> 3] >> ((Offset + ind) & 7)) & 1);
+    }
+};
+
+// Column of fixed-width values laid out contiguously. Values of null rows are unspecified
+template <typename T>
+struct TColumnView {
+    const T* Values = nullptr;
+    size_t Size = 0;
+    TNullBitmap Nulls;
+
+    inline bool IsNull(size_t ind) const {
+        return Nulls.IsNull(ind);
+    }
+    inline T operator[](size_t ind) const {
+        return Values[ind];
+    }
+    inline std::span<const T> Span() const {
+        return {Values, Size};
+    }
+};
+
+// Column of strings: value i lays in Data between Offsets[i] and Offsets[i + 1]
+template <>
+struct TColumnView<std::string_view> {
+    const int32_t* Offsets = nullptr;
+    const char* Data = nullptr;
+    size_t Size = 0;
+    TNullBitmap Nulls;
+
+    inline bool IsNull(size_t ind) const {
+        return Nulls.IsNull(ind);
+    }
+    inline std::string_view operator[](size_t ind) const {
+        return {Data + Offsets[ind], static_cast<size_t>(Offsets[ind + 1] - Offsets[ind])};
+    }
+};
+
+class TNullBitmapBuilder {
+public:
+    inline void Append(bool hasValue) {
+        if (!hasValue && Data_.empty()) {
+            Data_.assign(Capacity_ / 8 + 1, 0xFF);
+        }
+        if (!hasValue) {
+            Data_[Size_ >> 3] &= ~(1 << (Size_ & 7));
+        }
+        ++Size_;
+    }
+
+    inline void Reserve(size_t capacity) {
+        Capacity_ = capacity;
+    }
+
+    inline TNullBitmap View() const {
+        return {Data_.empty() ? nullptr : Data_.data(), 0};
+    }
+
+private:
+    std::vector<uint8_t> Data_;
+    size_t Capacity_ = 0;
+    size_t Size_ = 0;
+};
+
+// Owned storage for columns which can't be viewed in place, e.g. gathered from rows
+template <typename T>
+class TColumnBuilder {
+public:
+    explicit TColumnBuilder(size_t capacity) : Values_(new T[capacity]()) {
+        Nulls_.Reserve(capacity);
+    }
+
+    inline void Append(T value) {
+        Values_[Size_++] = value;
+        Nulls_.Append(true);
+    }
+    inline void AppendNull() {
+        ++Size_;
+        Nulls_.Append(false);
+    }
+
+    inline TColumnView<T> View() const {
+        return {Values_.get(), Size_, Nulls_.View()};
+    }
+
+private:
+    std::unique_ptr<T[]> Values_;
+    size_t Size_ = 0;
+    TNullBitmapBuilder Nulls_;
+};
+
+template <>
+class TColumnBuilder<std::string_view> {
+public:
+    explicit TColumnBuilder(size_t capacity) {
+        Offsets_.reserve(capacity + 1);
+        Offsets_.push_back(0);
+        Nulls_.Reserve(capacity);
+    }
+
+    inline void Append(std::string_view value) {
+        Data_.append(value);
+        Offsets_.push_back(Data_.size());
+        Nulls_.Append(true);
+    }
+    inline void AppendNull() {
+        Offsets_.push_back(Data_.size());
+        Nulls_.Append(false);
+    }
+
+    inline TColumnView<std::string_view> View() const {
+        return {Offsets_.data(), Data_.data(), Offsets_.size() - 1, Nulls_.View()};
+    }
+
+private:
+    std::vector<int32_t> Offsets_;
+    std::string Data_;
+    TNullBitmapBuilder Nulls_;
+};
+
+using TAnyColumnBuilder = std::variant<std::monostate,
+    TColumnBuilder<bool>, TColumnBuilder<int8_t>, TColumnBuilder<int16_t>, TColumnBuilder<int32_t>,
+    TColumnBuilder<int64_t>, TColumnBuilder<uint8_t>, TColumnBuilder<uint16_t>, TColumnBuilder<uint32_t>,
+    TColumnBuilder<uint64_t>, TColumnBuilder<float>, TColumnBuilder<double>, TColumnBuilder<std::string_view>>;
+
+// Rows of a single table laid out by columns. Column views stay valid while the batch is alive
+class IColumnBatch {
+public:
+    virtual ~IColumnBatch() {}
+
+    virtual size_t GetTableIndex() const = 0;
+    virtual size_t RowsCount() const = 0;
+    virtual size_t ColumnsCount() const = 0;
+
+    template <typename T>
+    TColumnView<T> GetColumn(size_t column) const {
+        using U = std::remove_cv_t<T>;
+
+        if constexpr (std::is_same_v<U, bool>) {
+            return GetBoolColumn(column);
+        } else if constexpr (std::is_same_v<U, int8_t>) {
+            return GetInt8Column(column);
+        } else if constexpr (std::is_same_v<U, int16_t>) {
+            return GetInt16Column(column);
+        } else if constexpr (std::is_same_v<U, int32_t>) {
+            return GetInt32Column(column);
+        } else if constexpr (std::is_same_v<U, int64_t>) {
+            return GetInt64Column(column);
+        } else if constexpr (std::is_same_v<U, uint8_t>) {
+            return GetUInt8Column(column);
+        } else if constexpr (std::is_same_v<U, uint16_t>) {
+            return GetUInt16Column(column);
+        } else if constexpr (std::is_same_v<U, uint32_t>) {
+            return GetUInt32Column(column);
+        } else if constexpr (std::is_same_v<U, uint64_t>) {
+            return GetUInt64Column(column);
+        } else if constexpr (std::is_same_v<U, float>) {
+            return GetFloatColumn(column);
+        } else if constexpr (std::is_same_v<U, double>) {
+            return GetDoubleColumn(column);
+        } else if constexpr (std::is_same_v<U, std::string_view>) {
+            return GetStringColumn(column);
+        } else {
+            static_assert(false, "Unsopported type");
+        }
+    }
+
+protected:
+    virtual TColumnView<bool> GetBoolColumn(size_t) const = 0;
+    virtual TColumnView<int8_t> GetInt8Column(size_t) const = 0;
+    virtual TColumnView<int16_t> GetInt16Column(size_t) const = 0;
+    virtual TColumnView<int32_t> GetInt32Column(size_t) const = 0;
+    virtual TColumnView<int64_t> GetInt64Column(size_t) const = 0;
+    virtual TColumnView<uint8_t> GetUInt8Column(size_t) const = 0;
+    virtual TColumnView<uint16_t> GetUInt16Column(size_t) const = 0;
+    virtual TColumnView<uint32_t> GetUInt32Column(size_t) const = 0;
+    virtual TColumnView<uint64_t> GetUInt64Column(size_t) const = 0;
+    virtual TColumnView<float> GetFloatColumn(size_t) const = 0;
+    virtual TColumnView<double> GetDoubleColumn(size_t) const = 0;
+    virtual TColumnView<std::string_view> GetStringColumn(size_t) const = 0;
+};
+
+class IColumnBatchReader {
+public:
+    virtual ~IColumnBatchReader() {}
+
+    // Reads up to maxRows rows starting from the current one and moves the reader past them.
+    // All rows of a batch belong to the same table. Returns nullptr at the end of stream
+    virtual IColumnBatchPtr ReadBatch(size_t maxRows) = 0;
+
+    virtual size_t GetTablesCount() const = 0;
+    virtual const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const = 0;
+};
+
+// Batch gathering columns from rows on first access
+class TTransposedColumnBatch : public IColumnBatch {
+public:
+    TTransposedColumnBatch(size_t tableIndex, const NYT::TTableSchema& schema, std::vector<IRowPtr> rows);
+
+    size_t GetTableIndex() const override;
+    size_t RowsCount() const override;
+    size_t ColumnsCount() const override;
+
+protected:
+    TColumnView<bool> GetBoolColumn(size_t column) const override;
+    TColumnView<int8_t> GetInt8Column(size_t column) const override;
+    TColumnView<int16_t> GetInt16Column(size_t column) const override;
+    TColumnView<int32_t> GetInt32Column(size_t column) const override;
+    TColumnView<int64_t> GetInt64Column(size_t column) const override;
+    TColumnView<uint8_t> GetUInt8Column(size_t column) const override;
+    TColumnView<uint16_t> GetUInt16Column(size_t column) const override;
+    TColumnView<uint32_t> GetUInt32Column(size_t column) const override;
+    TColumnView<uint64_t> GetUInt64Column(size_t column) const override;
+    TColumnView<float> GetFloatColumn(size_t column) const override;
+    TColumnView<double> GetDoubleColumn(size_t column) const override;
+    TColumnView<std::string_view> GetStringColumn(size_t column) const override;
+
+    template <typename T>
+    TColumnView<T> Transpose(size_t column) const;
+
+private:
+    size_t TableIndex_;
+    std::vector<bool> OptionalColumns_;
+    std::vector<IRowPtr> Rows_;
+    mutable std::vector<TAnyColumnBuilder> Columns_;
+};
+
+// Adapter for backends which are row-oriented. Rows are read with IRowReader::ReadRows,
+// so they are reused once batches referencing them are released
+class TTransposingColumnBatchReader : public IColumnBatchReader {
+public:
+    explicit TTransposingColumnBatchReader(IRowReader* underlying);
+
+    IColumnBatchPtr ReadBatch(size_t maxRows) override;
+
+    size_t GetTablesCount() const override;
+    const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
+
+private:
+    IRowReader* Underlying_;
+    std::vector<IRowPtr> Rows_;
+    std::vector<TReadingContext> Contexts_;
+    size_t Position_ = 0;
+};
+
+// Returns the native batch reader of the reader (without taking ownership) if it has one,
+// and a transposing adapter over it otherwise
+std::shared_ptr<IColumnBatchReader> MakeColumnBatchReader(IRowReader* reader);
+
+}
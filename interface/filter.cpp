@@ -0,0 +1,193 @@
+#include "filter.h"
+#include "io.h"
+
+#include <limits>
+
+#include <util/generic/yexception.h>
+
+namespace DFormats {
+
+namespace {
+
+TFilterValue ConvertValue(const TFilterValue& value, NTi::ETypeName type) {
+    using NTi::ETypeName;
+
+    switch (type) {
+    case ETypeName::Bool:
+        Y_ENSURE(std::holds_alternative<bool>(value), "Boolean column is compared with non-boolean value");
+        return value;
+
+    case ETypeName::Int8:
+    case ETypeName::Int16:
+    case ETypeName::Int32:
+    case ETypeName::Int64:
+        if (const auto* unsignedValue = std::get_if<uint64_t>(&value)) {
+            Y_ENSURE(*unsignedValue <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()),
+                     "Value is out of range of signed column");
+            return static_cast<int64_t>(*unsignedValue);
+        }
+        Y_ENSURE(std::holds_alternative<int64_t>(value), "Signed column is compared with non-integer value");
+        return value;
+
+    case ETypeName::Uint8:
+    case ETypeName::Uint16:
+    case ETypeName::Uint32:
+    case ETypeName::Uint64:
+        if (const auto* signedValue = std::get_if<int64_t>(&value)) {
+            Y_ENSURE(*signedValue >= 0, "Value is out of range of unsigned column");
+            return static_cast<uint64_t>(*signedValue);
+        }
+        Y_ENSURE(std::holds_alternative<uint64_t>(value), "Unsigned column is compared with non-integer value");
+        return value;
+
+    case ETypeName::Float:
+    case ETypeName::Double:
+        if (const auto* signedValue = std::get_if<int64_t>(&value)) {
+            return static_cast<double>(*signedValue);
+        }
+        if (const auto* unsignedValue = std::get_if<uint64_t>(&value)) {
+            return static_cast<double>(*unsignedValue);
+        }
+        Y_ENSURE(std::holds_alternative<double>(value), "Floating point column is compared with non-numeric value");
+        return value;
+
+    case ETypeName::String:
+    case ETypeName::Utf8:
+        Y_ENSURE(std::holds_alternative<std::string>(value), "String column is compared with non-string value");
+        return value;
+
+    default:
+        ythrow yexception() << "Columns of type " << type << " can't be filtered";
+    }
+}
+
+template <typename T, typename TObject, typename TIndex>
+bool MatchesValue(const TResolvedPredicate& predicate, const TObject& object, TIndex ind) {
+    return predicate.Matches(object.template GetValue<T>(ind));
+}
+
+template <typename TObject, typename TIndex>
+bool MatchesScalar(const TResolvedPredicate& predicate, const TObject& object, TIndex ind) {
+    using NTi::ETypeName;
+
+    switch (predicate.Type) {
+    case ETypeName::Bool:
+        return MatchesValue<bool>(predicate, object, ind);
+    case ETypeName::Int8:
+        return MatchesValue<int8_t>(predicate, object, ind);
+    case ETypeName::Int16:
+        return MatchesValue<int16_t>(predicate, object, ind);
+    case ETypeName::Int32:
+        return MatchesValue<int32_t>(predicate, object, ind);
+    case ETypeName::Int64:
+        return MatchesValue<int64_t>(predicate, object, ind);
+    case ETypeName::Uint8:
+        return MatchesValue<uint8_t>(predicate, object, ind);
+    case ETypeName::Uint16:
+        return MatchesValue<uint16_t>(predicate, object, ind);
+    case ETypeName::Uint32:
+        return MatchesValue<uint32_t>(predicate, object, ind);
+    case ETypeName::Uint64:
+        return MatchesValue<uint64_t>(predicate, object, ind);
+    case ETypeName::Float:
+        return MatchesValue<float>(predicate, object, ind);
+    case ETypeName::Double:
+        return MatchesValue<double>(predicate, object, ind);
+    case ETypeName::String:
+    case ETypeName::Utf8:
+        return MatchesValue<std::string_view>(predicate, object, ind);
+    default:
+        return false;
+    }
+}
+
+NYT::TNode FilterValueToNode(const TFilterValue& value) {
+    return std::visit([] (const auto& v) { return NYT::TNode(v); }, value);
+}
+
+TFilterValue FilterValueFromNode(const NYT::TNode& node) {
+    switch (node.GetType()) {
+    case NYT::TNode::Bool:
+        return node.AsBool();
+    case NYT::TNode::Int64:
+        return node.AsInt64();
+    case NYT::TNode::Uint64:
+        return node.AsUint64();
+    case NYT::TNode::Double:
+        return node.AsDouble();
+    case NYT::TNode::String:
+        return std::string(node.AsString());
+    default:
+        ythrow yexception() << "Invalid filter value";
+    }
+}
+
+}
+
+NYT::TNode RowFilterToNode(const TRowFilter& filter) {
+    auto res = NYT::TNode::CreateList();
+
+    for (const auto& predicate : filter.Predicates) {
+        res.Add(NYT::TNode()
+            ("Column", predicate.Column)
+            ("Op", static_cast<int64_t>(predicate.Op))
+            ("Value", FilterValueToNode(predicate.Value)));
+    }
+
+    return res;
+}
+
+TRowFilter RowFilterFromNode(const NYT::TNode& node) {
+    TRowFilter res;
+
+    for (const auto& predicate : node.AsList()) {
+        res.Predicates.push_back({
+            predicate["Column"].AsString(),
+            static_cast<ECompareOp>(predicate["Op"].AsInt64()),
+            FilterValueFromNode(predicate["Value"])});
+    }
+
+    return res;
+}
+
+std::vector<TResolvedPredicate> ResolveFilter(const TRowFilter& filter, const NYT::TTableSchema& schema) {
+    std::vector<TResolvedPredicate> res;
+    res.reserve(filter.Predicates.size());
+
+    for (const auto& predicate : filter.Predicates) {
+        const auto column = FindColumnIndex(schema, predicate.Column);
+
+        auto type = schema.Columns()[column].TypeV3()->StripTags();
+        const bool isOptional = type->IsOptional();
+        if (isOptional) {
+            type = type->AsOptional()->GetItemType()->StripTags();
+        }
+
+        res.push_back({column, type->GetTypeName(), isOptional, predicate.Op,
+                       ConvertValue(predicate.Value, type->GetTypeName())});
+    }
+
+    return res;
+}
+
+bool MatchesRow(const std::vector<TResolvedPredicate>& predicates, const IBaseRow& row) {
+    const auto& tuple = static_cast<const IBaseTuple&>(row);
+
+    for (const auto& predicate : predicates) {
+        if (!predicate.IsOptional) {
+            if (!MatchesScalar(predicate, tuple, predicate.Column)) {
+                return false;
+            }
+            continue;
+        }
+
+        auto optional = tuple.GetValue<IOptionalConstPtr>(predicate.Column);
+        if (!optional->HasValue() || !MatchesScalar(predicate, static_cast<const IBaseIndexed<bool>&>(*optional), true)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <yt/cpp/mapreduce/interface/common.h>
+#include <library/cpp/type_info/type_info.h>
+#include <library/cpp/yson/node/node.h>
+
+#include "types.h"
+
+namespace DFormats {
+
+enum class ECompareOp {
+    Equal,
+    NotEqual,
+    Less,
+    LessOrEqual,
+    Greater,
+    GreaterOrEqual
+};
+
+using TFilterValue = std::variant<bool, int64_t, uint64_t, double, std::string>;
+
+// Comparison of column's value with a constant: <column> <op> <value>. Null values match nothing
+struct TColumnPredicate {
+    TString Column;
+    ECompareOp Op;
+    TFilterValue Value;
+};
+
+// Conjunction of predicates over scalar (or optional scalar) columns
+struct TRowFilter {
+    std::vector<TColumnPredicate> Predicates;
+
+    inline bool Empty() const {
+        return Predicates.empty();
+    }
+};
+
+NYT::TNode RowFilterToNode(const TRowFilter& filter);
+TRowFilter RowFilterFromNode(const NYT::TNode& node);
+
+template <typename T>
+inline bool Compare(const T& lhs, ECompareOp op, const T& rhs) {
+    switch (op) {
+    case ECompareOp::Equal:
+        return lhs == rhs;
+    case ECompareOp::NotEqual:
+        return lhs != rhs;
+    case ECompareOp::Less:
+        return lhs < rhs;
+    case ECompareOp::LessOrEqual:
+        return lhs <= rhs;
+    case ECompareOp::Greater:
+        return lhs > rhs;
+    case ECompareOp::GreaterOrEqual:
+        return lhs >= rhs;
+    }
+
+    return false;
+}
+
+// Clears selection of values not satisfying <value> <op> <constant>. Operation is dispatched once per call,
+// so the loop over values can be vectorized
+template <typename T, typename TConstant>
+void SelectMatching(const T* values, size_t count, ECompareOp op, TConstant constant, uint8_t* selection) {
+    auto apply = [&] (auto compare) {
+        for (size_t i = 0; i < count; ++i) {
+            selection[i] &= compare(static_cast<TConstant>(values[i]), constant);
+        }
+    };
+
+    switch (op) {
+    case ECompareOp::Equal:
+        return apply(std::equal_to<>());
+    case ECompareOp::NotEqual:
+        return apply(std::not_equal_to<>());
+    case ECompareOp::Less:
+        return apply(std::less<>());
+    case ECompareOp::LessOrEqual:
+        return apply(std::less_equal<>());
+    case ECompareOp::Greater:
+        return apply(std::greater<>());
+    case ECompareOp::GreaterOrEqual:
+        return apply(std::greater_equal<>());
+    }
+}
+
+// Predicate bound to a column of the table schema. Value is converted to the column's kind:
+// int64 for signed integers, uint64 for unsigned ones, double for floating point types
+struct TResolvedPredicate {
+    size_t Column;
+    NTi::ETypeName Type;  // Type of the column's value, without optional
+    bool IsOptional;
+    ECompareOp Op;
+    TFilterValue Value;
+
+    template <typename T>
+    inline bool Matches(T value) const {
+        if constexpr (std::is_same_v<T, bool>) {
+            return Compare(value, Op, std::get<bool>(Value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return Compare<double>(value, Op, std::get<double>(Value));
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            return Compare(value, Op, std::string_view(std::get<std::string>(Value)));
+        } else if constexpr (std::is_signed_v<T>) {
+            return Compare<int64_t>(value, Op, std::get<int64_t>(Value));
+        } else {
+            return Compare<uint64_t>(value, Op, std::get<uint64_t>(Value));
+        }
+    }
+};
+
+// Throws if a column is missing or its type can't be compared with the value
+std::vector<TResolvedPredicate> ResolveFilter(const TRowFilter& filter, const NYT::TTableSchema& schema);
+
+// Evaluates predicates on a materialized row
+bool MatchesRow(const std::vector<TResolvedPredicate>& predicates, const IBaseRow& row);
+
+}
@@ -1,15 +1,22 @@
 #pragma once
 
+#include <algorithm>
 #include <optional>
+#include <string_view>
+#include <vector>
 
 #include <util/stream/input.h>
 #include <util/stream/output.h>
+#include <util/system/type_name.h>
 #include <yt/cpp/mapreduce/interface/common.h>
 
 #include "types.h"
+#include "filter.h"
 
 namespace DFormats {
 
+class IColumnBatchReader;
+
 enum Format {
     Yson,
     Skiff,
@@ -23,6 +30,37 @@ enum ReadingOptions {
     HasAfterKeySwitch = 4
 };
 
+// Index of the column with the given name in the table schema
+inline size_t FindColumnIndex(const NYT::TTableSchema& schema, std::string_view name) {
+    const auto& columns = schema.Columns();
+
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i].Name() == name) {
+            return i;
+        }
+    }
+
+    ythrow yexception() << "Table has no column named " << name;
+}
+
+// Schema consisting of the given columns of the table in the order of the table schema
+inline NYT::TTableSchema ProjectTableSchema(const NYT::TTableSchema& schema, const std::vector<TString>& columns) {
+    for (const auto& name : columns) {
+        FindColumnIndex(schema, name);
+    }
+
+    NYT::TTableSchema res;
+    res.Strict(schema.Strict());
+
+    for (const auto& column : schema.Columns()) {
+        if (std::find(columns.begin(), columns.end(), column.Name()) != columns.end()) {
+            res.AddColumn(column);
+        }
+    }
+
+    return res;
+}
+
 struct TReadingContext {
     size_t TableIndex = 0;
     std::optional<size_t> RowIndex;
@@ -39,6 +77,36 @@ public:
     virtual bool IsValid() const = 0;
     virtual bool IsEndOfStream() const = 0;
 
+    // Reads up to maxCount rows starting from the current one and moves the reader past them.
+    // Row objects left in rows from the previous call are reused if nobody else references them.
+    // rows is resized to the number of read rows. If contexts isn't null, it is filled with reading
+    // context of each row
+    virtual size_t ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                            std::vector<TReadingContext>* contexts);
+
+    inline size_t ReadRows(std::vector<IRowPtr>& rows, size_t maxCount) {
+        return ReadRows(rows, maxCount, nullptr);
+    }
+
+    // Makes the reader skip rows not matching the filter without materializing them. Returns false
+    // if the reader can't evaluate the filter itself; rows are left unfiltered then. If the current
+    // row doesn't match, the reader moves to the next matching one
+    virtual bool PushDownFilter(const TRowFilter&) {
+        return false;
+    }
+
+    // Reader wrapped by this one if it's kept at the current row of the wrapper, so format-specific
+    // access to the row (e.g. TSkiffRowReader::ReadRawRow) can be mixed with IsValid() and Next()
+    // of the wrapper. Null for readers which don't wrap another one or read ahead of it
+    virtual IRowReader* GetUnderlyingReader() {
+        return nullptr;
+    }
+
+    // Reader producing column batches of the same rows natively, null if there is none
+    virtual IColumnBatchReader* GetColumnBatchReader() {
+        return nullptr;
+    }
+
     inline size_t GetTableIndex() const {
         return GetReadingContext().TableIndex;
     }
@@ -56,8 +124,48 @@ public:
     virtual enum Format Format() const = 0;
     virtual size_t GetTablesCount() const = 0;
     virtual const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const = 0;
+
+    inline TColumnHandle GetColumnHandle(size_t tableIndex, std::string_view name) const {
+        return TColumnHandle(FindColumnIndex(GetTableSchema(tableIndex), name));
+    }
 };
 
+inline size_t IRowReader::ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                                   std::vector<TReadingContext>* contexts) {
+    if (contexts) {
+        contexts->clear();
+    }
+
+    size_t count = 0;
+    for (; count < maxCount && IsValid(); ++count, Next()) {
+        if (count < rows.size()) {
+            rows[count] = ReadRow();
+        } else {
+            rows.push_back(ReadRow());
+        }
+
+        if (contexts) {
+            contexts->push_back(GetReadingContext());
+        }
+    }
+
+    rows.resize(count);
+    return count;
+}
+
+// Finds the reader of the given format under wrappers keeping it at their current row. Throws if
+// there is none, e.g. if rows are of another format or are decoded ahead by a pipelined reader
+template <typename TReader>
+TReader& GetFormatReader(IRowReader* reader) {
+    for (auto* current = reader; current; current = current->GetUnderlyingReader()) {
+        if (auto* res = dynamic_cast<TReader*>(current)) {
+            return *res;
+        }
+    }
+
+    ythrow yexception() << "Reader of the requested format isn't reachable through " << TypeName(*reader);
+}
+
 class IRowWriter {
 public:
     virtual ~IRowWriter() {}
@@ -66,10 +174,19 @@ public:
     virtual void WriteRow(IRowPtr&& row, size_t tableIndex) = 0;
     virtual void FinishTable(size_t tableIndex) = 0;
 
+    // Writes serialized row of the table as is. Supported only by formats having raw rows
+    virtual void WriteRawRow(std::string_view, size_t) {
+        ythrow yexception() << "Writing raw rows isn't supported by " << TypeName(*this);
+    }
+
     virtual enum Format Format() const = 0;
     virtual size_t GetTablesCount() const = 0;
     virtual const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const = 0;
     virtual IRowPtr CreateObjectForWrite(size_t tableIndex) const = 0;
+
+    inline TColumnHandle GetColumnHandle(size_t tableIndex, std::string_view name) const {
+        return TColumnHandle(FindColumnIndex(GetTableSchema(tableIndex), name));
+    }
 };
 
 }
\ No newline at end of file
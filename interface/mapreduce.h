@@ -7,6 +7,11 @@
 #include <yt/cpp/mapreduce/interface/format.h>
 
 #include "io.h"
+#include "statistics.h"
+
+namespace NYT {
+class IProxyOutput;
+}
 
 namespace DFormats {
 
@@ -16,15 +21,70 @@ struct MapReduceIOSchema {
     std::vector<size_t> InputSchemaIndexes;
     enum Format OutputFormat;
     std::vector<size_t> OutputSchemaIndexes;
+
+    // Columns read from each input table, in the order of InputSchemaIndexes. Empty (or missing) list
+    // means all columns. Rows of a projected table have only these columns in the order of table schema.
+    // Input paths of the operation must be projected the same way, see ProjectInputPath
+    std::vector<std::vector<TString>> InputColumns = {};
+};
+
+// Schemas of input tables as the job sees them, i.e. with projection applied
+std::vector<NYT::TTableSchema> GetInputSchemas(const MapReduceIOSchema& schema);
+
+// Adds column selector of the input table to its path, so YT sends only the projected columns
+NYT::TRichYPath ProjectInputPath(const MapReduceIOSchema& schema, size_t inputIndex, NYT::TRichYPath path);
+
+struct TJobOptions {
+    // Decode input and encode output in separate threads. DoImpl gets rows decoded beforehand
+    // and its output is written while it processes next rows
+    bool Pipelined = false;
+
+    // Number of rows passed between threads at once
+    size_t BatchSize = 1024;
+
+    // Number of batches which may wait for processing in each direction
+    size_t QueueSize = 4;
+
+    // Collect TJobStatistics while the job runs. They are passed to the sink set with
+    // SetStatisticsSink, or written to YT job statistics if there is no sink
+    bool CollectStatistics = false;
+
+    // Input rows not matching the filter aren't passed to DoImpl. Filtered columns must be present
+    // in all input tables. Readers able to do it skip rows without decoding them
+    TRowFilter InputFilter = {};
+
+    // Protobuf input rows are allocated on arenas which are reset in bulk once rows are consumed.
+    // Rows kept by the job beyond their batch hold the memory of the whole batch
+    bool ProtobufArena = false;
+
+    // Protobuf input rows are parsed into one message per table, reused for the next row once the job
+    // releases the row and views of its fields. Applies only to rows read one by one, where it takes
+    // precedence over ProtobufArena; pipelined jobs read rows in batches, which use arenas if enabled
+    bool ProtobufReuseRows = false;
+
+    // Protobuf input rows aren't parsed: fields are decoded from the input on access and strings
+    // view it. Rows are parsed into messages on modification. Takes precedence over ProtobufArena
+    // and ProtobufReuseRows
+    bool ProtobufLazyRows = false;
 };
 
 class TJob : public NYT::IRawJob {
 public:
     TJob() = default;
-    TJob(MapReduceIOSchema ioSchema);
+    TJob(MapReduceIOSchema ioSchema, TJobOptions options = {});
 
     void Do(const NYT::TRawJobContext& context) override;
 
+    // Runs the job over the given input and output instead of the ones of YT job.
+    // Do() calls it with job's streams, but it also lets to run the job locally
+    void Run(::TIntrusivePtr<NYT::TRawTableReader> input, THolder<NYT::IProxyOutput> output);
+
+    // Sink isn't serialized with the job, so it has to be set in the job's constructor to work in YT
+    void SetStatisticsSink(TJobStatisticsSink sink);
+
+    // Statistics of the last run, if they were collected
+    const TJobStatistics& GetStatistics() const;
+
     void Save(IOutputStream& stream) const override;
     void Load(IInputStream& stream) override;
 
@@ -33,9 +93,17 @@ public:
 
 protected:
     const MapReduceIOSchema& GetIOSchema() const;
+    const TJobOptions& GetOptions() const;
+
+private:
+    void RunImpl(IRowReader* reader, IRowWriter* writer);
 
 private:
     MapReduceIOSchema IOSchema_;
+    TJobOptions Options_;
+
+    TJobStatisticsSink StatisticsSink_;
+    TJobStatistics Statistics_;
 };
 
 std::pair<NYT::TFormat, NYT::TFormat> MakeIOFormats(const MapReduceIOSchema& schema,
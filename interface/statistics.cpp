@@ -0,0 +1,75 @@
+#include "statistics.h"
+
+#include <util/string/cast.h>
+
+namespace DFormats {
+
+namespace {
+
+std::atomic<TAllocationsCounter> AllocationsCounter = nullptr;
+
+std::atomic<size_t> ExitedSkiffSoftRebuildsCount = 0;
+std::atomic<size_t> ExitedSkiffHardRebuildsCount = 0;
+
+struct TThreadFormatCounters {
+    ~TThreadFormatCounters() {
+        ExitedSkiffSoftRebuildsCount.fetch_add(Counters.SkiffSoftRebuildsCount, std::memory_order_relaxed);
+        ExitedSkiffHardRebuildsCount.fetch_add(Counters.SkiffHardRebuildsCount, std::memory_order_relaxed);
+    }
+
+    TFormatCounters Counters;
+};
+
+thread_local TThreadFormatCounters ThreadFormatCounters;
+
+NYT::TNode TablesStatisticsToNode(const std::vector<TTableStatistics>& tables) {
+    auto res = NYT::TNode::CreateMap();
+    for (size_t i = 0; i < tables.size(); ++i) {
+        res[ToString(i)] = NYT::TNode()
+            ("rows", static_cast<i64>(tables[i].RowsCount))
+            ("bytes", static_cast<i64>(tables[i].BytesCount));
+    }
+
+    return res;
+}
+
+}
+
+// Values are int64, since YT job statistics accept no other numbers
+NYT::TNode JobStatisticsToNode(const TJobStatistics& statistics) {
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+
+    return NYT::TNode()
+        ("input", TablesStatisticsToNode(statistics.Input))
+        ("output", TablesStatisticsToNode(statistics.Output))
+        ("time", NYT::TNode()
+            ("decode", static_cast<i64>(duration_cast<milliseconds>(statistics.DecodeTime).count()))
+            ("do_impl", static_cast<i64>(duration_cast<milliseconds>(statistics.DoImplTime).count()))
+            ("encode", static_cast<i64>(duration_cast<milliseconds>(statistics.EncodeTime).count())))
+        ("allocations", static_cast<i64>(statistics.AllocationsCount))
+        ("skiff_rebuilds", NYT::TNode()
+            ("soft", static_cast<i64>(statistics.SkiffSoftRebuildsCount))
+            ("hard", static_cast<i64>(statistics.SkiffHardRebuildsCount)));
+}
+
+void SetAllocationsCounter(TAllocationsCounter counter) {
+    AllocationsCounter.store(counter);
+}
+
+TAllocationsCounter GetAllocationsCounter() {
+    return AllocationsCounter.load();
+}
+
+TFormatCounters& FormatCounters() {
+    return ThreadFormatCounters.Counters;
+}
+
+TFormatCounters TotalFormatCounters() {
+    auto res = FormatCounters();
+    res.SkiffSoftRebuildsCount += ExitedSkiffSoftRebuildsCount.load(std::memory_order_relaxed);
+    res.SkiffHardRebuildsCount += ExitedSkiffHardRebuildsCount.load(std::memory_order_relaxed);
+    return res;
+}
+
+}
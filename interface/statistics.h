@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include <library/cpp/yson/node/node.h>
+
+namespace DFormats {
+
+struct TTableStatistics {
+    size_t RowsCount = 0;
+    size_t BytesCount = 0;
+};
+
+// Counters collected by TJob while it runs
+struct TJobStatistics {
+    // Indexed by table index. Input bytes are attributed to the table of the row being read
+    // when they were consumed, so with read-ahead the split between tables is approximate
+    std::vector<TTableStatistics> Input;
+    std::vector<TTableStatistics> Output;
+
+    // Time spent in the reader, in DoImpl apart from the reader and the writer, and in the writer.
+    // In pipelined mode decode and encode are timed in their own threads, and DoImpl time includes waiting for them
+    std::chrono::nanoseconds DecodeTime{0};
+    std::chrono::nanoseconds DoImplTime{0};
+    std::chrono::nanoseconds EncodeTime{0};
+
+    // Set only if allocations counter is registered with SetAllocationsCounter
+    size_t AllocationsCount = 0;
+
+    // Rebuilds of modified Skiff objects done in place and the ones which serialized objects anew
+    size_t SkiffSoftRebuildsCount = 0;
+    size_t SkiffHardRebuildsCount = 0;
+};
+
+NYT::TNode JobStatisticsToNode(const TJobStatistics& statistics);
+
+using TJobStatisticsSink = std::function<void(const TJobStatistics&)>;
+
+// Function returning the number of allocations made by the process so far. The library can't count
+// allocations itself, so the program overriding operator new or using an allocator with statistics
+// may register it
+using TAllocationsCounter = size_t (*)();
+
+void SetAllocationsCounter(TAllocationsCounter counter);
+TAllocationsCounter GetAllocationsCounter();
+
+// Counters updated by format implementations
+struct TFormatCounters {
+    size_t SkiffSoftRebuildsCount = 0;
+    size_t SkiffHardRebuildsCount = 0;
+};
+
+// Counters of the calling thread. They are added to the process-wide totals when the thread exits,
+// so threads don't contend on updates
+TFormatCounters& FormatCounters();
+
+// Counters of the calling thread together with the ones of all exited threads
+TFormatCounters TotalFormatCounters();
+
+}
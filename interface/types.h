@@ -10,6 +10,7 @@
 #include <unordered_map>
 
 #include <util/generic/yexception.h>
+#include <util/system/yassert.h>
 
 namespace DFormats {
 
@@ -217,6 +218,25 @@ public:
     virtual size_t FieldsCount() const = 0;
 };
 
+// Column of a table resolved by name once with GetColumnHandle() of the table's reader or writer.
+// Access by handle is positional, so it doesn't cost a name lookup per call. The handle isn't checked
+// against the row: it must be used only with rows of the table it was resolved for
+class TColumnHandle {
+public:
+    inline size_t Index() const {
+        return Index_;
+    }
+
+private:
+    explicit TColumnHandle(size_t index) : Index_(index) { }
+
+    friend class IRowReader;
+    friend class IRowWriter;
+
+private:
+    size_t Index_;
+};
+
 class IBaseRow : virtual public IBaseStruct, virtual public IBaseTuple {
 public:
     virtual IRowPtr CopyRow() const = 0;
@@ -226,6 +246,18 @@ public:
     using IBaseStruct::SetValue;
     using IBaseTuple::SetValue;
 
+    template <typename T>
+    T GetValue(TColumnHandle column) const {
+        Y_ASSERT(column.Index() < FieldsCount());
+        return IBaseTuple::GetValue<T>(column.Index());
+    }
+
+    template <typename T>
+    void SetValue(TColumnHandle column, T&& data) {
+        Y_ASSERT(column.Index() < FieldsCount());
+        IBaseTuple::SetValue(column.Index(), std::forward<T>(data));
+    }
+
 private:
     IStructPtr CopyStruct() const override = 0;
     ITuplePtr CopyTuple() const override = 0;
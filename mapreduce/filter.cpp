@@ -0,0 +1,80 @@
+#include "filter.h"
+
+namespace DFormats {
+
+// TFilteringRowReader
+
+TFilteringRowReader::TFilteringRowReader(IRowReader* underlying, const TRowFilter& filter)
+  : Underlying_(underlying) {
+
+    Predicates_.reserve(Underlying_->GetTablesCount());
+    for (size_t i = 0; i < Underlying_->GetTablesCount(); ++i) {
+        Predicates_.push_back(ResolveFilter(filter, Underlying_->GetTableSchema(i)));
+    }
+
+    SkipRejected();
+}
+
+void TFilteringRowReader::SkipRejected() {
+    // Key switch before a rejected row is a key switch before the next accepted one,
+    // otherwise reducers would merge groups of the keys
+    bool afterKeySwitch = false;
+
+    // Some readers are invalidated by ReadRow(), so the row is kept until Next()
+    for (; Underlying_->IsValid(); Underlying_->Next()) {
+        Current_ = Underlying_->ReadRow();
+
+        if (MatchesRow(Predicates_[Underlying_->GetTableIndex()], *Current_)) {
+            ReadingContext_ = Underlying_->GetReadingContext();
+            if (afterKeySwitch) {
+                ReadingContext_.AfterKeySwitch = true;
+            }
+            return;
+        }
+
+        afterKeySwitch |= Underlying_->IsAfterKeySwitch();
+    }
+
+    Current_.reset();
+}
+
+IRowPtr TFilteringRowReader::ReadRow() {
+    Y_ENSURE(Current_, "Trying to read row from invalid reader");
+    return Current_;
+}
+
+void TFilteringRowReader::Next() {
+    Current_.reset();
+    Underlying_->Next();
+    SkipRejected();
+}
+
+bool TFilteringRowReader::IsValid() const {
+    return Current_ != nullptr;
+}
+
+bool TFilteringRowReader::IsEndOfStream() const {
+    return Underlying_->IsEndOfStream();
+}
+
+const TReadingContext& TFilteringRowReader::GetReadingContext() const {
+    return ReadingContext_;
+}
+
+enum Format TFilteringRowReader::Format() const {
+    return Underlying_->Format();
+}
+
+size_t TFilteringRowReader::GetTablesCount() const {
+    return Underlying_->GetTablesCount();
+}
+
+const NYT::TTableSchema& TFilteringRowReader::GetTableSchema(size_t tableIndex) const {
+    return Underlying_->GetTableSchema(tableIndex);
+}
+
+IRowReader* TFilteringRowReader::GetUnderlyingReader() {
+    return Underlying_;
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include <dformats/interface/io.h>
+#include <dformats/interface/filter.h>
+
+namespace DFormats {
+
+// Reader skipping rows not matching the filter. Used for readers which can't evaluate the filter
+// themselves, so every row is materialized to be checked
+class TFilteringRowReader : public IRowReader {
+public:
+    TFilteringRowReader(IRowReader* underlying, const TRowFilter& filter);
+
+    IRowPtr ReadRow() override;
+    void Next() override;
+    bool IsValid() const override;
+    bool IsEndOfStream() const override;
+
+    const TReadingContext& GetReadingContext() const override;
+    enum Format Format() const override;
+    size_t GetTablesCount() const override;
+    const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
+
+    // Column batches of the underlying reader aren't filtered, so only its rows are accessible
+    IRowReader* GetUnderlyingReader() override;
+
+private:
+    // Moves the underlying reader to the first matching row starting from the current one
+    void SkipRejected();
+
+private:
+    IRowReader* Underlying_;
+    std::vector<std::vector<TResolvedPredicate>> Predicates_;  // Indexed by table index
+    IRowPtr Current_;
+    TReadingContext ReadingContext_;  // Of the current row, with key switches of skipped rows
+};
+
+}
@@ -6,12 +6,17 @@
 #include <dformats/skiff/skiff_reader.h>
 #include <dformats/skiff/skiff_writer.h>
 #include <dformats/protobuf/protobuf_reader.h>
+#include <dformats/protobuf/protobuf_lazy_reader.h>
 #include <dformats/protobuf/protobuf_writer.h>
 #include <dformats/yson/yson_reader.h>
 #include <dformats/yson/yson_writer.h>
 #include <dformats/arrow/arrow_reader.h>
 #include <dformats/arrow/arrow_writer.h>
 
+#include "filter.h"
+#include "pipeline.h"
+#include "statistics.h"
+
 namespace DFormats {
 
 enum class Io : bool { Input, Output };
@@ -65,14 +70,38 @@ NYT::TFormat MakeFormat(enum Format format, const std::vector<NYT::TTableSchema>
     }
 }
 
+std::vector<NYT::TTableSchema> GetInputSchemas(const MapReduceIOSchema& schema) {
+    std::vector<NYT::TTableSchema> res;
+    res.reserve(schema.InputSchemaIndexes.size());
+
+    for (size_t i = 0; i < schema.InputSchemaIndexes.size(); ++i) {
+        const auto& tableSchema = schema.TableSchemas[schema.InputSchemaIndexes[i]];
+
+        if (i < schema.InputColumns.size() && !schema.InputColumns[i].empty()) {
+            res.push_back(ProjectTableSchema(tableSchema, schema.InputColumns[i]));
+        } else {
+            res.push_back(tableSchema);
+        }
+    }
+
+    return res;
+}
+
+NYT::TRichYPath ProjectInputPath(const MapReduceIOSchema& schema, size_t inputIndex, NYT::TRichYPath path) {
+    Y_ENSURE(inputIndex < schema.InputSchemaIndexes.size(), "Input index " << inputIndex << " is out of range");
+
+    if (inputIndex < schema.InputColumns.size() && !schema.InputColumns[inputIndex].empty()) {
+        const auto& columns = schema.InputColumns[inputIndex];
+        path.Columns(TVector<TString>(columns.begin(), columns.end()));
+    }
+
+    return path;
+}
+
 std::pair<NYT::TFormat, NYT::TFormat> MakeIOFormats(
     const MapReduceIOSchema& schema, ReadingOptions readingOptions) {
 
-    std::vector<NYT::TTableSchema> inputSchemas;
-    inputSchemas.reserve(schema.InputSchemaIndexes.size());
-    for (size_t i : schema.InputSchemaIndexes) {
-        inputSchemas.push_back(schema.TableSchemas[i]);
-    }
+    auto inputSchemas = GetInputSchemas(schema);
 
     std::vector<NYT::TTableSchema> outputSchemas;
     outputSchemas.reserve(schema.OutputSchemaIndexes.size());
@@ -90,7 +119,8 @@ TNode MapReduceIOSchemaToNode(const MapReduceIOSchema& ioSchema) {
         ("InputFormat", ioSchema.InputFormat)
         ("InputSchemaIndexes", TNode::CreateList())
         ("OutputFormat", ioSchema.OutputFormat)
-        ("OutputSchemaIndexes", TNode::CreateList());
+        ("OutputSchemaIndexes", TNode::CreateList())
+        ("InputColumns", TNode::CreateList());
 
     for (const auto& tableSchema : ioSchema.TableSchemas) {
         res["TableSchemas"].Add(tableSchema.ToNode());
@@ -101,6 +131,12 @@ TNode MapReduceIOSchemaToNode(const MapReduceIOSchema& ioSchema) {
     for (auto ind : ioSchema.OutputSchemaIndexes) {
         res["OutputSchemaIndexes"].Add(ind);
     }
+    for (const auto& columns : ioSchema.InputColumns) {
+        auto& columnsNode = res["InputColumns"].Add(TNode::CreateList()).AsList().back();
+        for (const auto& column : columns) {
+            columnsNode.Add(column);
+        }
+    }
 
     return std::move(res);
 }
@@ -121,41 +157,118 @@ MapReduceIOSchema MapReduceIOSchemaFromNode(const TNode& node) {
     for (const auto& ind : node["OutputSchemaIndexes"].AsList()) {
         res.OutputSchemaIndexes.push_back(ind.AsUint64());
     }
+    for (const auto& columnsNode : node["InputColumns"].AsList()) {
+        auto& columns = res.InputColumns.emplace_back();
+        for (const auto& column : columnsNode.AsList()) {
+            columns.push_back(column.AsString());
+        }
+    }
 
     return std::move(res);
 }
 
-TJob::TJob(MapReduceIOSchema ioSchema) : IOSchema_(std::move(ioSchema)) { }
+TNode JobOptionsToNode(const TJobOptions& options) {
+    return TNode()
+        ("Pipelined", options.Pipelined)
+        ("BatchSize", options.BatchSize)
+        ("QueueSize", options.QueueSize)
+        ("CollectStatistics", options.CollectStatistics)
+        ("InputFilter", RowFilterToNode(options.InputFilter))
+        ("ProtobufArena", options.ProtobufArena)
+        ("ProtobufReuseRows", options.ProtobufReuseRows)
+        ("ProtobufLazyRows", options.ProtobufLazyRows);
+}
+
+TJobOptions JobOptionsFromNode(const TNode& node) {
+    TJobOptions res;
+
+    res.Pipelined = node["Pipelined"].AsBool();
+    res.BatchSize = node["BatchSize"].AsUint64();
+    res.QueueSize = node["QueueSize"].AsUint64();
+    res.CollectStatistics = node["CollectStatistics"].AsBool();
+    res.InputFilter = RowFilterFromNode(node["InputFilter"]);
+    res.ProtobufArena = node["ProtobufArena"].AsBool();
+    res.ProtobufReuseRows = node["ProtobufReuseRows"].AsBool();
+    res.ProtobufLazyRows = node["ProtobufLazyRows"].AsBool();
+
+    return res;
+}
+
+TJob::TJob(MapReduceIOSchema ioSchema, TJobOptions options)
+  : IOSchema_(std::move(ioSchema)), Options_(std::move(options)) { }
 
 void TJob::Do(const TRawJobContext& context) {
+    Run(MakeIntrusive<NYT::TJobReader>(context.GetInputFile()),
+        MakeHolder<NYT::TJobWriter>(context.GetOutputFileList()));
+
+    if (Options_.CollectStatistics && !StatisticsSink_) {
+        NYT::WriteCustomStatistics(JobStatisticsToNode(Statistics_));
+    }
+}
+
+void TJob::Run(::TIntrusivePtr<NYT::TRawTableReader> rawReader, THolder<NYT::IProxyOutput> rawWriter) {
     std::unique_ptr<IRowReader> reader;
     std::unique_ptr<IRowWriter> writer;
 
-    auto rawReader = MakeIntrusive<NYT::TJobReader>(context.GetInputFile());
-    auto rawWriter = MakeHolder<NYT::TJobWriter>(context.GetOutputFileList());
-
-    std::vector<NYT::TTableSchema> inputSchemas;
-    inputSchemas.reserve(IOSchema_.InputSchemaIndexes.size());
-    for (size_t i : IOSchema_.InputSchemaIndexes) {
-        inputSchemas.push_back(IOSchema_.TableSchemas[i]);
+    Statistics_ = {};
+    TCountingTableReader* countingReader = nullptr;
+    const auto allocationsCounter = GetAllocationsCounter();
+    const auto allocationsBefore = allocationsCounter ? allocationsCounter() : 0;
+    // Pipelined writer rebuilds rows in its own thread, whose counters are totaled when it exits
+    const auto countersBefore = TotalFormatCounters();
+
+    if (Options_.CollectStatistics) {
+        auto input = MakeIntrusive<TCountingTableReader>(std::move(rawReader));
+        countingReader = input.Get();
+        rawReader = std::move(input);
+        rawWriter = MakeHolder<TCountingProxyOutput>(std::move(rawWriter), Statistics_.Output);
     }
+
+    auto inputSchemas = GetInputSchemas(IOSchema_);
     std::vector<NYT::TTableSchema> outputSchemas;
     outputSchemas.reserve(IOSchema_.OutputSchemaIndexes.size());
     for (size_t i : IOSchema_.OutputSchemaIndexes) {
         outputSchemas.push_back(IOSchema_.TableSchemas[i]);
     }
 
-    std::shared_ptr<TProtobufRowFactory> factory = 
-        IOSchema_.InputFormat == Format::Protobuf || IOSchema_.OutputFormat == Format::Protobuf
-        ? std::make_shared<TProtobufRowFactory>(IOSchema_.TableSchemas) : nullptr;
+    // Projected input schemas get messages of their own, since the same table schema may be used for output
+    std::shared_ptr<TProtobufRowFactory> factory;
+    auto protobufInputIndexes = IOSchema_.InputSchemaIndexes;
+    if (IOSchema_.InputFormat == Format::Protobuf || IOSchema_.OutputFormat == Format::Protobuf) {
+        auto factorySchemas = IOSchema_.TableSchemas;
+
+        for (size_t i = 0; i < inputSchemas.size(); ++i) {
+            if (i < IOSchema_.InputColumns.size() && !IOSchema_.InputColumns[i].empty()) {
+                protobufInputIndexes[i] = factorySchemas.size();
+                factorySchemas.push_back(inputSchemas[i]);
+            }
+        }
+
+        factory = std::make_shared<TProtobufRowFactory>(std::move(factorySchemas));
+    }
+
+    // Readers decode the first row when they are created
+    std::optional<TTimeGuard> readerCreationGuard;
+    if (Options_.CollectStatistics) {
+        readerCreationGuard.emplace(Statistics_.DecodeTime);
+    }
 
     switch (IOSchema_.InputFormat) {
     case Format::Skiff:
         reader.reset(new TSkiffRowReader(std::move(rawReader), std::move(inputSchemas)));
         break;
-    case Format::Protobuf:
-        reader.reset(new TProtobufRowReader(std::move(rawReader), factory, IOSchema_.InputSchemaIndexes));
+    case Format::Protobuf: {
+        if (Options_.ProtobufLazyRows) {
+            reader.reset(new TProtobufLazyRowReader(std::move(rawReader), factory, protobufInputIndexes));
+            break;
+        }
+
+        TProtobufReaderOptions readerOptions;
+        readerOptions.UseArena = Options_.ProtobufArena;
+        readerOptions.ReuseRows = Options_.ProtobufReuseRows;
+        reader.reset(new TProtobufRowReader(std::move(rawReader), factory, protobufInputIndexes, readerOptions));
         break;
+    }
     case Format::Yson:
         reader.reset(new TYsonRowReader(std::move(rawReader), std::move(inputSchemas)));
         break;
@@ -164,6 +277,14 @@ void TJob::Do(const TRawJobContext& context) {
         break;
     }
 
+    std::unique_ptr<TFilteringRowReader> filteringReader;
+    if (!Options_.InputFilter.Empty() && !reader->PushDownFilter(Options_.InputFilter)) {
+        filteringReader = std::make_unique<TFilteringRowReader>(reader.get(), Options_.InputFilter);
+    }
+    IRowReader* inputReader = filteringReader ? filteringReader.get() : reader.get();
+
+    readerCreationGuard.reset();
+
     switch (IOSchema_.OutputFormat) {
     case Format::Skiff:
         writer.reset(new TSkiffRowWriter(std::move(rawWriter), std::move(outputSchemas)));
@@ -179,21 +300,77 @@ void TJob::Do(const TRawJobContext& context) {
         break;
     }
 
-    DoImpl(reader.get(), writer.get());
+    if (!Options_.CollectStatistics) {
+        RunImpl(inputReader, writer.get());
+        return;
+    }
+
+    TInstrumentedRowReader instrumentedReader(inputReader, countingReader, Statistics_);
+    TInstrumentedRowWriter instrumentedWriter(writer.get(), Statistics_);
+
+    const auto ioTimeBefore = Statistics_.DecodeTime + Statistics_.EncodeTime;
+    RunImpl(&instrumentedReader, &instrumentedWriter);
+
+    if (!Options_.Pipelined) {
+        Statistics_.DoImplTime -= Statistics_.DecodeTime + Statistics_.EncodeTime - ioTimeBefore;
+    }
+    if (allocationsCounter) {
+        Statistics_.AllocationsCount = allocationsCounter() - allocationsBefore;
+    }
+    const auto countersAfter = TotalFormatCounters();
+    Statistics_.SkiffSoftRebuildsCount = countersAfter.SkiffSoftRebuildsCount - countersBefore.SkiffSoftRebuildsCount;
+    Statistics_.SkiffHardRebuildsCount = countersAfter.SkiffHardRebuildsCount - countersBefore.SkiffHardRebuildsCount;
+
+    if (StatisticsSink_) {
+        StatisticsSink_(Statistics_);
+    }
+}
+
+void TJob::RunImpl(IRowReader* reader, IRowWriter* writer) {
+    TTimeGuard guard(Statistics_.DoImplTime);
+
+    if (!Options_.Pipelined) {
+        DoImpl(reader, writer);
+        return;
+    }
+
+    // Reader is destroyed first, so its thread is stopped even if DoImpl has thrown
+    TPipelinedRowWriter pipelinedWriter(writer, Options_.BatchSize, Options_.QueueSize);
+    {
+        TPipelinedRowReader pipelinedReader(reader, Options_.BatchSize, Options_.QueueSize);
+        DoImpl(&pipelinedReader, &pipelinedWriter);
+    }
+    pipelinedWriter.Finish();
+}
+
+void TJob::SetStatisticsSink(TJobStatisticsSink sink) {
+    StatisticsSink_ = std::move(sink);
+}
+
+const TJobStatistics& TJob::GetStatistics() const {
+    return Statistics_;
 }
 
 void TJob::Save(IOutputStream& stream) const {
     MapReduceIOSchemaToNode(IOSchema_).Save(&stream);
+    JobOptionsToNode(Options_).Save(&stream);
 }
 
 void TJob::Load(IInputStream& stream) {
     TNode node;
     node.Load(&stream);
     IOSchema_ = MapReduceIOSchemaFromNode(node);
+
+    node.Load(&stream);
+    Options_ = JobOptionsFromNode(node);
 }
 
 const MapReduceIOSchema& TJob::GetIOSchema() const {
     return IOSchema_;
 }
 
+const TJobOptions& TJob::GetOptions() const {
+    return Options_;
+}
+
 }
\ No newline at end of file
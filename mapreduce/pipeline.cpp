@@ -0,0 +1,223 @@
+#include "pipeline.h"
+
+#include <util/generic/yexception.h>
+
+namespace DFormats {
+
+// TPipelinedRowReader
+
+TPipelinedRowReader::TPipelinedRowReader(IRowReader* underlying, size_t batchSize, size_t queueSize)
+  : Underlying_(underlying)
+  , BatchSize_(batchSize)
+  , Decoded_(queueSize)
+  , Consumed_(queueSize + 1) {
+
+    Y_ENSURE(BatchSize_ > 0 && queueSize > 0, "Batch and queue sizes must be positive");
+
+    Decoder_ = std::thread([this] { DecodeLoop(); });
+
+    try {
+        FetchBatch();
+    } catch (...) {
+        Stop();
+        throw;
+    }
+}
+
+TPipelinedRowReader::~TPipelinedRowReader() {
+    Stop();
+}
+
+void TPipelinedRowReader::Stop() {
+    // Decoding thread may be blocked on the full queue if rows weren't read till the end
+    Decoded_.Close();
+    Consumed_.Close();
+
+    if (Decoder_.joinable()) {
+        Decoder_.join();
+    }
+}
+
+void TPipelinedRowReader::DecodeLoop() {
+    try {
+        while (true) {
+            auto batch = Consumed_.TryPop().value_or(TBatch{});
+
+            if (!Underlying_->ReadRows(batch.Rows, BatchSize_, &batch.Contexts) ||
+                !Decoded_.Push(std::move(batch))) {
+                break;
+            }
+        }
+    } catch (...) {
+        Error_ = std::current_exception();
+    }
+
+    Decoded_.Close();
+}
+
+void TPipelinedRowReader::FetchBatch() {
+    Consumed_.TryPush(std::move(Current_));
+    Current_ = {};
+    Position_ = 0;
+
+    if (auto batch = Decoded_.Pop()) {
+        Current_ = std::move(*batch);
+    } else if (Error_) {
+        std::rethrow_exception(Error_);
+    }
+}
+
+IRowPtr TPipelinedRowReader::ReadRow() {
+    Y_ENSURE(IsValid(), "Trying to read row from empty batch");
+    return Current_.Rows[Position_];
+}
+
+void TPipelinedRowReader::Next() {
+    if (++Position_ >= Current_.Rows.size()) {
+        FetchBatch();
+    }
+}
+
+bool TPipelinedRowReader::IsValid() const {
+    return Position_ < Current_.Rows.size();
+}
+
+bool TPipelinedRowReader::IsEndOfStream() const {
+    return !IsValid();
+}
+
+const TReadingContext& TPipelinedRowReader::GetReadingContext() const {
+    return Current_.Contexts[Position_];
+}
+
+enum Format TPipelinedRowReader::Format() const {
+    return Underlying_->Format();
+}
+
+size_t TPipelinedRowReader::GetTablesCount() const {
+    return Underlying_->GetTablesCount();
+}
+
+const NYT::TTableSchema& TPipelinedRowReader::GetTableSchema(size_t tableIndex) const {
+    return Underlying_->GetTableSchema(tableIndex);
+}
+
+// TPipelinedRowWriter
+
+TPipelinedRowWriter::TPipelinedRowWriter(IRowWriter* underlying, size_t batchSize, size_t queueSize)
+  : Underlying_(underlying)
+  , BatchSize_(batchSize)
+  , Pending_(queueSize)
+  , Written_(queueSize + 1) {
+
+    Y_ENSURE(BatchSize_ > 0 && queueSize > 0, "Batch and queue sizes must be positive");
+
+    Current_.reserve(BatchSize_);
+    Encoder_ = std::thread([this] { EncodeLoop(); });
+}
+
+TPipelinedRowWriter::~TPipelinedRowWriter() {
+    Pending_.Close();
+    Written_.Close();
+
+    if (Encoder_.joinable()) {
+        Encoder_.join();
+    }
+}
+
+void TPipelinedRowWriter::EncodeLoop() {
+    try {
+        while (auto batch = Pending_.Pop()) {
+            for (auto& command : *batch) {
+                if (command.Row) {
+                    Underlying_->WriteRow(std::move(command.Row), command.TableIndex);
+                } else if (command.RawRow) {
+                    Underlying_->WriteRawRow(*command.RawRow, command.TableIndex);
+                } else {
+                    Underlying_->FinishTable(command.TableIndex);
+                }
+            }
+
+            batch->clear();
+            Written_.TryPush(std::move(*batch));
+        }
+    } catch (...) {
+        Error_ = std::current_exception();
+        Pending_.Close();
+    }
+}
+
+void TPipelinedRowWriter::Flush() {
+    if (Current_.empty()) {
+        return;
+    }
+
+    if (!Pending_.Push(std::move(Current_))) {
+        // Queue is closed only by the failed encoding thread here
+        Finish();
+    }
+
+    Current_ = Written_.TryPop().value_or(TBatch{});
+    Current_.reserve(BatchSize_);
+}
+
+void TPipelinedRowWriter::WriteRow(const IRowConstPtr& row, size_t tableIndex) {
+    // Caller may modify the row after the call, while it's not written yet
+    WriteRow(row->CopyRow(), tableIndex);
+}
+
+void TPipelinedRowWriter::WriteRow(IRowPtr&& row, size_t tableIndex) {
+    Current_.push_back({std::move(row), tableIndex});
+
+    if (Current_.size() >= BatchSize_) {
+        Flush();
+    }
+}
+
+void TPipelinedRowWriter::WriteRawRow(std::string_view data, size_t tableIndex) {
+    // Data usually points to the input, which is reused before the row is written
+    Current_.push_back({nullptr, tableIndex, std::string(data)});
+
+    if (Current_.size() >= BatchSize_) {
+        Flush();
+    }
+}
+
+void TPipelinedRowWriter::FinishTable(size_t tableIndex) {
+    Current_.push_back({nullptr, tableIndex});
+    Flush();
+}
+
+void TPipelinedRowWriter::Finish() {
+    if (!Current_.empty() && Pending_.Push(std::move(Current_))) {
+        Current_.clear();
+    }
+
+    Pending_.Close();
+    if (Encoder_.joinable()) {
+        Encoder_.join();
+    }
+
+    if (Error_) {
+        std::rethrow_exception(Error_);
+    }
+}
+
+enum Format TPipelinedRowWriter::Format() const {
+    return Underlying_->Format();
+}
+
+size_t TPipelinedRowWriter::GetTablesCount() const {
+    return Underlying_->GetTablesCount();
+}
+
+const NYT::TTableSchema& TPipelinedRowWriter::GetTableSchema(size_t tableIndex) const {
+    return Underlying_->GetTableSchema(tableIndex);
+}
+
+IRowPtr TPipelinedRowWriter::CreateObjectForWrite(size_t tableIndex) const {
+    // Writers' row pools are synchronized, since rows are returned to them by the encoding thread
+    return Underlying_->CreateObjectForWrite(tableIndex);
+}
+
+}
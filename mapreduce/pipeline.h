@@ -0,0 +1,180 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dformats/interface/io.h>
+
+namespace DFormats {
+
+// Queue passing items between threads. Producer is blocked while the queue is full,
+// consumer is blocked while it's empty. Closed queue accepts no more items, but keeps the ones it has
+template <typename T>
+class TBoundedQueue {
+public:
+    explicit TBoundedQueue(size_t capacity) : Capacity_(capacity) { }
+
+    // Returns false if the queue was closed
+    bool Push(T&& item) {
+        std::unique_lock lock(Mutex_);
+        NotFull_.wait(lock, [this] { return Closed_ || Items_.size() < Capacity_; });
+
+        if (Closed_) {
+            return false;
+        }
+
+        Items_.push_back(std::move(item));
+        NotEmpty_.notify_one();
+        return true;
+    }
+
+    bool TryPush(T&& item) {
+        std::lock_guard lock(Mutex_);
+
+        if (Closed_ || Items_.size() >= Capacity_) {
+            return false;
+        }
+
+        Items_.push_back(std::move(item));
+        NotEmpty_.notify_one();
+        return true;
+    }
+
+    // Returns nullopt if the queue was closed and has no items left
+    std::optional<T> Pop() {
+        std::unique_lock lock(Mutex_);
+        NotEmpty_.wait(lock, [this] { return Closed_ || !Items_.empty(); });
+
+        return PopLocked();
+    }
+
+    std::optional<T> TryPop() {
+        std::lock_guard lock(Mutex_);
+        return PopLocked();
+    }
+
+    void Close() {
+        std::lock_guard lock(Mutex_);
+        Closed_ = true;
+        NotEmpty_.notify_all();
+        NotFull_.notify_all();
+    }
+
+private:
+    std::optional<T> PopLocked() {
+        if (Items_.empty()) {
+            return std::nullopt;
+        }
+
+        std::optional<T> res(std::move(Items_.front()));
+        Items_.pop_front();
+        NotFull_.notify_one();
+        return res;
+    }
+
+private:
+    const size_t Capacity_;
+    std::deque<T> Items_;
+    bool Closed_ = false;
+
+    std::mutex Mutex_;
+    std::condition_variable NotEmpty_;
+    std::condition_variable NotFull_;
+};
+
+// Reader decoding rows of the underlying one in a separate thread. Rows are read with
+// IRowReader::ReadRows in batches, so row objects are reused once the consumer releases them.
+// The underlying reader is ahead of the consumer, so neither it nor its native column batches
+// are exposed: GetFormatReader() throws and MakeColumnBatchReader() transposes the rows
+class TPipelinedRowReader : public IRowReader {
+public:
+    TPipelinedRowReader(IRowReader* underlying, size_t batchSize, size_t queueSize);
+    ~TPipelinedRowReader() override;
+
+    IRowPtr ReadRow() override;
+    void Next() override;
+    bool IsValid() const override;
+    bool IsEndOfStream() const override;
+
+    const TReadingContext& GetReadingContext() const override;
+    enum Format Format() const override;
+    size_t GetTablesCount() const override;
+    const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
+
+private:
+    struct TBatch {
+        std::vector<IRowPtr> Rows;
+        std::vector<TReadingContext> Contexts;
+    };
+
+    void DecodeLoop();
+    void FetchBatch();
+    void Stop();
+
+private:
+    IRowReader* Underlying_;
+    const size_t BatchSize_;
+
+    TBoundedQueue<TBatch> Decoded_;
+    TBoundedQueue<TBatch> Consumed_;  // Batches returned to the decoding thread for reuse
+    std::exception_ptr Error_;
+
+    TBatch Current_;
+    size_t Position_ = 0;
+
+    std::thread Decoder_;
+};
+
+// Writer encoding rows with the underlying one in a separate thread. Rows passed by rvalue
+// are owned by the writer since then, rows passed by const reference and raw rows are copied
+class TPipelinedRowWriter : public IRowWriter {
+public:
+    TPipelinedRowWriter(IRowWriter* underlying, size_t batchSize, size_t queueSize);
+    ~TPipelinedRowWriter() override;
+
+    void WriteRow(const IRowConstPtr& row, size_t tableIndex) override;
+    void WriteRow(IRowPtr&& row, size_t tableIndex) override;
+    void FinishTable(size_t tableIndex) override;
+    void WriteRawRow(std::string_view data, size_t tableIndex) override;
+
+    // Waits until all rows are written. Rethrows the error occurred in the encoding thread
+    void Finish();
+
+    enum Format Format() const override;
+    size_t GetTablesCount() const override;
+    const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
+    IRowPtr CreateObjectForWrite(size_t tableIndex) const override;
+
+private:
+    // Command with neither row nor raw row finishes the table
+    struct TCommand {
+        IRowPtr Row;
+        size_t TableIndex;
+        std::optional<std::string> RawRow;
+    };
+
+    using TBatch = std::vector<TCommand>;
+
+    void EncodeLoop();
+    void Flush();
+
+private:
+    IRowWriter* Underlying_;
+    const size_t BatchSize_;
+
+    TBoundedQueue<TBatch> Pending_;
+    TBoundedQueue<TBatch> Written_;  // Batches returned to the writing thread for reuse
+    std::exception_ptr Error_;
+
+    TBatch Current_;
+
+    std::thread Encoder_;
+};
+
+}
@@ -0,0 +1,256 @@
+#include "statistics.h"
+
+namespace DFormats {
+
+namespace {
+
+TTableStatistics& GetTable(std::vector<TTableStatistics>& tables, size_t tableIndex) {
+    if (tableIndex >= tables.size()) {
+        tables.resize(tableIndex + 1);
+    }
+
+    return tables[tableIndex];
+}
+
+}
+
+// TCountingTableReader
+
+TCountingTableReader::TCountingTableReader(::TIntrusivePtr<NYT::TRawTableReader> underlying)
+  : Underlying_(std::move(underlying)) { }
+
+bool TCountingTableReader::Retry(const TMaybe<ui32>& rangeIndex, const TMaybe<ui64>& rowIndex,
+                                 const std::exception_ptr& error) {
+    return Underlying_->Retry(rangeIndex, rowIndex, error);
+}
+
+void TCountingTableReader::ResetRetries() {
+    Underlying_->ResetRetries();
+}
+
+bool TCountingTableReader::HasRangeIndices() const {
+    return Underlying_->HasRangeIndices();
+}
+
+size_t TCountingTableReader::DoRead(void* buf, size_t len) {
+    len = Underlying_->Read(buf, len);
+    BytesCount_ += len;
+
+    return len;
+}
+
+// TCountingProxyOutput
+
+class TCountingProxyOutput::TCountingOutput : public IOutputStream {
+public:
+    TCountingOutput(IOutputStream* underlying, size_t& bytesCount)
+      : Underlying_(underlying), BytesCount_(bytesCount) { }
+
+protected:
+    void DoWrite(const void* buf, size_t len) override {
+        Underlying_->Write(buf, len);
+        BytesCount_ += len;
+    }
+
+    void DoWriteV(const TPart* parts, size_t count) override {
+        Underlying_->Write(parts, count);
+        for (size_t i = 0; i < count; ++i) {
+            BytesCount_ += parts[i].len;
+        }
+    }
+
+    void DoFlush() override {
+        Underlying_->Flush();
+    }
+
+    void DoFinish() override {
+        Underlying_->Finish();
+    }
+
+private:
+    IOutputStream* Underlying_;
+    size_t& BytesCount_;
+};
+
+TCountingProxyOutput::TCountingProxyOutput(THolder<NYT::IProxyOutput> underlying,
+                                           std::vector<TTableStatistics>& tables)
+  : Underlying_(std::move(underlying)) {
+
+    // Streams keep references to the elements, so the tables mustn't be resized since then
+    const auto streamCount = Underlying_->GetStreamCount();
+    if (tables.size() < streamCount) {
+        tables.resize(streamCount);
+    }
+
+    Streams_.reserve(streamCount);
+    for (size_t i = 0; i < streamCount; ++i) {
+        Streams_.push_back(std::make_unique<TCountingOutput>(Underlying_->GetStream(i), tables[i].BytesCount));
+    }
+}
+
+size_t TCountingProxyOutput::GetStreamCount() const {
+    return Streams_.size();
+}
+
+IOutputStream* TCountingProxyOutput::GetStream(size_t tableIndex) const {
+    return Streams_.at(tableIndex).get();
+}
+
+void TCountingProxyOutput::OnRowFinished(size_t tableIndex) {
+    Underlying_->OnRowFinished(tableIndex);
+}
+
+// TInstrumentedRowReader
+
+TInstrumentedRowReader::TInstrumentedRowReader(IRowReader* underlying, const TCountingTableReader* input,
+                                               TJobStatistics& statistics)
+  : Underlying_(underlying), Input_(input), Statistics_(statistics) {
+
+    // Bytes read by the underlying reader while it was created belong to the first row
+    if (Underlying_->IsValid()) {
+        CountBytes(Underlying_->GetTableIndex());
+    }
+}
+
+IRowPtr TInstrumentedRowReader::ReadRow() {
+    TTimeGuard guard(Statistics_.DecodeTime);
+    return Underlying_->ReadRow();
+}
+
+size_t TInstrumentedRowReader::ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                                        std::vector<TReadingContext>* contexts) {
+    if (!contexts) {
+        contexts = &Contexts_;
+    }
+
+    size_t count;
+    {
+        TTimeGuard guard(Statistics_.DecodeTime);
+        count = Underlying_->ReadRows(rows, maxCount, contexts);
+    }
+
+    for (const auto& context : *contexts) {
+        ++GetTable(Statistics_.Input, context.TableIndex).RowsCount;
+    }
+    if (count) {
+        CountBytes(contexts->back().TableIndex);
+    }
+
+    return count;
+}
+
+IColumnBatchPtr TInstrumentedRowReader::ReadBatch(size_t maxRows) {
+    auto* batchReader = Underlying_->GetColumnBatchReader();
+    Y_ENSURE(batchReader, "Underlying reader doesn't read column batches");
+
+    IColumnBatchPtr batch;
+    {
+        TTimeGuard guard(Statistics_.DecodeTime);
+        batch = batchReader->ReadBatch(maxRows);
+    }
+
+    if (batch) {
+        GetTable(Statistics_.Input, batch->GetTableIndex()).RowsCount += batch->RowsCount();
+        CountBytes(batch->GetTableIndex());
+    }
+
+    return batch;
+}
+
+IColumnBatchReader* TInstrumentedRowReader::GetColumnBatchReader() {
+    return Underlying_->GetColumnBatchReader() ? this : nullptr;
+}
+
+IRowReader* TInstrumentedRowReader::GetUnderlyingReader() {
+    return Underlying_;
+}
+
+void TInstrumentedRowReader::Next() {
+    const auto tableIndex = Underlying_->GetTableIndex();
+    ++GetTable(Statistics_.Input, tableIndex).RowsCount;
+
+    {
+        TTimeGuard guard(Statistics_.DecodeTime);
+        Underlying_->Next();
+    }
+
+    CountBytes(tableIndex);
+}
+
+void TInstrumentedRowReader::CountBytes(size_t tableIndex) {
+    GetTable(Statistics_.Input, tableIndex).BytesCount += Input_->BytesCount() - CountedBytes_;
+    CountedBytes_ = Input_->BytesCount();
+}
+
+bool TInstrumentedRowReader::IsValid() const {
+    return Underlying_->IsValid();
+}
+
+bool TInstrumentedRowReader::IsEndOfStream() const {
+    return Underlying_->IsEndOfStream();
+}
+
+const TReadingContext& TInstrumentedRowReader::GetReadingContext() const {
+    return Underlying_->GetReadingContext();
+}
+
+Format TInstrumentedRowReader::Format() const {
+    return Underlying_->Format();
+}
+
+size_t TInstrumentedRowReader::GetTablesCount() const {
+    return Underlying_->GetTablesCount();
+}
+
+const NYT::TTableSchema& TInstrumentedRowReader::GetTableSchema(size_t tableIndex) const {
+    return Underlying_->GetTableSchema(tableIndex);
+}
+
+// TInstrumentedRowWriter
+
+TInstrumentedRowWriter::TInstrumentedRowWriter(IRowWriter* underlying, TJobStatistics& statistics)
+  : Underlying_(underlying), Statistics_(statistics) { }
+
+void TInstrumentedRowWriter::WriteRow(const IRowConstPtr& row, size_t tableIndex) {
+    ++GetTable(Statistics_.Output, tableIndex).RowsCount;
+
+    TTimeGuard guard(Statistics_.EncodeTime);
+    Underlying_->WriteRow(row, tableIndex);
+}
+
+void TInstrumentedRowWriter::WriteRow(IRowPtr&& row, size_t tableIndex) {
+    ++GetTable(Statistics_.Output, tableIndex).RowsCount;
+
+    TTimeGuard guard(Statistics_.EncodeTime);
+    Underlying_->WriteRow(std::move(row), tableIndex);
+}
+
+void TInstrumentedRowWriter::FinishTable(size_t tableIndex) {
+    TTimeGuard guard(Statistics_.EncodeTime);
+    Underlying_->FinishTable(tableIndex);
+}
+
+void TInstrumentedRowWriter::WriteRawRow(std::string_view data, size_t tableIndex) {
+    ++GetTable(Statistics_.Output, tableIndex).RowsCount;
+
+    TTimeGuard guard(Statistics_.EncodeTime);
+    Underlying_->WriteRawRow(data, tableIndex);
+}
+
+Format TInstrumentedRowWriter::Format() const {
+    return Underlying_->Format();
+}
+
+size_t TInstrumentedRowWriter::GetTablesCount() const {
+    return Underlying_->GetTablesCount();
+}
+
+const NYT::TTableSchema& TInstrumentedRowWriter::GetTableSchema(size_t tableIndex) const {
+    return Underlying_->GetTableSchema(tableIndex);
+}
+
+IRowPtr TInstrumentedRowWriter::CreateObjectForWrite(size_t tableIndex) const {
+    return Underlying_->CreateObjectForWrite(tableIndex);
+}
+
+}
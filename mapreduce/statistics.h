@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <yt/cpp/mapreduce/interface/io.h>
+#include <yt/cpp/mapreduce/io/proxy_output.h>
+
+#include <dformats/interface/column_batch.h>
+#include <dformats/interface/io.h>
+#include <dformats/interface/statistics.h>
+
+namespace DFormats {
+
+// Raw input counting the bytes read from the underlying one
+class TCountingTableReader : public NYT::TRawTableReader {
+public:
+    explicit TCountingTableReader(::TIntrusivePtr<NYT::TRawTableReader> underlying);
+
+    bool Retry(const TMaybe<ui32>& rangeIndex, const TMaybe<ui64>& rowIndex,
+               const std::exception_ptr& error) override;
+    void ResetRetries() override;
+    bool HasRangeIndices() const override;
+
+    inline size_t BytesCount() const {
+        return BytesCount_;
+    }
+
+protected:
+    size_t DoRead(void* buf, size_t len) override;
+
+private:
+    ::TIntrusivePtr<NYT::TRawTableReader> Underlying_;
+    size_t BytesCount_ = 0;
+};
+
+// Raw output adding the bytes written to each table to the statistics
+class TCountingProxyOutput : public NYT::IProxyOutput {
+public:
+    TCountingProxyOutput(THolder<NYT::IProxyOutput> underlying, std::vector<TTableStatistics>& tables);
+
+    size_t GetStreamCount() const override;
+    IOutputStream* GetStream(size_t tableIndex) const override;
+    void OnRowFinished(size_t tableIndex) override;
+
+private:
+    class TCountingOutput;
+
+    THolder<NYT::IProxyOutput> Underlying_;
+    std::vector<std::unique_ptr<TCountingOutput>> Streams_;
+};
+
+// Reader counting read rows and time spent in the underlying one. Column batches are counted
+// too if the underlying reader produces them natively
+class TInstrumentedRowReader : public IRowReader, public IColumnBatchReader {
+public:
+    TInstrumentedRowReader(IRowReader* underlying, const TCountingTableReader* input, TJobStatistics& statistics);
+
+    IRowPtr ReadRow() override;
+    size_t ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                    std::vector<TReadingContext>* contexts) override;
+    using IRowReader::ReadRows;
+
+    IColumnBatchPtr ReadBatch(size_t maxRows) override;
+
+    IColumnBatchReader* GetColumnBatchReader() override;
+    // Rows are counted by Next() of this reader, so format-specific reading of them is counted too
+    IRowReader* GetUnderlyingReader() override;
+
+    void Next() override;
+    bool IsValid() const override;
+    bool IsEndOfStream() const override;
+
+    const TReadingContext& GetReadingContext() const override;
+    enum Format Format() const override;
+    size_t GetTablesCount() const override;
+    const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
+
+private:
+    // Attributes the bytes consumed since the last call to the given table
+    void CountBytes(size_t tableIndex);
+
+private:
+    IRowReader* Underlying_;
+    const TCountingTableReader* Input_;
+    TJobStatistics& Statistics_;
+
+    size_t CountedBytes_ = 0;
+    std::vector<TReadingContext> Contexts_;
+};
+
+// Writer counting written rows and time spent in the underlying one
+class TInstrumentedRowWriter : public IRowWriter {
+public:
+    TInstrumentedRowWriter(IRowWriter* underlying, TJobStatistics& statistics);
+
+    void WriteRow(const IRowConstPtr& row, size_t tableIndex) override;
+    void WriteRow(IRowPtr&& row, size_t tableIndex) override;
+    void FinishTable(size_t tableIndex) override;
+    void WriteRawRow(std::string_view data, size_t tableIndex) override;
+
+    enum Format Format() const override;
+    size_t GetTablesCount() const override;
+    const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
+    IRowPtr CreateObjectForWrite(size_t tableIndex) const override;
+
+private:
+    IRowWriter* Underlying_;
+    TJobStatistics& Statistics_;
+};
+
+// Adds the time passed since construction to the given duration
+class TTimeGuard {
+public:
+    explicit TTimeGuard(std::chrono::nanoseconds& total)
+      : Total_(total), Start_(std::chrono::steady_clock::now()) { }
+
+    ~TTimeGuard() {
+        Total_ += std::chrono::steady_clock::now() - Start_;
+    }
+
+private:
+    std::chrono::nanoseconds& Total_;
+    std::chrono::steady_clock::time_point Start_;
+};
+
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <yt/cpp/mapreduce/interface/common.h>
+#include <library/cpp/type_info/type_info.h>
+
+#include <dformats/interface/io.h>
+#include <dformats/skiff/skiff_types.h>
+#include <dformats/protobuf/protobuf_types.h>
+
+namespace DFormats {
+
+// Column name usable as a template argument
+template <size_t N>
+struct TColumnName {
+    constexpr TColumnName(const char (&name)[N]) {
+        std::copy_n(name, N, Value);
+    }
+
+    constexpr std::string_view View() const {
+        return {Value, N - 1};
+    }
+
+    char Value[N];
+};
+
+template <TColumnName Name, typename T>
+struct TColumn {
+    static constexpr std::string_view ColumnName = Name.View();
+    using TValue = T;
+};
+
+// Columns of a table known at compile time. They must be the first columns of the table schema
+// in the same order. Other columns of the table are accessible through the underlying row
+template <typename... TColumns>
+struct TRowSchema {
+    static constexpr size_t ColumnsCount = sizeof...(TColumns);
+
+    template <size_t I>
+    using TValue = typename std::tuple_element_t<I, std::tuple<TColumns...>>::TValue;
+
+    template <TColumnName Name>
+    static constexpr size_t IndexOf() {
+        constexpr std::string_view names[] = {TColumns::ColumnName...};
+        constexpr size_t index = std::find(std::begin(names), std::end(names), Name.View()) - std::begin(names);
+        static_assert(index < ColumnsCount, "Schema has no column with this name");
+
+        return index;
+    }
+
+    static constexpr std::string_view ColumnName(size_t index) {
+        constexpr std::string_view names[] = {TColumns::ColumnName...};
+        return names[index];
+    }
+};
+
+namespace NDetail {
+
+template <typename T>
+concept IsTypedScalar =
+    std::is_same_v<T, bool> || std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+    std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, uint8_t> ||
+    std::is_same_v<T, uint16_t> || std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t> ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Type of the scalar in Skiff data. Skiff has no 4-byte floats, Float columns are written as Double
+template <typename T>
+using TSkiffWireValue = std::conditional_t<std::is_same_v<T, float>, double, T>;
+
+// Whether values of the type can be read as T. Types without static access aren't checked here:
+// the virtual interface checks them on every call
+template <typename T>
+bool IsCompatibleType(NTi::ETypeName type) {
+    using NTi::ETypeName;
+
+    if constexpr (std::is_same_v<T, bool>) {
+        return type == ETypeName::Bool;
+    } else if constexpr (std::is_same_v<T, int8_t>) {
+        return type == ETypeName::Int8;
+    } else if constexpr (std::is_same_v<T, int16_t>) {
+        return type == ETypeName::Int16;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+        return type == ETypeName::Int32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return type == ETypeName::Int64;
+    } else if constexpr (std::is_same_v<T, uint8_t>) {
+        return type == ETypeName::Uint8;
+    } else if constexpr (std::is_same_v<T, uint16_t>) {
+        return type == ETypeName::Uint16;
+    } else if constexpr (std::is_same_v<T, uint32_t>) {
+        return type == ETypeName::Uint32;
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+        return type == ETypeName::Uint64;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return type == ETypeName::Float;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return type == ETypeName::Double;
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+        return type == ETypeName::String || type == ETypeName::Utf8;
+    } else {
+        return true;
+    }
+}
+
+}
+
+// Row with columns known at compile time. Scalar and string columns of Skiff and Protobuf rows are
+// accessed directly, without virtual calls and type checks per value, so the table schema has to be
+// checked once with Validate(). Other formats and column types go through the virtual interface
+template <typename TSchema>
+class TTypedRow {
+public:
+    explicit TTypedRow(IRowPtr row) : Row_(std::move(row)) {
+        if (auto* skiff = dynamic_cast<TSkiffTuple*>(Row_.get())) {
+            Skiff_ = skiff;
+        } else if (auto* protobuf = dynamic_cast<TProtobufObject*>(Row_.get())) {
+            Protobuf_ = protobuf;
+            ProtobufAccessors_ = protobuf->Accessors();
+        }
+    }
+
+    // Checks that the table starts with the columns of the schema
+    static void Validate(const NYT::TTableSchema& tableSchema) {
+        Y_ENSURE(tableSchema.Columns().size() >= TSchema::ColumnsCount,
+                 "Table has less columns than the typed row schema");
+
+        ValidateColumns(tableSchema, std::make_index_sequence<TSchema::ColumnsCount>());
+    }
+
+    template <size_t I>
+    typename TSchema::template TValue<I> Get() const {
+        using T = typename TSchema::template TValue<I>;
+
+        if constexpr (NDetail::IsTypedScalar<T>) {
+            if (Skiff_) {
+                NDetail::TSkiffWireValue<T> res;
+                std::memcpy(&res, Skiff_->FieldData(I), sizeof(res));
+                return static_cast<T>(res);
+            }
+            if (Protobuf_) {
+                return GetProtobuf<T>(I);
+            }
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            if (Skiff_) {
+                return SkiffDeserializeString(Skiff_->FieldData(I));
+            }
+            if (Protobuf_) {
+                const auto* field = ProtobufAccessors_->Field(I).Descriptor;
+                return ProtobufAccessors_->MessageReflection()->GetStringReference(*ProtobufMessage(), field, &Scratch_);
+            }
+        }
+
+        return Row_->GetValue<T>(I);
+    }
+
+    template <TColumnName Name>
+    auto Get() const {
+        return Get<TSchema::template IndexOf<Name>()>();
+    }
+
+    template <size_t I>
+    void Set(typename TSchema::template TValue<I> value) {
+        using T = typename TSchema::template TValue<I>;
+
+        if constexpr (NDetail::IsTypedScalar<T>) {
+            if (Skiff_) {
+                const NDetail::TSkiffWireValue<T> wireValue = value;
+                std::memcpy(Skiff_->MutableFieldData(I), &wireValue, sizeof(wireValue));
+                return;
+            }
+            if (Protobuf_) {
+                return SetProtobuf<T>(I, value);
+            }
+        }
+
+        Row_->SetValue(I, std::move(value));
+    }
+
+    template <TColumnName Name, typename T>
+    void Set(T&& value) {
+        Set<TSchema::template IndexOf<Name>()>(std::forward<T>(value));
+    }
+
+    const IRowPtr& Row() const & {
+        return Row_;
+    }
+    IRowPtr Row() && {
+        return std::move(Row_);
+    }
+
+private:
+    template <size_t... I>
+    static void ValidateColumns(const NYT::TTableSchema& tableSchema, std::index_sequence<I...>) {
+        (ValidateColumn<I>(tableSchema.Columns()[I]), ...);
+    }
+
+    template <size_t I>
+    static void ValidateColumn(const NYT::TColumnSchema& column) {
+        Y_ENSURE(column.Name() == TSchema::ColumnName(I), "Column " << I << " of the table is " << column.Name() <<
+                 ", but " << TSchema::ColumnName(I) << " is expected");
+        Y_ENSURE(NDetail::IsCompatibleType<typename TSchema::template TValue<I>>(column.TypeV3()->StripTags()->GetTypeName()),
+                 "Type of column " << column.Name() << " doesn't match the typed row schema");
+    }
+
+    // Narrow integers are stored in 32-bit fields, see MakeDescriptorPool
+    template <typename T>
+    T GetProtobuf(size_t ind) const {
+        const auto* field = ProtobufAccessors_->Field(ind).Descriptor;
+        const auto* reflection = ProtobufAccessors_->MessageReflection();
+
+        if constexpr (std::is_same_v<T, bool>) {
+            return reflection->GetBool(*ProtobufMessage(), field);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            return reflection->GetInt64(*ProtobufMessage(), field);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            return reflection->GetUInt64(*ProtobufMessage(), field);
+        } else if constexpr (std::is_same_v<T, float>) {
+            return reflection->GetFloat(*ProtobufMessage(), field);
+        } else if constexpr (std::is_same_v<T, double>) {
+            return reflection->GetDouble(*ProtobufMessage(), field);
+        } else if constexpr (std::is_signed_v<T>) {
+            return reflection->GetInt32(*ProtobufMessage(), field);
+        } else {
+            return reflection->GetUInt32(*ProtobufMessage(), field);
+        }
+    }
+
+    // Message isn't cached: the object replaces it on modification while it's viewed
+    const google::protobuf::Message* ProtobufMessage() const {
+        return std::as_const(*Protobuf_).RawMessage();
+    }
+
+    template <typename T>
+    void SetProtobuf(size_t ind, T value) {
+        const auto* field = ProtobufAccessors_->Field(ind).Descriptor;
+        const auto* reflection = ProtobufAccessors_->MessageReflection();
+        auto* message = Protobuf_->RawMessage();
+
+        if constexpr (std::is_same_v<T, bool>) {
+            reflection->SetBool(message, field, value);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            reflection->SetInt64(message, field, value);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            reflection->SetUInt64(message, field, value);
+        } else if constexpr (std::is_same_v<T, float>) {
+            reflection->SetFloat(message, field, value);
+        } else if constexpr (std::is_same_v<T, double>) {
+            reflection->SetDouble(message, field, value);
+        } else if constexpr (std::is_signed_v<T>) {
+            reflection->SetInt32(message, field, value);
+        } else {
+            reflection->SetUInt32(message, field, value);
+        }
+    }
+
+private:
+    IRowPtr Row_;
+    TSkiffTuple* Skiff_ = nullptr;
+    TProtobufObject* Protobuf_ = nullptr;
+    const TProtobufAccessorTable* ProtobufAccessors_ = nullptr;
+    mutable TString Scratch_;  // Used by protobuf reflection for strings it doesn't store as is
+};
+
+}
@@ -0,0 +1,188 @@
+#include "protobuf_lazy_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace DFormats {
+
+namespace {
+
+// Control values written in place of row length
+constexpr ui32 TableIndexMarker = static_cast<ui32>(-1);
+constexpr ui32 KeySwitchMarker = static_cast<ui32>(-2);
+constexpr ui32 RangeIndexMarker = static_cast<ui32>(-3);
+constexpr ui32 RowIndexMarker = static_cast<ui32>(-4);
+constexpr ui32 EndOfStreamMarker = static_cast<ui32>(-5);
+constexpr ui32 TabletIndexMarker = static_cast<ui32>(-6);
+
+}
+
+TProtobufLazyRowReader::TProtobufLazyRowReader(::TIntrusivePtr<TRawTableReader> input,
+    std::shared_ptr<TProtobufRowFactory> rowFactory, const std::vector<size_t>& inputTypesNumbers, size_t blockSize)
+  : Underlying_(std::move(input))
+  , RowFactory_(std::move(rowFactory))
+  , BlockSize_(blockSize)
+  , Block_(std::make_shared<TBuffer>()) {
+
+    TypeNames_.reserve(inputTypesNumbers.size());
+    Layouts_.reserve(inputTypesNumbers.size());
+
+    for (auto num : inputTypesNumbers) {
+        const auto& typeName = TypeNames_.emplace_back(RowFactory_->TypeNames()[num]);
+        Layouts_.push_back(std::make_shared<const TProtobufLazyLayout>(
+            RowFactory_->GetAccessorTable(RowFactory_->GetDescriptor(typeName)), RowFactory_->RawMessageFactory()));
+    }
+
+    Next();
+}
+
+size_t TProtobufLazyRowReader::FillBlock(size_t len) {
+    size_t available = Block_->Size() - BlockPos_;
+    if (available >= len || UnderlyingExhausted_) {
+        return available;
+    }
+
+    // Rows view data of the block, so it's replaced instead of being overwritten
+    if (Block_.use_count() > 1) {
+        auto block = std::make_shared<TBuffer>(std::max(BlockSize_, len));
+        block->Append(Block_->Data() + BlockPos_, available);
+        Block_ = std::move(block);
+        BlockPos_ = 0;
+    } else if (BlockPos_ != 0) {
+        Block_->Chop(0, BlockPos_);
+        BlockPos_ = 0;
+    }
+
+    const size_t capacity = std::max(BlockSize_, len);
+    Block_->Reserve(capacity);
+
+    while (Block_->Size() < len) {
+        auto readBytes = Underlying_->Read(Block_->Data() + Block_->Size(), capacity - Block_->Size());
+        if (readBytes == 0) {
+            UnderlyingExhausted_ = true;
+            break;
+        }
+        Block_->Advance(readBytes);
+    }
+
+    return Block_->Size();
+}
+
+bool TProtobufLazyRowReader::EnsureAvailable(size_t len, bool allowEOS) {
+    if (Y_LIKELY(Block_->Size() - BlockPos_ >= len)) {
+        return true;
+    }
+
+    auto available = FillBlock(len);
+
+    if (available == 0 && len != 0) {
+        Y_ENSURE(allowEOS, "Premature end of stream");
+        return false;
+    }
+
+    Y_ENSURE(available >= len, "Premature end of stream. Expected " <<
+        std::to_string(len) << " bytes, but only " << std::to_string(available) << " can be read");
+
+    return true;
+}
+
+template <class T>
+bool TProtobufLazyRowReader::ReadFromBlock(T* dst, bool allowEOS) {
+    if (!EnsureAvailable(sizeof(T), allowEOS)) {
+        return false;
+    }
+
+    std::memcpy(dst, Block_->Data() + BlockPos_, sizeof(T));
+    BlockPos_ += sizeof(T);
+    return true;
+}
+
+bool TProtobufLazyRowReader::IsValid() const {
+    return Valid_;
+}
+
+bool TProtobufLazyRowReader::IsEndOfStream() const {
+    return EndOfStream_;
+}
+
+void TProtobufLazyRowReader::Next() {
+    if (Valid_ && ReadingContext_.RowIndex) {
+        ++*ReadingContext_.RowIndex;
+    }
+    ReadingContext_.AfterKeySwitch = false;
+
+    while (true) {
+        ui32 value;
+        if (!ReadFromBlock(&value, true)) {
+            Valid_ = false;
+            return;
+        }
+
+        switch (value) {
+        case TableIndexMarker: {
+            ui32 tableIndex;
+            ReadFromBlock(&tableIndex);
+            Y_ENSURE(tableIndex < Layouts_.size(), "Table index " << tableIndex << " is out of range");
+            ReadingContext_.TableIndex = tableIndex;
+            break;
+        }
+        case KeySwitchMarker:
+            ReadingContext_.AfterKeySwitch = true;
+            break;
+        case RangeIndexMarker: {
+            ui32 rangeIndex;
+            ReadFromBlock(&rangeIndex);
+            ReadingContext_.RangeIndex = rangeIndex;
+            break;
+        }
+        case RowIndexMarker: {
+            ui64 rowIndex;
+            ReadFromBlock(&rowIndex);
+            ReadingContext_.RowIndex = rowIndex;
+            break;
+        }
+        case TabletIndexMarker: {
+            ui64 tabletIndex;
+            ReadFromBlock(&tabletIndex);
+            break;
+        }
+        case EndOfStreamMarker:
+            EndOfStream_ = true;
+            Valid_ = false;
+            return;
+        default:
+            EnsureAvailable(value);
+            CurrentRow_ = {Block_->Data() + BlockPos_, value};
+            BlockPos_ += value;
+            Valid_ = true;
+            return;
+        }
+    }
+}
+
+IRowPtr TProtobufLazyRowReader::ReadRow() {
+    return std::make_shared<TProtobufLazyRow>(std::make_shared<TProtobufLazyMessage>(
+        Layouts_[ReadingContext_.TableIndex], Block_, CurrentRow_));
+}
+
+const TReadingContext& TProtobufLazyRowReader::GetReadingContext() const {
+    return ReadingContext_;
+}
+
+Format TProtobufLazyRowReader::Format() const {
+    return Format::Protobuf;
+}
+
+size_t TProtobufLazyRowReader::GetTablesCount() const {
+    return TypeNames_.size();
+}
+
+const NYT::TTableSchema& TProtobufLazyRowReader::GetTableSchema(size_t tableIndex) const {
+    return RowFactory_->GetTableSchema(TypeNames_[tableIndex]);
+}
+
+std::shared_ptr<TProtobufRowFactory> TProtobufLazyRowReader::RowFactory() const {
+    return RowFactory_;
+}
+
+}
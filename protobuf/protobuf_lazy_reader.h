@@ -0,0 +1,63 @@
+#pragma once
+
+#include <util/generic/buffer.h>
+#include <yt/cpp/mapreduce/interface/io.h>
+
+#include "protobuf_lazy_types.h"
+#include "protobuf_row_factory.h"
+#include <dformats/interface/io.h>
+
+using namespace NYT;
+
+namespace DFormats {
+
+// Reads lenval Protobuf stream without parsing messages. Rows are TProtobufLazyRow objects viewing
+// their serialization in the input block, so strings aren't copied and untouched fields aren't decoded.
+// Blocks are shared with rows: a row kept alive holds the memory of its whole block
+class TProtobufLazyRowReader : public IRowReader {
+public:
+    TProtobufLazyRowReader(::TIntrusivePtr<TRawTableReader> input, std::shared_ptr<TProtobufRowFactory> rowFactory,
+        const std::vector<size_t>& inputTypesNumbers, size_t blockSize = 1 << 20);
+
+    TProtobufLazyRowReader(TProtobufLazyRowReader&& rhs) = default;
+    TProtobufLazyRowReader& operator=(TProtobufLazyRowReader&& rhs) = default;
+
+    IRowPtr ReadRow() override;
+
+    bool IsValid() const override;
+    bool IsEndOfStream() const override;
+    void Next() override;
+
+    const TReadingContext& GetReadingContext() const override;
+    enum Format Format() const override;
+    size_t GetTablesCount() const override;
+    const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
+
+    std::shared_ptr<TProtobufRowFactory> RowFactory() const;
+
+private:
+    template <class T>
+    bool ReadFromBlock(T* dst, bool allowEOS = false);
+    bool EnsureAvailable(size_t len, bool allowEOS = false);
+    size_t FillBlock(size_t len);
+
+private:
+    ::TIntrusivePtr<TRawTableReader> Underlying_;
+    std::shared_ptr<TProtobufRowFactory> RowFactory_;
+    std::vector<std::string> TypeNames_;
+    std::vector<TProtobufLazyLayoutPtr> Layouts_;
+    size_t BlockSize_;
+
+    // Data loaded from Underlying_ but not parsed yet lays in Block_ after BlockPos_.
+    // Block referenced by rows is never modified, unparsed tail is moved to a new one instead
+    std::shared_ptr<TBuffer> Block_;
+    size_t BlockPos_ = 0;
+    bool UnderlyingExhausted_ = false;
+
+    std::string_view CurrentRow_;
+    TReadingContext ReadingContext_;
+    bool Valid_ = false;
+    bool EndOfStream_ = false;
+};
+
+}
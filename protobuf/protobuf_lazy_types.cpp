@@ -0,0 +1,533 @@
+#include "protobuf_lazy_types.h"
+
+#include <cstring>
+
+namespace DFormats {
+
+namespace {
+
+enum EWireType {
+    Varint = 0,
+    Fixed64 = 1,
+    LengthDelimited = 2,
+    Fixed32 = 5
+};
+
+uint64_t ReadVarint(const char*& pos, const char* end) {
+    uint64_t res = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        Y_ENSURE(pos < end, "Truncated Protobuf varint");
+
+        const auto byte = static_cast<uint8_t>(*pos++);
+        res |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            return res;
+        }
+    }
+
+    ythrow yexception() << "Malformed Protobuf varint";
+}
+
+// Moves pos past the value and returns the beginning of its payload
+const char* SkipValue(const char*& pos, const char* end, uint32_t wireType) {
+    uint64_t len = 0;
+
+    switch (wireType) {
+    case EWireType::Varint: {
+        const char* value = pos;
+        ReadVarint(pos, end);
+        return value;
+    }
+    case EWireType::Fixed64:
+        len = 8;
+        break;
+    case EWireType::LengthDelimited:
+        len = ReadVarint(pos, end);
+        break;
+    case EWireType::Fixed32:
+        len = 4;
+        break;
+    default:
+        ythrow yexception() << "Unsupported Protobuf wire type " << wireType;
+    }
+
+    Y_ENSURE(len <= static_cast<uint64_t>(end - pos), "Truncated Protobuf field");
+
+    const char* value = pos;
+    pos += len;
+    return value;
+}
+
+// Walks fields of the serialization calling func(fieldIndex, span) for fields known to the layout
+template <typename TFunc>
+void ForEachField(const TProtobufLazyLayout& layout, std::string_view data, TFunc&& func) {
+    const char* begin = data.data();
+    const char* end = begin + data.size();
+
+    for (const char* pos = begin; pos < end; ) {
+        const char* tagPos = pos;
+        const auto tag = ReadVarint(pos, end);
+        const char* valuePos = SkipValue(pos, end, tag & 7);
+
+        const int ind = layout.FieldIndex(tag >> 3);
+        if (ind >= 0) {
+            func(static_cast<size_t>(ind), TProtobufLazyMessage::TFieldSpan{
+                static_cast<uint32_t>(tagPos - begin),
+                static_cast<uint32_t>(valuePos - begin),
+                static_cast<uint32_t>(pos - begin)});
+        }
+    }
+}
+
+[[noreturn]] void ThrowReadOnly() {
+    ythrow yexception() << "Lazy Protobuf object is read-only, copy it for modification";
+}
+
+}
+
+// TProtobufLazyLayout
+
+TProtobufLazyLayout::TProtobufLazyLayout(const TProtobufAccessorTable* accessors, std::shared_ptr<MessageFactory> factory)
+  : Accessors_(accessors), Factory_(std::move(factory)), Nested_(accessors->FieldsCount()) {
+
+    for (size_t i = 0; i < accessors->FieldsCount(); ++i) {
+        const auto& field = accessors->Field(i);
+        const auto number = static_cast<size_t>(field.Descriptor->number());
+
+        if (number >= FieldIndexes_.size()) {
+            FieldIndexes_.resize(number + 1, -1);
+        }
+        FieldIndexes_[number] = i;
+
+        if (field.Nested) {
+            Nested_[i] = std::make_shared<const TProtobufLazyLayout>(field.Nested, Factory_);
+        }
+    }
+}
+
+size_t TProtobufLazyLayout::GetIndex(std::string_view name) const {
+    return Accessors_->GetIndex(name);
+}
+
+std::unique_ptr<Message> TProtobufLazyLayout::NewMessage() const {
+    return std::unique_ptr<Message>(Factory_->GetPrototype(MessageDescriptor())->New());
+}
+
+// TProtobufLazyMessage
+
+TProtobufLazyMessage::TProtobufLazyMessage(TProtobufLazyLayoutPtr layout, std::shared_ptr<const void> holder, std::string_view data)
+  : Layout_(std::move(layout)), Holder_(std::move(holder)), Data_(data) { }
+
+void TProtobufLazyMessage::Scan() const {
+    Spans_.assign(Layout_->FieldsCount(), {});
+
+    ForEachField(*Layout_, Data_, [this] (size_t ind, const TFieldSpan& span) {
+        auto& last = Spans_[ind];
+        const auto& field = Layout_->Accessors()->Field(ind);
+
+        if (last.Value != 0 && field.Nested && !field.Repeated) {
+            if (MergedValues_.empty()) {
+                MergedValues_.resize(Spans_.size());
+            }
+
+            auto& merged = MergedValues_[ind];
+            if (!merged) {
+                merged = std::make_shared<std::string>(Data_.substr(last.Value, last.End - last.Value));
+            }
+            merged->append(Data_.substr(span.Value, span.End - span.Value));
+        }
+
+        last = span;
+    });
+
+    Scanned_ = true;
+}
+
+std::pair<std::shared_ptr<const void>, std::string_view> TProtobufLazyMessage::MessageFieldValue(size_t ind) const {
+    const auto value = FieldValue(ind);  // Scans the message
+
+    if (!MergedValues_.empty() && MergedValues_[ind]) {
+        return {MergedValues_[ind], *MergedValues_[ind]};
+    }
+
+    return {Holder_, value};
+}
+
+std::string TProtobufLazyMessage::FieldOccurrences(size_t ind) const {
+    std::string res;
+
+    ForEachField(*Layout_, Data_, [&] (size_t fieldIndex, const TFieldSpan& span) {
+        if (fieldIndex == ind) {
+            res.append(Data_.substr(span.Tag, span.End - span.Tag));
+        }
+    });
+
+    return res;
+}
+
+// TProtobufLazyObject
+
+TProtobufLazyObject::TProtobufLazyObject(TProtobufLazyMessagePtr message)
+  : Message_(std::move(message)) { }
+
+uint64_t TProtobufLazyObject::GetVarint(size_t ind) const {
+    const auto value = Message_->FieldValue(ind);
+    if (value.empty()) {
+        return 0;
+    }
+
+    const char* pos = value.data();
+    return ReadVarint(pos, value.data() + value.size());
+}
+
+template <typename T>
+T TProtobufLazyObject::GetFixed(size_t ind) const {
+    const auto value = Message_->FieldValue(ind);
+    if (value.empty()) {
+        return 0;
+    }
+
+    T res;
+    std::memcpy(&res, value.data(), sizeof(T));
+    return res;
+}
+
+bool TProtobufLazyObject::GetBool(size_t ind) const {
+    return !Materialized_ ? GetVarint(ind) != 0 : Materialized().GetValue<bool>(ind);
+}
+
+int8_t TProtobufLazyObject::GetInt8(size_t ind) const {
+    return GetInt32(ind);
+}
+
+int16_t TProtobufLazyObject::GetInt16(size_t ind) const {
+    return GetInt32(ind);
+}
+
+int32_t TProtobufLazyObject::GetInt32(size_t ind) const {
+    return !Materialized_ ? static_cast<int32_t>(GetVarint(ind)) : Materialized().GetValue<int32_t>(ind);
+}
+
+int64_t TProtobufLazyObject::GetInt64(size_t ind) const {
+    return !Materialized_ ? static_cast<int64_t>(GetVarint(ind)) : Materialized().GetValue<int64_t>(ind);
+}
+
+uint8_t TProtobufLazyObject::GetUInt8(size_t ind) const {
+    return GetUInt32(ind);
+}
+
+uint16_t TProtobufLazyObject::GetUInt16(size_t ind) const {
+    return GetUInt32(ind);
+}
+
+uint32_t TProtobufLazyObject::GetUInt32(size_t ind) const {
+    return !Materialized_ ? static_cast<uint32_t>(GetVarint(ind)) : Materialized().GetValue<uint32_t>(ind);
+}
+
+uint64_t TProtobufLazyObject::GetUInt64(size_t ind) const {
+    return !Materialized_ ? GetVarint(ind) : Materialized().GetValue<uint64_t>(ind);
+}
+
+float TProtobufLazyObject::GetFloat(size_t ind) const {
+    return !Materialized_ ? GetFixed<float>(ind) : Materialized().GetValue<float>(ind);
+}
+
+double TProtobufLazyObject::GetDouble(size_t ind) const {
+    return !Materialized_ ? GetFixed<double>(ind) : Materialized().GetValue<double>(ind);
+}
+
+std::string_view TProtobufLazyObject::GetString(size_t ind) const {
+    // Views the input data, no copy is made
+    return !Materialized_ ? Message_->FieldValue(ind) : Materialized().GetValue<std::string_view>(ind);
+}
+
+IStructConstPtr TProtobufLazyObject::GetStruct(size_t ind) const {
+    if (Materialized_) {
+        return Materialized().GetValue<IStructConstPtr>(ind);
+    }
+
+    auto [holder, value] = Message_->MessageFieldValue(ind);
+    return std::make_shared<TProtobufLazyStruct>(std::make_shared<TProtobufLazyMessage>(
+        Message_->Layout()->Nested(ind), std::move(holder), value));
+}
+
+ITupleConstPtr TProtobufLazyObject::GetTuple(size_t) const {
+    ythrow yexception() << "Tuples are not supported in Protobuf";
+}
+
+IListConstPtr TProtobufLazyObject::GetList(size_t ind) const {
+    if (Materialized_) {
+        return Materialized().GetValue<IListConstPtr>(ind);
+    }
+
+    return std::make_shared<TProtobufList>(ParseField(ind), Factory(), Message_->Layout()->Accessors(), ind);
+}
+
+IDictConstPtr TProtobufLazyObject::GetDict(size_t ind) const {
+    if (Materialized_) {
+        return Materialized().GetValue<IDictConstPtr>(ind);
+    }
+
+    return std::make_shared<TProtobufDict>(ParseField(ind), Factory(), Message_->Layout()->Accessors(), ind);
+}
+
+IVariantConstPtr TProtobufLazyObject::GetVariant(size_t ind) const {
+    if (Materialized_) {
+        return Materialized().GetValue<IVariantConstPtr>(ind);
+    }
+
+    auto [holder, value] = Message_->MessageFieldValue(ind);
+    return std::make_shared<TProtobufLazyVariant>(std::make_shared<TProtobufLazyMessage>(
+        Message_->Layout()->Nested(ind), std::move(holder), value));
+}
+
+IOptionalConstPtr TProtobufLazyObject::GetOptional(size_t ind) const {
+    if (Materialized_) {
+        return Materialized().GetValue<IOptionalConstPtr>(ind);
+    }
+
+    return std::make_shared<TProtobufLazyOptional>(Message_, ind);
+}
+
+void TProtobufLazyObject::SetBool(size_t ind, bool value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetInt8(size_t ind, int8_t value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetInt16(size_t ind, int16_t value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetInt32(size_t ind, int32_t value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetInt64(size_t ind, int64_t value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetUInt8(size_t ind, uint8_t value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetUInt16(size_t ind, uint16_t value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetUInt32(size_t ind, uint32_t value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetUInt64(size_t ind, uint64_t value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetFloat(size_t ind, float value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetDouble(size_t ind, double value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetString(size_t ind, std::string_view value) {
+    Mutable().SetValue(ind, value);
+}
+
+void TProtobufLazyObject::SetStruct(size_t ind, IStructConstPtr value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetTuple(size_t, ITupleConstPtr) {
+    ythrow yexception() << "Tuples are not supported in Protobuf";
+}
+
+void TProtobufLazyObject::SetList(size_t ind, IListConstPtr value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetDict(size_t ind, IDictConstPtr value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetVariant(size_t ind, IVariantConstPtr value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetOptional(size_t ind, IOptionalConstPtr value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetString(size_t ind, std::string&& value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetStruct(size_t ind, IStructPtr&& value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetTuple(size_t, ITuplePtr&&) {
+    ythrow yexception() << "Tuples are not supported in Protobuf";
+}
+
+void TProtobufLazyObject::SetList(size_t ind, IListPtr&& value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetDict(size_t ind, IDictPtr&& value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetVariant(size_t ind, IVariantPtr&& value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+void TProtobufLazyObject::SetOptional(size_t ind, IOptionalPtr&& value) {
+    Mutable().SetValue(ind, std::move(value));
+}
+
+IBaseIndexed<size_t>& TProtobufLazyObject::Mutable() {
+    ThrowReadOnly();
+}
+
+std::shared_ptr<Message> TProtobufLazyObject::ParseMessage() const {
+    std::shared_ptr<Message> res = Message_->Layout()->NewMessage();
+
+    const auto data = Message_->Data();
+    Y_ENSURE(res->ParsePartialFromArray(data.data(), data.size()), "Failed to parse Protobuf message");
+
+    return res;
+}
+
+std::shared_ptr<Message> TProtobufLazyObject::ParseField(size_t ind) const {
+    std::shared_ptr<Message> res = Message_->Layout()->NewMessage();
+
+    Y_ENSURE(res->ParsePartialFromString(Message_->FieldOccurrences(ind)), "Failed to parse Protobuf field");
+
+    return res;
+}
+
+// TProtobufLazyStruct
+
+TProtobufLazyStruct::TProtobufLazyStruct(TProtobufLazyMessagePtr message)
+  : TProtobufLazyObject(std::move(message)) { }
+
+IStructPtr TProtobufLazyStruct::CopyStruct() const {
+    if (Materialized_) {
+        return static_cast<const TProtobufStruct&>(*Materialized_).CopyStruct();
+    }
+
+    return std::make_shared<TProtobufStruct>(ParseMessage(), Factory(), LazyMessage().Layout()->Accessors());
+}
+
+std::vector<std::string> TProtobufLazyStruct::FieldsNames() const {
+    auto descriptor = LazyMessage().Layout()->MessageDescriptor();
+
+    std::vector<std::string> res;
+    res.reserve(descriptor->field_count());
+
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+        res.emplace_back(descriptor->field(i)->name());
+    }
+
+    return res;
+}
+
+size_t TProtobufLazyStruct::GetIndex(std::string_view name) const {
+    return LazyMessage().Layout()->GetIndex(name);
+}
+
+// TProtobufLazyVariant
+
+TProtobufLazyVariant::TProtobufLazyVariant(TProtobufLazyMessagePtr message)
+  : TProtobufLazyObject(message), TProtobufLazyStruct(message) { }
+
+IVariantPtr TProtobufLazyVariant::CopyVariant() const {
+    return std::make_shared<TProtobufVariant>(ParseMessage(), Factory(), LazyMessage().Layout()->Accessors());
+}
+
+size_t TProtobufLazyVariant::VariantsCount() const {
+    return LazyMessage().Layout()->FieldsCount();
+}
+
+size_t TProtobufLazyVariant::VariantNumber() const {
+    // Alternatives are members of a oneof, so the last one met in the data is set
+    size_t res = 0;
+    uint32_t lastValue = 0;
+
+    for (size_t i = 0; i < VariantsCount(); ++i) {
+        const auto& span = LazyMessage().Field(i);
+        if (span.Value > lastValue) {
+            res = i;
+            lastValue = span.Value;
+        }
+    }
+
+    return res;
+}
+
+void TProtobufLazyVariant::EmplaceVariant(size_t) {
+    ThrowReadOnly();
+}
+
+// TProtobufLazyOptional
+
+TProtobufLazyOptional::TProtobufLazyOptional(TProtobufLazyMessagePtr message, size_t fieldIndex)
+  : TProtobufLazyObject(std::move(message)), FieldIndex_(fieldIndex) { }
+
+IOptionalPtr TProtobufLazyOptional::CopyOptional() const {
+    return std::make_shared<TProtobufOptional>(ParseField(FieldIndex_), Factory(),
+                                               LazyMessage().Layout()->Accessors(), FieldIndex_);
+}
+
+bool TProtobufLazyOptional::HasValue() const {
+    return LazyMessage().Field(FieldIndex_).Value != 0;
+}
+
+void TProtobufLazyOptional::ClearValue() {
+    ThrowReadOnly();
+}
+
+void TProtobufLazyOptional::EmplaceValue() {
+    ThrowReadOnly();
+}
+
+size_t TProtobufLazyOptional::GetIndex(bool) const {
+    return FieldIndex_;
+}
+
+// TProtobufLazyRow
+
+TProtobufLazyRow::TProtobufLazyRow(TProtobufLazyMessagePtr message)
+  : TProtobufLazyObject(message), TProtobufLazyStruct(message) { }
+
+IRowPtr TProtobufLazyRow::CopyRow() const {
+    if (Materialized_) {
+        return std::make_shared<TProtobufRow>(*Materialized_);
+    }
+
+    // Positions of fields are scanned lazily, so the copy gets a message object of its own
+    const auto& message = LazyMessage();
+    return std::make_shared<TProtobufLazyRow>(
+        std::make_shared<TProtobufLazyMessage>(message.Layout(), message.Holder(), message.Data()));
+}
+
+const TProtobufRow& TProtobufLazyRow::ProtobufRow() const {
+    if (!Materialized_) {
+        Materialized_ = std::make_shared<TProtobufRow>(ParseMessage(), Factory(), LazyMessage().Layout()->Accessors());
+    }
+
+    return *Materialized_;
+}
+
+IBaseIndexed<size_t>& TProtobufLazyRow::Mutable() {
+    ProtobufRow();
+    return *Materialized_;
+}
+
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "protobuf_types.h"
+
+using namespace google::protobuf;
+
+namespace DFormats {
+
+class TProtobufLazyLayout;
+
+using TProtobufLazyLayoutPtr = std::shared_ptr<const TProtobufLazyLayout>;
+
+// Fields of a message type by their wire numbers. Built once per type and shared
+// by all lazy objects of the type and, through nested layouts, of its message fields
+class TProtobufLazyLayout {
+public:
+    TProtobufLazyLayout(const TProtobufAccessorTable* accessors, std::shared_ptr<MessageFactory> factory);
+
+    inline const Descriptor* MessageDescriptor() const {
+        return Accessors_->MessageDescriptor();
+    }
+
+    // Table of the type, passed to objects the message is parsed into
+    inline const TProtobufAccessorTable* Accessors() const {
+        return Accessors_;
+    }
+
+    inline const std::shared_ptr<MessageFactory>& Factory() const {
+        return Factory_;
+    }
+
+    inline size_t FieldsCount() const {
+        return Nested_.size();
+    }
+
+    // Index of the field with the given number or -1 if the type has no such field
+    inline int FieldIndex(uint32_t number) const {
+        return number < FieldIndexes_.size() ? FieldIndexes_[number] : -1;
+    }
+
+    // Layout of the message type of the field. Null for non-message fields
+    inline const TProtobufLazyLayoutPtr& Nested(size_t ind) const {
+        return Nested_[ind];
+    }
+
+    size_t GetIndex(std::string_view name) const;
+    std::unique_ptr<Message> NewMessage() const;
+
+private:
+    const TProtobufAccessorTable* Accessors_;
+    std::shared_ptr<MessageFactory> Factory_;
+    std::vector<int> FieldIndexes_;
+    std::vector<TProtobufLazyLayoutPtr> Nested_;
+};
+
+// Serialized message viewed in memory kept alive by the holder. Positions of fields
+// are found by a single scan on first access, values are decoded by the caller
+class TProtobufLazyMessage {
+public:
+    // Value points to the payload of length-delimited fields. It's zero for absent fields,
+    // since a value always follows a tag
+    struct TFieldSpan {
+        uint32_t Tag = 0;
+        uint32_t Value = 0;
+        uint32_t End = 0;
+    };
+
+public:
+    TProtobufLazyMessage(TProtobufLazyLayoutPtr layout, std::shared_ptr<const void> holder, std::string_view data);
+
+    inline const TProtobufLazyLayoutPtr& Layout() const {
+        return Layout_;
+    }
+
+    inline const std::shared_ptr<const void>& Holder() const {
+        return Holder_;
+    }
+
+    inline std::string_view Data() const {
+        return Data_;
+    }
+
+    // Last occurrence of the field. Values of scalars and strings are taken from it as Protobuf does
+    inline const TFieldSpan& Field(size_t ind) const {
+        if (!Scanned_) {
+            Scan();
+        }
+        return Spans_[ind];
+    }
+
+    inline std::string_view FieldValue(size_t ind) const {
+        const auto& span = Field(ind);
+        return Data_.substr(span.Value, span.End - span.Value);
+    }
+
+    // Payload of the non-repeated message field with the holder keeping it alive. Protobuf merges
+    // occurrences of such a field, so payloads of several occurrences are concatenated into a buffer
+    std::pair<std::shared_ptr<const void>, std::string_view> MessageFieldValue(size_t ind) const;
+
+    // Serialization of all occurrences of the field, i.e. message with only this field set
+    std::string FieldOccurrences(size_t ind) const;
+
+private:
+    void Scan() const;
+
+private:
+    TProtobufLazyLayoutPtr Layout_;
+    std::shared_ptr<const void> Holder_;
+    std::string_view Data_;
+
+    mutable std::vector<TFieldSpan> Spans_;
+    mutable std::vector<std::shared_ptr<std::string>> MergedValues_;  // Sized once a message field occurs twice
+    mutable bool Scanned_ = false;
+};
+
+using TProtobufLazyMessagePtr = std::shared_ptr<const TProtobufLazyMessage>;
+
+// Object reading fields straight from serialized message. Scalars, strings and nested structs
+// are decoded on access without parsing the message; lists and dicts are parsed field-wise.
+// Lazy objects are read-only, except rows which are parsed into TProtobufRow on modification
+class TProtobufLazyObject : virtual public IBaseIndexed<size_t> {
+public:
+    explicit TProtobufLazyObject(TProtobufLazyMessagePtr message);
+
+    virtual ~TProtobufLazyObject() = default;
+
+protected:
+    bool GetBool(size_t ind) const override;
+    int8_t GetInt8(size_t ind) const override;
+    int16_t GetInt16(size_t ind) const override;
+    int32_t GetInt32(size_t ind) const override;
+    int64_t GetInt64(size_t ind) const override;
+    uint8_t GetUInt8(size_t ind) const override;
+    uint16_t GetUInt16(size_t ind) const override;
+    uint32_t GetUInt32(size_t ind) const override;
+    uint64_t GetUInt64(size_t ind) const override;
+    float GetFloat(size_t ind) const override;
+    double GetDouble(size_t ind) const override;
+    std::string_view GetString(size_t ind) const override;
+    IStructConstPtr GetStruct(size_t ind) const override;
+    ITupleConstPtr GetTuple(size_t ind) const override;
+    IListConstPtr GetList(size_t ind) const override;
+    IDictConstPtr GetDict(size_t ind) const override;
+    IVariantConstPtr GetVariant(size_t ind) const override;
+    IOptionalConstPtr GetOptional(size_t ind) const override;
+
+    void SetBool(size_t ind, bool value) override;
+    void SetInt8(size_t ind, int8_t value) override;
+    void SetInt16(size_t ind, int16_t value) override;
+    void SetInt32(size_t ind, int32_t value) override;
+    void SetInt64(size_t ind, int64_t value) override;
+    void SetUInt8(size_t ind, uint8_t value) override;
+    void SetUInt16(size_t ind, uint16_t value) override;
+    void SetUInt32(size_t ind, uint32_t value) override;
+    void SetUInt64(size_t ind, uint64_t value) override;
+    void SetFloat(size_t ind, float value) override;
+    void SetDouble(size_t ind, double value) override;
+    void SetString(size_t ind, std::string_view value) override;
+    void SetStruct(size_t ind, IStructConstPtr value) override;
+    void SetTuple(size_t ind, ITupleConstPtr value) override;
+    void SetList(size_t ind, IListConstPtr value) override;
+    void SetDict(size_t ind, IDictConstPtr value) override;
+    void SetVariant(size_t ind, IVariantConstPtr value) override;
+    void SetOptional(size_t ind, IOptionalConstPtr value) override;
+
+    void SetString(size_t ind, std::string&& value) override;
+    void SetStruct(size_t ind, IStructPtr&& value) override;
+    void SetTuple(size_t ind, ITuplePtr&& value) override;
+    void SetList(size_t ind, IListPtr&& value) override;
+    void SetDict(size_t ind, IDictPtr&& value) override;
+    void SetVariant(size_t ind, IVariantPtr&& value) override;
+    void SetOptional(size_t ind, IOptionalPtr&& value) override;
+
+protected:
+    // Object to apply modifications to. Throws for read-only objects
+    virtual IBaseIndexed<size_t>& Mutable();
+
+    inline const TProtobufLazyMessage& LazyMessage() const {
+        return *Message_;
+    }
+    inline const TProtobufLazyMessagePtr& LazyMessagePtr() const {
+        return Message_;
+    }
+    inline const std::shared_ptr<MessageFactory>& Factory() const {
+        return Message_->Layout()->Factory();
+    }
+
+    std::shared_ptr<Message> ParseMessage() const;
+    // New message of the object's type with only the given field set
+    std::shared_ptr<Message> ParseField(size_t ind) const;
+
+    uint64_t GetVarint(size_t ind) const;
+    template <typename T>
+    T GetFixed(size_t ind) const;
+
+protected:
+    // Set once the object is parsed, all fields are accessed through it then
+    mutable std::shared_ptr<TProtobufRow> Materialized_;
+
+private:
+    inline const IBaseIndexed<size_t>& Materialized() const {
+        return *Materialized_;
+    }
+
+private:
+    TProtobufLazyMessagePtr Message_;
+};
+
+class TProtobufLazyStruct : virtual public TProtobufLazyObject, virtual public IBaseStruct, virtual public IIndexedProxy<std::string_view, size_t> {
+public:
+    explicit TProtobufLazyStruct(TProtobufLazyMessagePtr message);
+
+    IStructPtr CopyStruct() const override;
+    std::vector<std::string> FieldsNames() const override;
+
+protected:
+    size_t GetIndex(std::string_view name) const override;
+};
+
+class TProtobufLazyVariant : virtual public TProtobufLazyStruct, virtual public IBaseVariant {
+public:
+    explicit TProtobufLazyVariant(TProtobufLazyMessagePtr message);
+
+    IVariantPtr CopyVariant() const override;
+    size_t VariantsCount() const override;
+    size_t VariantNumber() const override;
+    void EmplaceVariant(size_t number) override;
+};
+
+class TProtobufLazyOptional : virtual public TProtobufLazyObject, virtual public IBaseOptional, virtual public IIndexedProxy<bool, size_t> {
+public:
+    TProtobufLazyOptional(TProtobufLazyMessagePtr message, size_t fieldIndex);
+
+    IOptionalPtr CopyOptional() const override;
+
+    bool HasValue() const override;
+    void ClearValue() override;
+    void EmplaceValue() override;
+
+protected:
+    size_t GetIndex(bool) const override;
+
+private:
+    size_t FieldIndex_;
+};
+
+class TProtobufLazyRow : virtual public TProtobufLazyStruct, virtual public IBaseRow {
+public:
+    explicit TProtobufLazyRow(TProtobufLazyMessagePtr message);
+
+    // Copy shares the serialized data unless the row is modified
+    IRowPtr CopyRow() const override;
+
+    // Row parsed into a message. Parsing is done once, the row reads fields from the message then
+    const TProtobufRow& ProtobufRow() const;
+
+    // Serialized message the row is read from. Empty once the row is parsed, since it may be modified then
+    inline std::optional<std::string_view> SerializedData() const {
+        return !Materialized_ ? std::optional(LazyMessage().Data()) : std::nullopt;
+    }
+    inline const Descriptor* MessageDescriptor() const {
+        return LazyMessage().Layout()->MessageDescriptor();
+    }
+
+protected:
+    IBaseIndexed<size_t>& Mutable() override;
+
+private:
+    inline ITuplePtr CopyTuple() const override {
+        return nullptr;
+    }
+    inline IStructPtr CopyStruct() const override {
+        return TProtobufLazyStruct::CopyStruct();
+    }
+    inline size_t FieldsCount() const override {
+        return LazyMessage().Layout()->FieldsCount();
+    }
+};
+
+}
@@ -1,9 +1,12 @@
 #include "protobuf_reader.h"
 
+#include <algorithm>
+
 namespace DFormats {
 
 TProtobufRowReader::TProtobufRowReader(::TIntrusivePtr<TRawTableReader> input,
-    std::shared_ptr<TProtobufRowFactory> rowFactory, const std::vector<size_t>& inputTypesNumbers) {
+    std::shared_ptr<TProtobufRowFactory> rowFactory, const std::vector<size_t>& inputTypesNumbers,
+    TProtobufReaderOptions readerOptions) {
     
     std::vector<std::string> typeNames;
     typeNames.reserve(inputTypesNumbers.size());
@@ -12,11 +15,15 @@ TProtobufRowReader::TProtobufRowReader(::TIntrusivePtr<TRawTableReader> input,
         typeNames.emplace_back(rowFactory->TypeNames()[num]);
     }
 
-    *this = TProtobufRowReader(input, std::move(rowFactory), std::move(typeNames));
+    *this = TProtobufRowReader(input, std::move(rowFactory), std::move(typeNames), readerOptions);
 }
 
 TProtobufRowReader::TProtobufRowReader(::TIntrusivePtr<TRawTableReader> input, std::shared_ptr<TProtobufRowFactory> rowFactory,
-    std::vector<std::string> typeNames) : RowFactory_(std::move(rowFactory)), TypeNames_(std::move(typeNames)) {
+    std::vector<std::string> typeNames, TProtobufReaderOptions readerOptions)
+  : RowFactory_(std::move(rowFactory))
+  , TypeNames_(std::move(typeNames))
+  , ReaderOptions_(readerOptions)
+  , ReusedRows_(TypeNames_.size()) {
 
     TVector<const Descriptor*> descriptors;
     descriptors.reserve(TypeNames_.size());
@@ -24,6 +31,7 @@ TProtobufRowReader::TProtobufRowReader(::TIntrusivePtr<TRawTableReader> input, s
     for (const auto& typeName : TypeNames_) {
         descriptors.push_back(RowFactory_->GetDescriptor(typeName));
     }
+    Descriptors_.assign(descriptors.begin(), descriptors.end());
 
     Underlying_ = std::make_unique<TLenvalProtoTableReader>(std::move(input), std::move(descriptors));
     RefreshReadingContext();
@@ -43,11 +51,86 @@ void TProtobufRowReader::Next() {
 }
 
 IRowPtr TProtobufRowReader::ReadRow()  {
-    auto row = RowFactory_->NewRow(TypeNames_[Underlying_->GetTableIndex()]);
+    const auto tableIndex = Underlying_->GetTableIndex();
+    const auto& typeName = TypeNames_[tableIndex];
+
+    if (ReaderOptions_.ReuseRows) {
+        auto& reused = ReusedRows_[tableIndex];
+
+        // Views of nested fields returned by the row share its message, not the row itself
+        if (reused && reused.use_count() == 1 && !reused->IsMessageShared()) {
+            reused->RawMessage()->Clear();
+        } else {
+            reused = RowFactory_->NewRow(typeName);
+        }
+
+        Underlying_->ReadRow(reused->RawMessage());
+        return reused;
+    }
+
+    std::unique_ptr<TProtobufRow> row;
+    if (ReaderOptions_.UseArena) {
+        PrepareArena(false);
+        row = RowFactory_->NewArenaRow(typeName, Arenas_[CurrentArena_]);
+        ++CurrentArenaRows_;
+    } else {
+        row = RowFactory_->NewRow(typeName);
+    }
+
     Underlying_->ReadRow(row->RawMessage());
     return std::move(row);
 }
 
+size_t TProtobufRowReader::ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                                    std::vector<TReadingContext>* contexts) {
+    if (contexts) {
+        contexts->clear();
+    }
+
+    if (ReaderOptions_.UseArena) {
+        // Rows of the previous batch are released, so their arena may be reset
+        rows.clear();
+        PrepareArena(true);
+    }
+
+    size_t count = 0;
+    for (; count < maxCount && Underlying_->IsValid(); ++count, Next()) {
+        if (ReaderOptions_.UseArena) {
+            auto row = RowFactory_->NewArenaRow(TypeNames_[ReadingContext_.TableIndex], Arenas_[CurrentArena_]);
+            Underlying_->ReadRow(row->RawMessage());
+            rows.push_back(std::move(row));
+
+            if (contexts) {
+                contexts->push_back(ReadingContext_);
+            }
+            continue;
+        }
+
+        if (count == rows.size()) {
+            rows.emplace_back();
+        }
+
+        auto& row = rows[count];
+        auto* protobufRow = row.use_count() == 1 ? dynamic_cast<TProtobufRow*>(row.get()) : nullptr;
+
+        // Message of the same type is parsed in place, so its memory is reused
+        if (protobufRow && !protobufRow->IsMessageShared() &&
+            protobufRow->Accessors()->MessageDescriptor() == Descriptors_[ReadingContext_.TableIndex]) {
+            protobufRow->RawMessage()->Clear();
+            Underlying_->ReadRow(protobufRow->RawMessage());
+        } else {
+            row = ReadRow();
+        }
+
+        if (contexts) {
+            contexts->push_back(ReadingContext_);
+        }
+    }
+
+    rows.resize(count);
+    return count;
+}
+
 std::unique_ptr<Message> TProtobufRowReader::ReadRawMessage() {
     auto message = RowFactory_->NewRawMessage(TypeNames_[Underlying_->GetTableIndex()]);
     Underlying_->ReadRow(message.get());
@@ -74,6 +157,44 @@ std::shared_ptr<TProtobufRowFactory> TProtobufRowReader::RowFactory() const {
     return RowFactory_;
 }
 
+void TProtobufRowReader::PrepareArena(bool newBatch) {
+    // Rows share ownership of the arena they are allocated on
+    auto isFree = [] (const std::shared_ptr<Arena>& arena) {
+        return arena.use_count() == 1;
+    };
+
+    if (!Arenas_.empty()) {
+        // Rows read one by one are usually gone by the next one, so resetting the arena for each
+        // of them would free its blocks and allocate them again for every row
+        if (!newBatch && CurrentArenaRows_ < ReaderOptions_.ArenaRowsLimit) {
+            return;
+        }
+
+        if (isFree(Arenas_[CurrentArena_])) {
+            Arenas_[CurrentArena_]->Reset();
+            CurrentArenaRows_ = 0;
+            return;
+        }
+
+        if (!newBatch) {
+            // Rows read one by one may be kept by the job for long, so their arena isn't waited for
+            Arenas_.erase(Arenas_.begin() + CurrentArena_);
+        }
+    }
+
+    auto it = std::find_if(Arenas_.begin(), Arenas_.end(), isFree);
+    if (it != Arenas_.end()) {
+        (*it)->Reset();
+    } else {
+        ArenaOptions options;
+        options.start_block_size = ReaderOptions_.ArenaBlockSize;
+        it = Arenas_.insert(Arenas_.end(), std::make_shared<Arena>(options));
+    }
+
+    CurrentArena_ = it - Arenas_.begin();
+    CurrentArenaRows_ = 0;
+}
+
 void TProtobufRowReader::RefreshReadingContext() {
     if (Underlying_->IsValid())
         ReadingContext_ = {Underlying_->GetTableIndex(), Underlying_->GetRowIndex(), Underlying_->GetRangeIndex(), {}};
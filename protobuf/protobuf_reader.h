@@ -10,18 +10,43 @@ using namespace NYT;
 
 namespace DFormats {
 
+struct TProtobufReaderOptions {
+    // Messages of rows are allocated on arenas instead of the heap. ReadRow() fills an arena with
+    // ArenaRowsLimit rows before resetting it, and each ReadRows() call fills an arena free of rows
+    // of previous batches. A row kept alive holds the memory of its whole arena
+    bool UseArena = false;
+
+    // Size of the first block of each arena
+    size_t ArenaBlockSize = 1 << 16;
+
+    // Number of rows ReadRow() allocates on an arena before resetting it. If some of the rows are
+    // still referenced then, the arena is left to them and freed with the last of them
+    size_t ArenaRowsLimit = 1024;
+
+    // ReadRow() parses rows into one message per table, cleared before each row so it keeps memory
+    // of strings and repeated fields. A row still referenced when the next one is read, directly or
+    // through views of its nested fields, is left to its owner and replaced. Takes precedence over
+    // UseArena for ReadRow()
+    bool ReuseRows = false;
+};
+
 class TProtobufRowReader : public IRowReader {
 public:
     TProtobufRowReader(::TIntrusivePtr<TRawTableReader> input,
-        std::shared_ptr<TProtobufRowFactory> rowFactory, std::vector<std::string> typesNames);
+        std::shared_ptr<TProtobufRowFactory> rowFactory, std::vector<std::string> typesNames,
+        TProtobufReaderOptions readerOptions = {});
     TProtobufRowReader(::TIntrusivePtr<TRawTableReader> input,
-        std::shared_ptr<TProtobufRowFactory> rowFactory, const std::vector<size_t>& inputTypesNumbers);
+        std::shared_ptr<TProtobufRowFactory> rowFactory, const std::vector<size_t>& inputTypesNumbers,
+        TProtobufReaderOptions readerOptions = {});
 
     TProtobufRowReader(TProtobufRowReader&& rhs) = default;
     TProtobufRowReader& operator=(TProtobufRowReader&& rhs) = default;
 
     std::unique_ptr<Message> ReadRawMessage();
     IRowPtr ReadRow() override;
+    size_t ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                    std::vector<TReadingContext>* contexts) override;
+    using IRowReader::ReadRows;
 
     bool IsValid() const override;
     bool IsEndOfStream() const override;
@@ -37,11 +62,23 @@ public:
 private:
     void RefreshReadingContext();
 
+    // Makes current an arena which may be used for the next rows. With newBatch or after
+    // ArenaRowsLimit rows the arena is reset if its rows are gone or replaced with another one
+    // otherwise
+    void PrepareArena(bool newBatch);
+
 private:
     std::unique_ptr<TLenvalProtoTableReader> Underlying_;
     std::shared_ptr<TProtobufRowFactory> RowFactory_;
     std::vector<std::string> TypeNames_;
+    std::vector<const Descriptor*> Descriptors_;
     TReadingContext ReadingContext_;
+    TProtobufReaderOptions ReaderOptions_;
+
+    std::vector<std::shared_ptr<TProtobufRow>> ReusedRows_;  // Rows returned with ReuseRows, per table
+    std::vector<std::shared_ptr<Arena>> Arenas_;
+    size_t CurrentArena_ = 0;
+    size_t CurrentArenaRows_ = 0;  // Rows allocated on the current arena since it was reset
 };
 
 }
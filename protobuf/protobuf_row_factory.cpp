@@ -29,13 +29,39 @@ TProtobufRowFactory::TProtobufRowFactory(std::vector<NYT::TTableSchema> tableSch
     for (const auto& typeName : TypeNames_) {
         Types_[typeName] = std::make_pair<NYT::TTableSchema, const Descriptor*>(
             std::move(schemaMap[typeName]), DescriptorPool_->FindMessageTypeByName(typeName));
+        BuildAccessorTable(GetDescriptor(typeName));
     }
 }
 
+const TProtobufAccessorTable* TProtobufRowFactory::BuildAccessorTable(const Descriptor* descriptor) {
+    auto it = AccessorTables_.find(descriptor);
+    if (it != AccessorTables_.end()) {
+        return it->second.get();
+    }
+
+    auto* table = AccessorTables_.emplace(descriptor, std::make_unique<TProtobufAccessorTable>(
+        descriptor, MessageFactory_->GetPrototype(descriptor)->GetReflection())).first->second.get();
+
+    for (auto& field : table->Fields_) {
+        if (field.CppType == FieldDescriptor::CppType::CPPTYPE_MESSAGE) {
+            field.Nested = BuildAccessorTable(field.Descriptor->message_type());
+        }
+    }
+
+    return table;
+}
+
 const Descriptor* TProtobufRowFactory::GetDescriptor(const std::string& typeName) const {
     return Types_.at(typeName).second;
 }
 
+const TProtobufAccessorTable* TProtobufRowFactory::GetAccessorTable(const Descriptor* descriptor) const {
+    auto it = AccessorTables_.find(descriptor);
+    Y_ENSURE(it != AccessorTables_.end(), "Message " << descriptor->name() << " is not created by the factory");
+
+    return it->second.get();
+}
+
 const NYT::TTableSchema& TProtobufRowFactory::GetTableSchema(const std::string& typeName) const {
     return Types_.at(typeName).first;
 }
@@ -53,7 +79,20 @@ std::unique_ptr<Message> TProtobufRowFactory::NewRawMessage(const std::string& t
 }
 
 std::unique_ptr<TProtobufRow> TProtobufRowFactory::NewRow(const std::string& typeName) const {
-    return std::make_unique<TProtobufRow>(NewRawMessage(typeName), RawMessageFactory());
+    return std::make_unique<TProtobufRow>(NewRawMessage(typeName), RawMessageFactory(),
+                                          GetAccessorTable(GetDescriptor(typeName)));
+}
+
+std::shared_ptr<Message> TProtobufRowFactory::NewArenaMessage(const std::string& typeName,
+                                                              const std::shared_ptr<Arena>& arena) const {
+    // Arena owns the message, so the pointer only keeps the arena alive and deletes nothing
+    return std::shared_ptr<Message>(arena, MessageFactory_->GetPrototype(GetDescriptor(typeName))->New(arena.get()));
+}
+
+std::unique_ptr<TProtobufRow> TProtobufRowFactory::NewArenaRow(const std::string& typeName,
+                                                               const std::shared_ptr<Arena>& arena) const {
+    return std::make_unique<TProtobufRow>(NewArenaMessage(typeName, arena), RawMessageFactory(),
+                                          GetAccessorTable(GetDescriptor(typeName)));
 }
 
 const std::unique_ptr<::DescriptorPool>& TProtobufRowFactory::DescriptorPool() const {
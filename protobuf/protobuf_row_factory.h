@@ -2,6 +2,8 @@
 
 #include <unordered_map>
 
+#include <google/protobuf/arena.h>
+
 #include "protobuf_types.h"
 #include "protobuf_schema.h"
 
@@ -18,6 +20,8 @@ public:
     TProtobufRowFactory& operator=(TProtobufRowFactory&&) = default;
 
     const Descriptor* GetDescriptor(const std::string& typeName) const;
+    // Table of the type's fields, shared by all objects of the type. Lives as long as the factory
+    const TProtobufAccessorTable* GetAccessorTable(const Descriptor* descriptor) const;
     const NYT::TTableSchema& GetTableSchema(const std::string& typeName) const;
     const std::vector<std::string>& TypeNames() const;
 
@@ -26,14 +30,24 @@ public:
     std::unique_ptr<Message> NewRawMessage(const std::string& typeName) const;
     std::unique_ptr<TProtobufRow> NewRow(const std::string& typeName) const;
 
+    // Message is allocated on the arena and the returned pointer shares ownership of the arena,
+    // so the arena outlives every row allocated on it
+    std::shared_ptr<Message> NewArenaMessage(const std::string& typeName, const std::shared_ptr<Arena>& arena) const;
+    std::unique_ptr<TProtobufRow> NewArenaRow(const std::string& typeName, const std::shared_ptr<Arena>& arena) const;
+
 protected:
     const std::unique_ptr<::DescriptorPool>& DescriptorPool() const;
 
 private:
+    // Builds tables of the type and of all its nested types
+    const TProtobufAccessorTable* BuildAccessorTable(const Descriptor* descriptor);
+
     std::unique_ptr<::DescriptorPool> DescriptorPool_;
     std::shared_ptr<DynamicMessageFactory> MessageFactory_;
     std::unordered_map<std::string, std::pair<NYT::TTableSchema, const Descriptor*>> Types_;
     std::vector<std::string> TypeNames_;  // For keeping order
+    // Tables are kept by pointer, so objects' pointers to them survive moves of the factory
+    std::unordered_map<const Descriptor*, std::unique_ptr<TProtobufAccessorTable>> AccessorTables_;
 };
 
 }
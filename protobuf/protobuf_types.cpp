@@ -9,8 +9,8 @@ Message* CopyMessage(const Message& src) {
 }
 
 template <typename IndexType>
-void SetDefaultValue(IBaseIndexed<IndexType>* dst, IndexType ind, const FieldDescriptor* fieldDesc, std::shared_ptr<MessageFactory> messageFactory) {
-    switch (fieldDesc->cpp_type()) {
+void SetDefaultValue(IBaseIndexed<IndexType>* dst, IndexType ind, const TProtobufFieldAccessor& field, std::shared_ptr<MessageFactory> messageFactory) {
+    switch (field.CppType) {
     case FieldDescriptor::CppType::CPPTYPE_INT32:
         dst->template SetValue<int32_t>(ind, 0);
         break;
@@ -37,8 +37,8 @@ void SetDefaultValue(IBaseIndexed<IndexType>* dst, IndexType ind, const FieldDes
         break;
     case FieldDescriptor::CppType::CPPTYPE_MESSAGE:
     {
-        std::shared_ptr<Message> msg(messageFactory->GetPrototype(fieldDesc->message_type())->New());
-        dst->template SetValue<IStructPtr>(ind, std::make_shared<TProtobufStruct>(msg, messageFactory));
+        std::shared_ptr<Message> msg(messageFactory->GetPrototype(field.Descriptor->message_type())->New());
+        dst->template SetValue<IStructPtr>(ind, std::make_shared<TProtobufStruct>(msg, messageFactory, field.Nested));
         break;
     }
     default:
@@ -46,26 +46,59 @@ void SetDefaultValue(IBaseIndexed<IndexType>* dst, IndexType ind, const FieldDes
     }
 }
 
+// TProtobufAccessorTable
+
+TProtobufAccessorTable::TProtobufAccessorTable(const Descriptor* descriptor, const Reflection* reflection)
+  : Descriptor_(descriptor), Reflection_(reflection) {
+
+    Fields_.reserve(descriptor->field_count());
+
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+        const auto* field = descriptor->field(i);
+
+        Fields_.push_back({field, field->cpp_type(), field->is_repeated(), nullptr});
+        IndexesMap_.emplace(field->name(), i);
+    }
+}
+
+size_t TProtobufAccessorTable::GetIndex(std::string_view name) const {
+    auto it = IndexesMap_.find(name);
+    Y_ENSURE(it != IndexesMap_.end(), "Message " << Descriptor_->name() << " has no field named " << name);
+
+    return it->second;
+}
+
 // TProtobufObject
 
-TProtobufObject::TProtobufObject(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory)
+TProtobufObject::TProtobufObject(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                                 const TProtobufAccessorTable* accessors)
   : Underlying_(underlying)
   , Factory_(factory)
-  , ScratchStrings_(Underlying_->GetDescriptor()->field_count()) { }
+  , Accessors_(accessors)
+  , ScratchStrings_(Accessors_->FieldsCount()) {
+
+    Y_ASSERT(Accessors_->MessageDescriptor() == Underlying_->GetDescriptor());
+}
 
 TProtobufObject::TProtobufObject(const TProtobufObject& rhs)
   : Underlying_(CopyMessage(*rhs.Underlying_))  // Скопировать в новое сообщение
   , Factory_(rhs.Factory_)
-  , ScratchStrings_(Underlying_->GetDescriptor()->field_count()) { }
+  , Accessors_(rhs.Accessors_)
+  , RepeatedField_(rhs.RepeatedField_)
+  , ScratchStrings_(Accessors_->FieldsCount()) { }
 
 TProtobufObject::TProtobufObject(TProtobufObject&& rhs)
   : Underlying_(std::move(rhs.Underlying_))
   , Factory_(std::move(rhs.Factory_))
+  , Accessors_(rhs.Accessors_)
+  , RepeatedField_(rhs.RepeatedField_)
   , ScratchStrings_(std::move(rhs.ScratchStrings_)) { }
     
 TProtobufObject& TProtobufObject::operator=(const TProtobufObject& rhs) {
     Underlying_.reset(CopyMessage(*rhs.Underlying_));
     Factory_ = rhs.Factory_;
+    Accessors_ = rhs.Accessors_;
+    RepeatedField_ = rhs.RepeatedField_;
     ScratchStrings_ = rhs.ScratchStrings_;
 
     return *this;
@@ -74,6 +107,8 @@ TProtobufObject& TProtobufObject::operator=(const TProtobufObject& rhs) {
 TProtobufObject& TProtobufObject::operator=(TProtobufObject&& rhs){
     Underlying_ = std::move(rhs.Underlying_);
     Factory_ = std::move(rhs.Factory_);
+    Accessors_ = rhs.Accessors_;
+    RepeatedField_ = rhs.RepeatedField_;
     ScratchStrings_ = std::move(rhs.ScratchStrings_);
 
     return *this;
@@ -88,13 +123,24 @@ const Message* TProtobufObject::RawMessage() const {
 }
 
 Message* TProtobufObject::RawMessage() {
+    // Views alias nested messages, so modifying a viewed message could free them under the views.
+    // The object gets a copy instead and views keep the old message. Nested messages on an arena
+    // live until it's reset, so arena messages are modified in place
+    if (IsMessageShared() && !Underlying_->GetArena()) {
+        Underlying_.reset(CopyMessage(*Underlying_));
+    }
+
     return Underlying_.get();
 }
 
+bool TProtobufObject::IsMessageShared() const {
+    return Underlying_.use_count() > 1;
+}
+
 bool TProtobufObject::GetBool(size_t ind) const {
-    return !IsRepeated()
-           ? GetReflection()->GetBool(*RawMessage(), GetFieldDescriptor(ind))
-           : GetReflection()->GetRepeatedBool(*RawMessage(), GetFieldDescriptor(0), ind);
+    return !RepeatedField_
+           ? GetReflection()->GetBool(*RawMessage(), Field(ind))
+           : GetReflection()->GetRepeatedBool(*RawMessage(), RepeatedField_, ind);
 }
 
 int8_t TProtobufObject::GetInt8(size_t ind) const {
@@ -106,15 +152,15 @@ int16_t TProtobufObject::GetInt16(size_t ind) const {
 }
 
 int32_t TProtobufObject::GetInt32(size_t ind) const {
-    return !IsRepeated()
-           ? GetReflection()->GetInt32(*RawMessage(), GetFieldDescriptor(ind))
-           : GetReflection()->GetRepeatedInt32(*RawMessage(), GetFieldDescriptor(0), ind);
+    return !RepeatedField_
+           ? GetReflection()->GetInt32(*RawMessage(), Field(ind))
+           : GetReflection()->GetRepeatedInt32(*RawMessage(), RepeatedField_, ind);
 }
 
 int64_t TProtobufObject::GetInt64(size_t ind) const {
-    return !IsRepeated()
-           ? GetReflection()->GetInt64(*RawMessage(), GetFieldDescriptor(ind))
-           : GetReflection()->GetRepeatedInt64(*RawMessage(), GetFieldDescriptor(0), ind);
+    return !RepeatedField_
+           ? GetReflection()->GetInt64(*RawMessage(), Field(ind))
+           : GetReflection()->GetRepeatedInt64(*RawMessage(), RepeatedField_, ind);
 }
 
 uint8_t TProtobufObject::GetUInt8(size_t ind) const {
@@ -126,41 +172,37 @@ uint16_t TProtobufObject::GetUInt16(size_t ind) const {
 }
 
 uint32_t TProtobufObject::GetUInt32(size_t ind) const {
-    return !IsRepeated()
-           ? GetReflection()->GetUInt32(*RawMessage(), GetFieldDescriptor(ind))
-           : GetReflection()->GetRepeatedUInt32(*RawMessage(), GetFieldDescriptor(0), ind);
+    return !RepeatedField_
+           ? GetReflection()->GetUInt32(*RawMessage(), Field(ind))
+           : GetReflection()->GetRepeatedUInt32(*RawMessage(), RepeatedField_, ind);
 }
 
 uint64_t TProtobufObject::GetUInt64(size_t ind) const {
-    return !IsRepeated()
-           ? GetReflection()->GetUInt64(*RawMessage(), GetFieldDescriptor(ind))
-           : GetReflection()->GetRepeatedUInt64(*RawMessage(), GetFieldDescriptor(0), ind);
+    return !RepeatedField_
+           ? GetReflection()->GetUInt64(*RawMessage(), Field(ind))
+           : GetReflection()->GetRepeatedUInt64(*RawMessage(), RepeatedField_, ind);
 }
 
 float TProtobufObject::GetFloat(size_t ind) const {
-    return !IsRepeated()
-           ? GetReflection()->GetFloat(*RawMessage(), GetFieldDescriptor(ind))
-           : GetReflection()->GetRepeatedFloat(*RawMessage(), GetFieldDescriptor(0), ind);
+    return !RepeatedField_
+           ? GetReflection()->GetFloat(*RawMessage(), Field(ind))
+           : GetReflection()->GetRepeatedFloat(*RawMessage(), RepeatedField_, ind);
 }
 
 double TProtobufObject::GetDouble(size_t ind) const {
-    return !IsRepeated()
-           ? GetReflection()->GetDouble(*RawMessage(), GetFieldDescriptor(ind))
-           : GetReflection()->GetRepeatedDouble(*RawMessage(), GetFieldDescriptor(0), ind);
+    return !RepeatedField_
+           ? GetReflection()->GetDouble(*RawMessage(), Field(ind))
+           : GetReflection()->GetRepeatedDouble(*RawMessage(), RepeatedField_, ind);
 }
 
 std::string_view TProtobufObject::GetString(size_t ind) const {
-    return !IsRepeated()
-           ? GetReflection()->GetStringReference(*RawMessage(), GetFieldDescriptor(ind), GetScratchString(ind))
-           : GetReflection()->GetRepeatedStringReference(*RawMessage(), GetFieldDescriptor(0), ind, GetScratchString(ind));
+    return !RepeatedField_
+           ? GetReflection()->GetStringReference(*RawMessage(), Field(ind), GetScratchString(ind))
+           : GetReflection()->GetRepeatedStringReference(*RawMessage(), RepeatedField_, ind, GetScratchString(ind));
 }
 
 IStructConstPtr TProtobufObject::GetStruct(size_t ind) const {
-    const auto& data = !IsRepeated()
-                       ? GetReflection()->GetMessage(*RawMessage(), GetFieldDescriptor(ind), Factory().get())
-                       : GetReflection()->GetRepeatedMessage(*RawMessage(), GetFieldDescriptor(0), ind);
-
-    return std::make_shared<TProtobufStruct>(std::shared_ptr<Message>(CopyMessage(data)), Factory());
+    return std::make_shared<TProtobufStruct>(GetSubMessage(ind), Factory(), ElementAccessor(ind).Nested);
 }
 
 ITupleConstPtr TProtobufObject::GetTuple(size_t) const {
@@ -168,30 +210,26 @@ ITupleConstPtr TProtobufObject::GetTuple(size_t) const {
 }
 
 IListConstPtr TProtobufObject::GetList(size_t ind) const {
-    return std::make_shared<TProtobufList>(GetMessage(), Factory(), ind);
+    return std::make_shared<TProtobufList>(GetMessage(), Factory(), Accessors_, ind);
 }
 
 IDictConstPtr TProtobufObject::GetDict(size_t ind) const {
-    return std::make_shared<TProtobufDict>(GetMessage(), Factory(), ind);
+    return std::make_shared<TProtobufDict>(GetMessage(), Factory(), Accessors_, ind);
 }
 
 IVariantConstPtr TProtobufObject::GetVariant(size_t ind) const {
-    const auto& data = !IsRepeated()
-                       ? GetReflection()->GetMessage(*RawMessage(), GetFieldDescriptor(ind), Factory().get())
-                       : GetReflection()->GetRepeatedMessage(*RawMessage(), GetFieldDescriptor(0), ind);
-
-    return std::make_shared<TProtobufVariant>(std::shared_ptr<Message>(CopyMessage(data)), Factory());
+    return std::make_shared<TProtobufVariant>(GetSubMessage(ind), Factory(), ElementAccessor(ind).Nested);
 }
 
 IOptionalConstPtr TProtobufObject::GetOptional(size_t ind) const {
-    return std::make_shared<TProtobufOptional>(GetMessage(), Factory(), ind);
+    return std::make_shared<TProtobufOptional>(GetMessage(), Factory(), Accessors_, ind);
 }
 
 void TProtobufObject::SetBool(size_t ind, bool value) {
-    if (!IsRepeated())
-        GetReflection()->SetBool(RawMessage(), GetFieldDescriptor(ind), value);
+    if (!RepeatedField_)
+        GetReflection()->SetBool(RawMessage(), Field(ind), value);
     else
-        GetReflection()->SetRepeatedBool(RawMessage(), GetFieldDescriptor(0), ind, value);
+        GetReflection()->SetRepeatedBool(RawMessage(), RepeatedField_, ind, value);
 }
 
 void TProtobufObject::SetInt8(size_t ind, int8_t value) {
@@ -203,17 +241,17 @@ void TProtobufObject::SetInt16(size_t ind, int16_t value) {
 }
 
 void TProtobufObject::SetInt32(size_t ind, int32_t value) {
-    if (!IsRepeated())
-        GetReflection()->SetInt32(RawMessage(), GetFieldDescriptor(ind), value);
+    if (!RepeatedField_)
+        GetReflection()->SetInt32(RawMessage(), Field(ind), value);
     else
-        GetReflection()->SetRepeatedInt32(RawMessage(), GetFieldDescriptor(0), ind, value);
+        GetReflection()->SetRepeatedInt32(RawMessage(), RepeatedField_, ind, value);
 }
 
 void TProtobufObject::SetInt64(size_t ind, int64_t value) {
-    if (!IsRepeated())
-        GetReflection()->SetInt64(RawMessage(), GetFieldDescriptor(ind), value);
+    if (!RepeatedField_)
+        GetReflection()->SetInt64(RawMessage(), Field(ind), value);
     else
-        GetReflection()->SetRepeatedInt64(RawMessage(), GetFieldDescriptor(0), ind, value);
+        GetReflection()->SetRepeatedInt64(RawMessage(), RepeatedField_, ind, value);
 }
 
 void TProtobufObject::SetUInt8(size_t ind, uint8_t value) {
@@ -225,46 +263,46 @@ void TProtobufObject::SetUInt16(size_t ind, uint16_t value) {
 }
 
 void TProtobufObject::SetUInt32(size_t ind, uint32_t value) {
-    if (!IsRepeated())
-        GetReflection()->SetUInt32(RawMessage(), GetFieldDescriptor(ind), value);
+    if (!RepeatedField_)
+        GetReflection()->SetUInt32(RawMessage(), Field(ind), value);
     else
-        GetReflection()->SetRepeatedUInt32(RawMessage(), GetFieldDescriptor(0), ind, value);
+        GetReflection()->SetRepeatedUInt32(RawMessage(), RepeatedField_, ind, value);
 }
 
 void TProtobufObject::SetUInt64(size_t ind, uint64_t value) {
-    if (!IsRepeated())
-        GetReflection()->SetUInt64(RawMessage(), GetFieldDescriptor(ind), value);
+    if (!RepeatedField_)
+        GetReflection()->SetUInt64(RawMessage(), Field(ind), value);
     else
-        GetReflection()->SetRepeatedUInt64(RawMessage(), GetFieldDescriptor(0), ind, value);
+        GetReflection()->SetRepeatedUInt64(RawMessage(), RepeatedField_, ind, value);
 }
 
 void TProtobufObject::SetFloat(size_t ind, float value) {
-    if (!IsRepeated())
-        GetReflection()->SetFloat(RawMessage(), GetFieldDescriptor(ind), value);
+    if (!RepeatedField_)
+        GetReflection()->SetFloat(RawMessage(), Field(ind), value);
     else
-        GetReflection()->SetRepeatedFloat(RawMessage(), GetFieldDescriptor(0), ind, value);
+        GetReflection()->SetRepeatedFloat(RawMessage(), RepeatedField_, ind, value);
 }
 
 void TProtobufObject::SetDouble(size_t ind, double value) {
-    if (!IsRepeated())
-        GetReflection()->SetDouble(RawMessage(), GetFieldDescriptor(ind), value);
+    if (!RepeatedField_)
+        GetReflection()->SetDouble(RawMessage(), Field(ind), value);
     else
-        GetReflection()->SetRepeatedDouble(RawMessage(), GetFieldDescriptor(0), ind, value);
+        GetReflection()->SetRepeatedDouble(RawMessage(), RepeatedField_, ind, value);
 }
 
 void TProtobufObject::SetString(size_t ind, std::string_view value) {
-    if (!IsRepeated())
-        GetReflection()->SetString(RawMessage(), GetFieldDescriptor(ind), TString(value));
+    if (!RepeatedField_)
+        GetReflection()->SetString(RawMessage(), Field(ind), TString(value));
     else
-        GetReflection()->SetRepeatedString(RawMessage(), GetFieldDescriptor(0), ind, TString(value));
+        GetReflection()->SetRepeatedString(RawMessage(), RepeatedField_, ind, TString(value));
 }
 
 void TProtobufObject::SetStruct(size_t ind, IStructConstPtr value) {
     auto data = std::dynamic_pointer_cast<const TProtobufStruct>(value)->RawMessage();
-    if (!IsRepeated())
-        GetReflection()->MutableMessage(RawMessage(), GetFieldDescriptor(ind), Factory().get())->CopyFrom(*data);
+    if (!RepeatedField_)
+        GetReflection()->MutableMessage(RawMessage(), Field(ind), Factory().get())->CopyFrom(*data);
     else
-        GetReflection()->MutableRepeatedMessage(RawMessage(), GetFieldDescriptor(0), ind)->CopyFrom(*data);
+        GetReflection()->MutableRepeatedMessage(RawMessage(), RepeatedField_, ind)->CopyFrom(*data);
 }
 
 void TProtobufObject::SetTuple(size_t, ITupleConstPtr) {
@@ -283,10 +321,10 @@ void TProtobufObject::SetDict(size_t ind, IDictConstPtr value) {
 
 void TProtobufObject::SetVariant(size_t ind, IVariantConstPtr value) {
     auto data = std::dynamic_pointer_cast<const TProtobufVariant>(value)->RawMessage();
-    if (!IsRepeated())
-        GetReflection()->MutableMessage(RawMessage(), GetFieldDescriptor(ind), Factory().get())->CopyFrom(*data);
+    if (!RepeatedField_)
+        GetReflection()->MutableMessage(RawMessage(), Field(ind), Factory().get())->CopyFrom(*data);
     else
-        GetReflection()->MutableRepeatedMessage(RawMessage(), GetFieldDescriptor(0), ind)->CopyFrom(*data);
+        GetReflection()->MutableRepeatedMessage(RawMessage(), RepeatedField_, ind)->CopyFrom(*data);
 }
 
 void TProtobufObject::SetOptional(size_t ind, IOptionalConstPtr value) {
@@ -295,18 +333,18 @@ void TProtobufObject::SetOptional(size_t ind, IOptionalConstPtr value) {
 }
 
 void TProtobufObject::SetString(size_t ind, std::string&& value) {
-    if (!IsRepeated())
-        GetReflection()->SetString(RawMessage(), GetFieldDescriptor(ind), TString(std::move(value)));
+    if (!RepeatedField_)
+        GetReflection()->SetString(RawMessage(), Field(ind), TString(std::move(value)));
     else
-        GetReflection()->SetRepeatedString(RawMessage(), GetFieldDescriptor(0), ind, TString(std::move(value)));
+        GetReflection()->SetRepeatedString(RawMessage(), RepeatedField_, ind, TString(std::move(value)));
 }
 
 void TProtobufObject::SetStruct(size_t ind, IStructPtr&& value) {
     auto data = std::dynamic_pointer_cast<TProtobufStruct>(value)->RawMessage();
-    if (!IsRepeated())
-        GetReflection()->MutableMessage(RawMessage(), GetFieldDescriptor(ind), Factory().get())->CopyFrom(*data);
+    if (!RepeatedField_)
+        GetReflection()->MutableMessage(RawMessage(), Field(ind), Factory().get())->CopyFrom(*data);
     else
-        GetReflection()->MutableRepeatedMessage(RawMessage(), GetFieldDescriptor(0), ind)->CopyFrom(*data);
+        GetReflection()->MutableRepeatedMessage(RawMessage(), RepeatedField_, ind)->CopyFrom(*data);
 }
 
 void TProtobufObject::SetTuple(size_t, ITuplePtr&&) {
@@ -325,10 +363,10 @@ void TProtobufObject::SetDict(size_t ind, IDictPtr&& value) {
 
 void TProtobufObject::SetVariant(size_t ind, IVariantPtr&& value) {
     auto data = std::dynamic_pointer_cast<TProtobufVariant>(value)->RawMessage();
-    if (!IsRepeated())
-        GetReflection()->MutableMessage(RawMessage(), GetFieldDescriptor(ind), Factory().get())->CopyFrom(*data);
+    if (!RepeatedField_)
+        GetReflection()->MutableMessage(RawMessage(), Field(ind), Factory().get())->CopyFrom(*data);
     else
-        GetReflection()->MutableRepeatedMessage(RawMessage(), GetFieldDescriptor(0), ind)->CopyFrom(*data);
+        GetReflection()->MutableRepeatedMessage(RawMessage(), RepeatedField_, ind)->CopyFrom(*data);
 }
 
 void TProtobufObject::SetOptional(size_t ind, IOptionalPtr&& value) {
@@ -341,17 +379,33 @@ bool TProtobufObject::IsRepeated() const {
 }
 
 const FieldDescriptor* TProtobufObject::GetFieldDescriptor(size_t ind) const {
-    return RawMessage()->GetDescriptor()->field(ind);
+    return Field(ind);
+}
+
+const TProtobufFieldAccessor& TProtobufObject::ElementAccessor(size_t ind) const {
+    // Elements of a list are of the type of its field
+    return Accessors_->Field(RepeatedField_ ? RepeatedField_->index() : ind);
 }
 
-const Reflection* TProtobufObject::GetReflection() const {
-    return RawMessage()->GetReflection();
+void TProtobufObject::SetRepeatedField(size_t ind) {
+    Y_ASSERT(Accessors_->Field(ind).Repeated);
+    RepeatedField_ = Field(ind);
 }
 
 std::shared_ptr<Message> TProtobufObject::GetMessage() const {
     return Underlying_;
 }
 
+std::shared_ptr<Message> TProtobufObject::GetSubMessage(size_t ind) const {
+    const auto& data = !RepeatedField_
+                       ? GetReflection()->GetMessage(*RawMessage(), Field(ind), Factory().get())
+                       : GetReflection()->GetRepeatedMessage(*RawMessage(), RepeatedField_, ind);
+
+    // Views are const, so they may alias the sub-message. Sharing ownership of the root keeps it alive
+    // and prevents readers from reusing the row while the view exists
+    return std::shared_ptr<Message>(Underlying_, const_cast<Message*>(&data));
+}
+
 TString* TProtobufObject::GetScratchString(size_t ind) const {
     if (!ScratchStrings_[ind].has_value()) {
         ScratchStrings_[ind].emplace();
@@ -366,36 +420,26 @@ std::shared_ptr<MessageFactory> TProtobufObject::Factory() const {
 
 // TProtobufStruct
 
-TProtobufStruct::TProtobufStruct(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory)
-  : TProtobufObject(underlying, factory) { }
+TProtobufStruct::TProtobufStruct(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                                 const TProtobufAccessorTable* accessors)
+  : TProtobufObject(underlying, factory, accessors) { }
 
-TProtobufStruct::TProtobufStruct(const TProtobufStruct& rhs)
-  : TProtobufObject(rhs), IndexesMap_(rhs.IndexesMap_) { }
+TProtobufStruct::TProtobufStruct(const TProtobufStruct& rhs) : TProtobufObject(rhs) { }
 
-TProtobufStruct::TProtobufStruct(TProtobufStruct&& rhs)
-  : TProtobufObject(static_cast<TProtobufObject&&>(rhs)), IndexesMap_(std::move(rhs.IndexesMap_)) { }
+TProtobufStruct::TProtobufStruct(TProtobufStruct&& rhs) : TProtobufObject(static_cast<TProtobufObject&&>(rhs)) { }
 
 TProtobufStruct& TProtobufStruct::operator=(const TProtobufStruct& rhs) {
     TProtobufObject::operator=(rhs);
-    IndexesMap_ = rhs.IndexesMap_;
-
     return *this;
 }
 
 TProtobufStruct& TProtobufStruct::operator=(TProtobufStruct&& rhs) {
     TProtobufObject::operator=(static_cast<TProtobufObject&&>(rhs));
-    IndexesMap_ = std::move(rhs.IndexesMap_);
-    
     return *this;
 }
 
 size_t TProtobufStruct::GetIndex(std::string_view ind) const {
-    std::string name(ind);
-
-    if (!IndexesMap_.contains(name)) {
-        IndexesMap_[name] = RawMessage()->GetDescriptor()->FindFieldByName(name)->index();
-    }
-    return IndexesMap_[name];
+    return Accessors()->GetIndex(ind);
 }
 
 IStructPtr TProtobufStruct::CopyStruct() const {
@@ -403,13 +447,11 @@ IStructPtr TProtobufStruct::CopyStruct() const {
 }
 
 std::vector<std::string> TProtobufStruct::FieldsNames() const {
-    auto descriptor = RawMessage()->GetDescriptor();
-
     std::vector<std::string> res;
-    res.reserve(descriptor->field_count());
+    res.reserve(Accessors()->FieldsCount());
 
-    for (int i = 0; i < descriptor->field_count(); ++i) {
-        res.emplace_back(descriptor->field(i)->name());
+    for (size_t i = 0; i < Accessors()->FieldsCount(); ++i) {
+        res.emplace_back(Field(i)->name());
     }
 
     return res;
@@ -417,8 +459,9 @@ std::vector<std::string> TProtobufStruct::FieldsNames() const {
 
 // TProtobufVariant
 
-TProtobufVariant::TProtobufVariant(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory)
-  : TProtobufObject(underlying, factory), TProtobufStruct(underlying, factory) { }
+TProtobufVariant::TProtobufVariant(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                                   const TProtobufAccessorTable* accessors)
+  : TProtobufObject(underlying, factory, accessors), TProtobufStruct(underlying, factory, accessors) { }
 
 TProtobufVariant::TProtobufVariant(const TProtobufVariant& rhs)
   : TProtobufObject(rhs), TProtobufStruct(rhs) { }
@@ -442,23 +485,24 @@ IVariantPtr TProtobufVariant::CopyVariant() const {
 }
 
 size_t TProtobufVariant::VariantsCount() const {
-    return RawMessage()->GetDescriptor()->field_count();
+    return Accessors()->FieldsCount();
 }
 
 size_t TProtobufVariant::VariantNumber() const {
-    auto oneofDesc = RawMessage()->GetDescriptor()->oneof_decl(0);
+    auto oneofDesc = Accessors()->MessageDescriptor()->oneof_decl(0);
     auto currentField = GetReflection()->GetOneofFieldDescriptor(*RawMessage(), oneofDesc);
     return currentField->index();
 }
 
 void TProtobufVariant::EmplaceVariant(size_t number) {
-    SetDefaultValue(dynamic_cast<IBaseIndexed<size_t>*>(this), number, GetFieldDescriptor(number), Factory());
+    SetDefaultValue(dynamic_cast<IBaseIndexed<size_t>*>(this), number, Accessors()->Field(number), Factory());
 }
 
 // TProtobufOptional
 
-TProtobufOptional::TProtobufOptional(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory, size_t fieldIndex)
-  : TProtobufObject(underlying, factory), FieldIndex_(fieldIndex) { }
+TProtobufOptional::TProtobufOptional(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                                     const TProtobufAccessorTable* accessors, size_t fieldIndex)
+  : TProtobufObject(underlying, factory, accessors), FieldIndex_(fieldIndex) { }
 
 TProtobufOptional::TProtobufOptional(const TProtobufOptional& rhs)
   : TProtobufObject(rhs), FieldIndex_(rhs.FieldIndex_) { }
@@ -497,13 +541,16 @@ void TProtobufOptional::ClearValue() {
 }
 
 void TProtobufOptional::EmplaceValue() {
-    SetDefaultValue(dynamic_cast<IBaseIndexed<size_t>*>(this), GetIndex(0), GetFieldDescriptor(GetIndex(0)), Factory());
+    SetDefaultValue(dynamic_cast<IBaseIndexed<size_t>*>(this), GetIndex(0), Accessors()->Field(GetIndex(0)), Factory());
 }
 
 // TProtobufList
 
-TProtobufList::TProtobufList(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory, size_t fieldIndex)
-  : TProtobufObject(underlying, factory), FieldIndex_(fieldIndex) { }
+TProtobufList::TProtobufList(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                             const TProtobufAccessorTable* accessors, size_t fieldIndex)
+  : TProtobufObject(underlying, factory, accessors), FieldIndex_(fieldIndex) {
+    SetRepeatedField(fieldIndex);
+}
 
 TProtobufList::TProtobufList(const TProtobufList& rhs)
   : TProtobufObject(rhs), FieldIndex_(rhs.FieldIndex_) { }
@@ -542,9 +589,10 @@ void TProtobufList::PopBack() {
 }
 
 void TProtobufList::Extend() {
-    auto fieldDesc = GetFieldDescriptor(FieldIndex());
+    const auto& field = Accessors()->Field(FieldIndex());
+    const auto* fieldDesc = field.Descriptor;
 
-    switch (fieldDesc->cpp_type()) {
+    switch (field.CppType) {
     case FieldDescriptor::CppType::CPPTYPE_INT32:
         GetReflection()->AddInt32(RawMessage(), fieldDesc, 0);
         break;
@@ -587,8 +635,9 @@ bool TProtobufList::IsRepeated() const {
 
 // TProtobufDict
 
-TProtobufDict::TProtobufDict(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory, size_t fieldIndex)
-  : TProtobufObject(underlying, factory), TProtobufList(underlying, factory, fieldIndex) { }
+TProtobufDict::TProtobufDict(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                             const TProtobufAccessorTable* accessors, size_t fieldIndex)
+  : TProtobufObject(underlying, factory, accessors), TProtobufList(underlying, factory, accessors, fieldIndex) { }
 
 TProtobufDict::TProtobufDict(const TProtobufDict& rhs) : TProtobufObject(rhs), TProtobufList(rhs) { }
 
@@ -608,8 +657,9 @@ TProtobufDict& TProtobufDict::operator=(TProtobufDict&& rhs) {
 
 // TProtobufRow
 
-TProtobufRow::TProtobufRow(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory)
-  : TProtobufObject(underlying, factory), TProtobufStruct(underlying, factory) { }
+TProtobufRow::TProtobufRow(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                           const TProtobufAccessorTable* accessors)
+  : TProtobufObject(underlying, factory, accessors), TProtobufStruct(underlying, factory, accessors) { }
 
 TProtobufRow::TProtobufRow(const TProtobufRow& rhs) : TProtobufObject(rhs), TProtobufStruct(rhs) { }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <optional>
@@ -25,10 +26,54 @@ class TProtobufList;
 class TProtobufDict;
 class TProtobufVariant;
 class TProtobufOptional;
+class TProtobufAccessorTable;
+
+struct TProtobufFieldAccessor {
+    const FieldDescriptor* Descriptor;
+    FieldDescriptor::CppType CppType;
+    bool Repeated;
+    const TProtobufAccessorTable* Nested;  // Table of the field's message type, null for other fields
+};
+
+// Fields of a message type by index together with the type's reflection. Built once per type
+// by TProtobufRowFactory and shared by all objects of the type, so they access fields without
+// virtual calls to the message and lookups in its descriptor
+class TProtobufAccessorTable {
+public:
+    TProtobufAccessorTable(const Descriptor* descriptor, const Reflection* reflection);
+
+    inline const Descriptor* MessageDescriptor() const {
+        return Descriptor_;
+    }
+
+    inline const Reflection* MessageReflection() const {
+        return Reflection_;
+    }
+
+    inline size_t FieldsCount() const {
+        return Fields_.size();
+    }
+
+    inline const TProtobufFieldAccessor& Field(size_t ind) const {
+        return Fields_[ind];
+    }
+
+    size_t GetIndex(std::string_view name) const;
+
+private:
+    // Tables of nested types are set by the factory once they are built
+    friend class TProtobufRowFactory;
+
+    const Descriptor* Descriptor_;
+    const Reflection* Reflection_;
+    std::vector<TProtobufFieldAccessor> Fields_;
+    std::unordered_map<std::string_view, size_t> IndexesMap_;  // Keys point into the descriptor
+};
 
 class TProtobufObject : virtual public IBaseIndexed<size_t> {
 public:
-    TProtobufObject(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory);
+    TProtobufObject(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                    const TProtobufAccessorTable* accessors);
 
     TProtobufObject(const TProtobufObject& rhs);
     TProtobufObject(TProtobufObject&& rhs);
@@ -40,8 +85,16 @@ public:
 
     std::shared_ptr<Message> Release();
     const Message* RawMessage() const;
+    // Message for modification. A message shared with views of its nested fields is copied first
     Message* RawMessage();
 
+    inline const TProtobufAccessorTable* Accessors() const {
+        return Accessors_;
+    }
+
+    // Whether the message is referenced by other objects too, e.g. by views of its nested fields
+    bool IsMessageShared() const;
+
 protected:
     bool GetBool(size_t ind) const override;
     int8_t GetInt8(size_t ind) const override;
@@ -92,20 +145,37 @@ protected:
 protected:
     virtual bool IsRepeated() const;
     virtual const FieldDescriptor* GetFieldDescriptor(size_t ind) const;
-    const Reflection* GetReflection() const;
+
+    inline const Reflection* GetReflection() const {
+        return Accessors_->MessageReflection();
+    }
+    inline const FieldDescriptor* Field(size_t ind) const {
+        return Accessors_->Field(ind).Descriptor;
+    }
+    // Accessor of the field, or of the repeated field for list elements
+    const TProtobufFieldAccessor& ElementAccessor(size_t ind) const;
+
     std::shared_ptr<Message> GetMessage() const;
+    // Nested message of the field, not copied. Must be exposed as const only
+    std::shared_ptr<Message> GetSubMessage(size_t ind) const;
     TString* GetScratchString(size_t) const;
     std::shared_ptr<MessageFactory> Factory() const;
 
+    // Makes the object access elements of the repeated field instead of fields of the message
+    void SetRepeatedField(size_t ind);
+
 private:
     std::shared_ptr<Message> Underlying_;
     std::shared_ptr<MessageFactory> Factory_;
+    const TProtobufAccessorTable* Accessors_;
+    const FieldDescriptor* RepeatedField_ = nullptr;  // Field whose elements the object accesses
     mutable std::vector<std::optional<TString>> ScratchStrings_;
 };
 
 class TProtobufStruct : virtual public TProtobufObject, virtual public IBaseStruct, virtual public IIndexedProxy<std::string_view, size_t> {
 public:
-    TProtobufStruct(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory);
+    TProtobufStruct(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                    const TProtobufAccessorTable* accessors);
     TProtobufStruct(const TProtobufStruct& rhs);
     TProtobufStruct(TProtobufStruct&& rhs);
 
@@ -117,14 +187,12 @@ public:
 
 protected:
     size_t GetIndex(std::string_view name) const override;
-
-private:
-    mutable std::unordered_map<std::string, size_t> IndexesMap_;
 };
 
 class TProtobufVariant : virtual public TProtobufStruct, virtual public IBaseVariant {
 public:
-    TProtobufVariant(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory);
+    TProtobufVariant(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                     const TProtobufAccessorTable* accessors);
     TProtobufVariant(const TProtobufVariant& rhs);
     TProtobufVariant(TProtobufVariant&& rhs);
 
@@ -139,7 +207,8 @@ public:
 
 class TProtobufOptional : virtual public TProtobufObject, virtual public IBaseOptional, virtual public IIndexedProxy<bool, size_t> {
 public:
-    TProtobufOptional(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory, size_t fieldIndex);
+    TProtobufOptional(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                      const TProtobufAccessorTable* accessors, size_t fieldIndex);
     TProtobufOptional(const TProtobufOptional& rhs);
     TProtobufOptional(TProtobufOptional&& rhs);
 
@@ -161,7 +230,8 @@ private:
 
 class TProtobufList : virtual public TProtobufObject, virtual public IBaseList {
 public:
-    TProtobufList(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory, size_t fieldIndex);
+    TProtobufList(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                  const TProtobufAccessorTable* accessors, size_t fieldIndex);
     TProtobufList(const TProtobufList& rhs);
     TProtobufList(TProtobufList&& rhs);
 
@@ -185,6 +255,7 @@ protected:
     }
     inline void SetFieldIndex(size_t ind) {
         FieldIndex_ = ind;
+        SetRepeatedField(ind);
     }
 
 private:
@@ -193,7 +264,8 @@ private:
 
 class TProtobufDict : virtual public TProtobufList, virtual public IBaseDict {
 public:
-    TProtobufDict(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory, size_t fieldIndex);
+    TProtobufDict(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                  const TProtobufAccessorTable* accessors, size_t fieldIndex);
     TProtobufDict(const TProtobufDict& rhs);
     TProtobufDict(TProtobufDict&& rhs);
 
@@ -212,7 +284,8 @@ private:
 
 class TProtobufRow : virtual public TProtobufStruct, virtual public IBaseRow {
 public:
-    TProtobufRow(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory);
+    TProtobufRow(std::shared_ptr<Message> underlying, std::shared_ptr<MessageFactory> factory,
+                 const TProtobufAccessorTable* accessors);
     TProtobufRow(const TProtobufRow& rhs);
     TProtobufRow(TProtobufRow&& rhs);
 
@@ -231,7 +304,7 @@ private:
         return TProtobufStruct::CopyStruct();
     }
     inline size_t FieldsCount() const override {
-        return GetMessage()->GetDescriptor()->field_count();
+        return Accessors()->FieldsCount();
     }
 };
 
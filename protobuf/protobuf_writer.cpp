@@ -1,4 +1,5 @@
 #include "protobuf_writer.h"
+#include "protobuf_lazy_types.h"
 
 namespace DFormats {
 
@@ -17,28 +18,86 @@ TProtobufRowWriter::TProtobufRowWriter(THolder<IProxyOutput> output,
 
 TProtobufRowWriter::TProtobufRowWriter(THolder<IProxyOutput> output,
     std::shared_ptr<TProtobufRowFactory> rowFactory, std::vector<std::string> typeNames) 
-  : RowFactory_(std::move(rowFactory)), TypeNames_(std::move(typeNames)) {
+  : Underlying_(std::move(output))
+  , RowFactory_(std::move(rowFactory))
+  , TypeNames_(std::move(typeNames))
+  , RowPools_(TypeNames_.size()) {
 
-    TVector<const Descriptor*> descriptors;
-    descriptors.reserve(TypeNames_.size());
+    Descriptors_.reserve(TypeNames_.size());
 
     for (const auto& typeName : TypeNames_) {
-        descriptors.push_back(RowFactory_->GetDescriptor(typeName));
+        Descriptors_.push_back(RowFactory_->GetDescriptor(typeName));
     }
-
-    Underlying_ = std::make_unique<TLenvalProtoTableWriter>(std::move(output), std::move(descriptors));
 }
 
 void TProtobufRowWriter::WriteRow(const IRowConstPtr& row, size_t tableIndex) {
-    Underlying_->AddRow(*std::dynamic_pointer_cast<const TProtobufRow>(row)->RawMessage(), tableIndex);
+    WriteMessage(*row, tableIndex);
 }
 
 void TProtobufRowWriter::WriteRow(IRowPtr&& row, size_t tableIndex) {
-    Underlying_->AddRow(std::move(*std::dynamic_pointer_cast<TProtobufRow>(row)->RawMessage()), tableIndex);
+    WriteMessage(*row, tableIndex);
+    RecycleRow(std::move(row), tableIndex);
+}
+
+void TProtobufRowWriter::WriteMessage(const IBaseRow& row, size_t tableIndex) {
+    // Lazy rows are copied as read unless they are modified, otherwise they are written
+    // through the message they are parsed into
+    const auto* lazyRow = dynamic_cast<const TProtobufLazyRow*>(&row);
+    if (lazyRow) {
+        if (auto data = lazyRow->SerializedData()) {
+            Y_ENSURE(lazyRow->MessageDescriptor() == Descriptors_[tableIndex],
+                     "Row of type " << lazyRow->MessageDescriptor()->full_name() << " can't be written to table " << tableIndex);
+            return WriteRawRow(*data, tableIndex);
+        }
+    }
+
+    const auto& message = lazyRow ? *lazyRow->ProtobufRow().RawMessage()
+                                  : *dynamic_cast<const TProtobufRow&>(row).RawMessage();
+    Y_ENSURE(message.GetDescriptor() == Descriptors_[tableIndex],
+             "Row of type " << message.GetDescriptor()->full_name() << " can't be written to table " << tableIndex);
+
+    // Lenval framing: 32-bit length followed by the message
+    auto* stream = Underlying_->GetStream(tableIndex);
+    const ui32 size = message.ByteSizeLong();
+
+    stream->Write(&size, sizeof(size));
+    Y_ENSURE(message.SerializeToArcadiaStream(stream), "Failed to serialize Protobuf message");
+
+    Underlying_->OnRowFinished(tableIndex);
+}
+
+void TProtobufRowWriter::WriteRawRow(std::string_view data, size_t tableIndex) {
+    auto* stream = Underlying_->GetStream(tableIndex);
+    const ui32 size = data.size();
+
+    stream->Write(&size, sizeof(size));
+    stream->Write(data.data(), data.size());
+
+    Underlying_->OnRowFinished(tableIndex);
+}
+
+void TProtobufRowWriter::RecycleRow(IRowPtr&& row, size_t tableIndex) {
+    if (row.use_count() != 1) {
+        return;
+    }
+
+    auto* protobufRow = dynamic_cast<TProtobufRow*>(row.get());
+    if (!protobufRow) {
+        return;
+    }
+
+    auto* message = protobufRow->RawMessage();
+    if (message->GetDescriptor() != Descriptors_[tableIndex]) {
+        return;
+    }
+
+    // Clear() keeps memory allocated for strings and nested messages
+    message->Clear();
+    RowPools_[tableIndex].Release(std::move(row));
 }
 
 void TProtobufRowWriter::FinishTable(size_t tableIndex) {
-    Underlying_->FinishTable(tableIndex);
+    Underlying_->GetStream(tableIndex)->Finish();
 }
 
 Format TProtobufRowWriter::Format() const {
@@ -46,7 +105,7 @@ Format TProtobufRowWriter::Format() const {
 }
 
 size_t TProtobufRowWriter::GetTablesCount() const {
-    return Underlying_->GetTableCount();
+    return Underlying_->GetStreamCount();
 }
 
 const NYT::TTableSchema&TProtobufRowWriter:: GetTableSchema(size_t tableIndex) const {
@@ -54,6 +113,10 @@ const NYT::TTableSchema&TProtobufRowWriter:: GetTableSchema(size_t tableIndex) c
 }
 
 IRowPtr TProtobufRowWriter::CreateObjectForWrite(size_t tableIndex) const {
+    if (auto row = RowPools_[tableIndex].Acquire()) {
+        return row;
+    }
+
     return RowFactory_->NewRow(TypeNames_[tableIndex]);
 }
 
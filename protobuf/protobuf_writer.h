@@ -1,9 +1,10 @@
 #pragma once
 
-#include <yt/cpp/mapreduce/io/proto_table_writer.h>
+#include <yt/cpp/mapreduce/interface/io.h>
 
 #include "protobuf_row_factory.h"
 #include <dformats/interface/io.h>
+#include <dformats/common/row_pool.h>
 
 using namespace google::protobuf;
 using namespace NYT;
@@ -24,6 +25,9 @@ public:
     void WriteRow(IRowPtr&& row, size_t tableIndex) override;
     void FinishTable(size_t tableIndex) override;
 
+    // Writes serialized message of the table's type as is, e.g. data of an unmodified lazy row
+    void WriteRawRow(std::string_view data, size_t tableIndex) override;
+
     enum Format Format() const override;
     size_t GetTablesCount() const override;
     const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
@@ -32,9 +36,15 @@ public:
     std::shared_ptr<TProtobufRowFactory> RowFactory() const;
 
 protected:
-    std::unique_ptr<TLenvalProtoTableWriter> Underlying_;
+    void WriteMessage(const IBaseRow& row, size_t tableIndex);
+    void RecycleRow(IRowPtr&& row, size_t tableIndex);
+
+protected:
+    THolder<IProxyOutput> Underlying_;
     std::shared_ptr<TProtobufRowFactory> RowFactory_;
     std::vector<std::string> TypeNames_;
+    std::vector<const Descriptor*> Descriptors_;
+    mutable std::vector<TRowPool> RowPools_;
 };
 
 }
@@ -0,0 +1,109 @@
+#include "skiff_layout.h"
+
+namespace DFormats {
+
+// TSkiffLayout
+
+TSkiffLayout::TSkiffLayout(NTi::TTypePtr type)
+  : TSkiffLayout(type, SkiffSchemaFromTypeV3(type)) { }
+
+TSkiffLayout::TSkiffLayout(NTi::TTypePtr type, NSkiff::TSkiffSchemaPtr skiffSchema)
+  : Type_(std::move(type))
+  , TypeName_(Type_->StripTags()->GetTypeName())
+  , SkiffSchema_(std::move(skiffSchema))
+  , StaticSize_(SkiffSchemaStaticSize(SkiffSchema_)) {
+
+    BuildChildren();
+
+    if (StaticSize_ < 0) {
+        Program_.Compile(SkiffSchema_);
+    }
+
+    AddField(SkiffSchema_, DefaultData_);
+    if (TypeName_ == NTi::ETypeName::Struct || TypeName_ == NTi::ETypeName::Tuple) {
+        DefaultOffsets_ = FieldsOffsets({DefaultData_.Data(), DefaultData_.Size()});
+    }
+}
+
+void TSkiffLayout::BuildChildren() {
+    auto type = Type_->StripTags();
+    const auto& skiffChildren = SkiffSchema_->GetChildren();
+
+    // Children skiff schemas are taken from the parent one instead of being derived again
+    auto addChild = [&](NTi::TTypePtr childType) {
+        Children_.push_back(std::make_shared<const TSkiffLayout>(
+            std::move(childType), skiffChildren[Children_.size()]));
+    };
+
+    switch (TypeName_) {
+    case NTi::ETypeName::Struct:
+        for (const auto& member : type->AsStruct()->GetMembers()) {
+            IndexesMap_.emplace(member.GetName(), Children_.size());
+            addChild(member.GetType());
+        }
+        break;
+    case NTi::ETypeName::Tuple:
+        for (const auto& element : type->AsTuple()->GetElements()) {
+            addChild(element.GetType());
+        }
+        break;
+    case NTi::ETypeName::Optional:
+        addChild(NTi::Null());
+        addChild(type->AsOptional()->GetItemType());
+        break;
+    case NTi::ETypeName::List:
+        addChild(type->AsList()->GetItemType());
+        break;
+    case NTi::ETypeName::Dict:
+    {
+        auto dictType = type->AsDict();
+        addChild(NTi::Struct({NTi::TStructType::TOwnedMember("key", dictType->GetKeyType()),
+                              NTi::TStructType::TOwnedMember("value", dictType->GetValueType())}));
+        break;
+    }
+    case NTi::ETypeName::Variant:
+    {
+        auto variantType = type->AsVariant();
+
+        if (variantType->IsVariantOverTuple()) {
+            for (const auto& element : variantType->GetUnderlyingType()->AsTuple()->GetElements()) {
+                addChild(element.GetType());
+            }
+        } else {
+            for (const auto& member : variantType->GetUnderlyingType()->AsStruct()->GetMembers()) {
+                addChild(member.GetType());
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+size_t TSkiffLayout::DataSize(const char* serialization) const {
+    if (StaticSize_ >= 0) {
+        return StaticSize_;
+    }
+
+    return Program_.DataSize(0, serialization);
+}
+
+std::vector<ptrdiff_t> TSkiffLayout::FieldsOffsets(std::string_view data) const {
+    std::vector<ptrdiff_t> res;
+    res.reserve(Children_.size());
+
+    size_t currentOffset = 0;
+
+    for (size_t i = 0; i < Children_.size(); ++i) {
+        res.push_back(currentOffset);
+
+        if (i + 1 < Children_.size()) {
+            currentOffset += Children_[i]->DataSize(data.data() + currentOffset);
+        }
+    }
+
+    return res;
+}
+
+}
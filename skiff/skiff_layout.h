@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <library/cpp/type_info/type.h>
+#include <util/generic/buffer.h>
+
+#include "skiff_program.h"
+#include "skiff_schema.h"
+
+namespace DFormats {
+
+class TSkiffLayout;
+
+using TSkiffLayoutPtr = std::shared_ptr<const TSkiffLayout>;
+
+// Everything derived from a type which is needed to access its skiff serialization.
+// Layout is immutable, so it is built once (e.g. per table) and shared by all objects
+// of the type and, through children layouts, by all their nested objects
+class TSkiffLayout {
+public:
+    using TIndexesMap = std::unordered_map<std::string_view, size_t>;
+
+public:
+    explicit TSkiffLayout(NTi::TTypePtr type);
+    TSkiffLayout(NTi::TTypePtr type, NSkiff::TSkiffSchemaPtr skiffSchema);
+
+    inline NTi::TTypePtr Type() const {
+        return Type_;
+    }
+
+    // Name of the type with tags stripped
+    inline NTi::ETypeName TypeName() const {
+        return TypeName_;
+    }
+
+    inline const NSkiff::TSkiffSchemaPtr& SkiffSchema() const {
+        return SkiffSchema_;
+    }
+
+    // Size of serialization or -1 if it isn't static
+    inline int64_t StaticSize() const {
+        return StaticSize_;
+    }
+
+    // Layouts of struct/tuple fields, variant alternatives, optional's [Null, Item]
+    // and list's item. Dict has a single child: struct of key and value
+    inline size_t ChildrenCount() const {
+        return Children_.size();
+    }
+    inline const TSkiffLayoutPtr& Child(size_t ind) const {
+        return Children_[ind];
+    }
+    inline NTi::ETypeName ChildTypeName(size_t ind) const {
+        return Children_[ind]->TypeName();
+    }
+
+    // Maps struct members' names to indexes. Keys point into the type's members
+    inline const TIndexesMap& IndexesMap() const {
+        return IndexesMap_;
+    }
+
+    // Serialization of default value of the type
+    inline const TBuffer& DefaultData() const {
+        return DefaultData_;
+    }
+
+    // Offsets of fields inside DefaultData(). Filled for structs and tuples only
+    inline const std::vector<ptrdiff_t>& DefaultOffsets() const {
+        return DefaultOffsets_;
+    }
+
+    // Size of the serialized value starting at the given position
+    size_t DataSize(const char* serialization) const;
+
+    // Offsets of fields of serialized struct or tuple
+    std::vector<ptrdiff_t> FieldsOffsets(std::string_view data) const;
+
+private:
+    void BuildChildren();
+
+private:
+    NTi::TTypePtr Type_;
+    NTi::ETypeName TypeName_;
+    NSkiff::TSkiffSchemaPtr SkiffSchema_;
+    int64_t StaticSize_;
+
+    std::vector<TSkiffLayoutPtr> Children_;
+    TIndexesMap IndexesMap_;
+
+    TBuffer DefaultData_;
+    std::vector<ptrdiff_t> DefaultOffsets_;
+
+    // Compiled for types without static size only, its entry is 0
+    TSkiffProgram Program_;
+};
+
+inline TSkiffLayoutPtr MakeSkiffLayout(NTi::TTypePtr type) {
+    return std::make_shared<const TSkiffLayout>(std::move(type));
+}
+
+}
@@ -0,0 +1,124 @@
+#include "skiff_program.h"
+#include "skiff_schema.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace DFormats {
+
+namespace {
+
+// Number of nested variant or repeated values
+size_t SchemaDepth(const NSkiff::TSkiffSchemaPtr& schema) {
+    size_t childrenDepth = 0;
+    for (const auto& child : schema->GetChildren()) {
+        childrenDepth = std::max(childrenDepth, SchemaDepth(child));
+    }
+
+    return schema->GetWireType() == NSkiff::EWireType::Tuple ? childrenDepth : childrenDepth + 1;
+}
+
+}
+
+// TSkiffProgram
+
+size_t TSkiffProgram::Compile(const NSkiff::TSkiffSchemaPtr& schema) {
+    MaxDepth_ = std::max(MaxDepth_, SchemaDepth(schema));
+
+    // Subroutines of alternatives are emitted after the one calling them, so each one stays contiguous
+    std::vector<TPendingTarget> pending;
+    const auto entry = EmitSubroutine(schema, pending);
+
+    while (!pending.empty()) {
+        auto target = std::move(pending.back());
+        pending.pop_back();
+
+        Targets_[target.Target] = EmitSubroutine(target.Schema, pending);
+    }
+
+    return entry;
+}
+
+size_t TSkiffProgram::EmitSubroutine(const NSkiff::TSkiffSchemaPtr& schema, std::vector<TPendingTarget>& pending) {
+    const auto entry = Code_.size();
+
+    EmitInline(schema, pending);
+    Code_.push_back({EOp::Return});
+
+    return entry;
+}
+
+void TSkiffProgram::EmitInline(const NSkiff::TSkiffSchemaPtr& schema, std::vector<TPendingTarget>& pending) {
+    switch (schema->GetWireType()) {
+    case NSkiff::EWireType::Nothing:
+        break;
+    case NSkiff::EWireType::Tuple:
+        for (const auto& child : schema->GetChildren()) {
+            EmitInline(child, pending);
+        }
+        break;
+    case NSkiff::EWireType::String32:
+    case NSkiff::EWireType::Yson32:
+        Code_.push_back({EOp::String32});
+        break;
+    case NSkiff::EWireType::Variant8:
+        EmitCall(EOp::Variant8, schema, pending);
+        break;
+    case NSkiff::EWireType::Variant16:
+        EmitCall(EOp::Variant16, schema, pending);
+        break;
+    case NSkiff::EWireType::RepeatedVariant8:
+        EmitCall(EOp::Repeated8, schema, pending);
+        break;
+    case NSkiff::EWireType::RepeatedVariant16:
+        EmitCall(EOp::Repeated16, schema, pending);
+        break;
+    default: {
+        const auto staticSize = SkiffSchemaStaticSize(schema);
+        Y_ENSURE(staticSize != -1, "Unsupported skiff wire type");
+
+        if (!Code_.empty() && Code_.back().Op == EOp::Fixed) {
+            Code_.back().Arg += staticSize;
+        } else {
+            Code_.push_back({EOp::Fixed, static_cast<uint32_t>(staticSize)});
+        }
+        break;
+    }
+    }
+}
+
+void TSkiffProgram::EmitCall(EOp op, const NSkiff::TSkiffSchemaPtr& schema, std::vector<TPendingTarget>& pending) {
+    const auto& children = schema->GetChildren();
+    Code_.push_back({op, static_cast<uint32_t>(Targets_.size()), static_cast<uint32_t>(children.size())});
+
+    for (const auto& child : children) {
+        pending.push_back({Targets_.size(), child});
+        Targets_.push_back(0);
+    }
+}
+
+size_t TSkiffProgram::DataSize(size_t entry, const char* data) const {
+    struct TSizeCursor {
+        const char* Data;
+        size_t Size = 0;
+
+        void Take(size_t len) {
+            Size += len;
+        }
+
+        template <typename T>
+        T Load() {
+            T res;
+            std::memcpy(&res, Data + Size, sizeof(T));
+            Size += sizeof(T);
+            return res;
+        }
+    };
+
+    TSizeCursor cursor{data};
+    Run(entry, cursor);
+
+    return cursor.Size;
+}
+
+}
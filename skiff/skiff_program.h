@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <library/cpp/skiff/skiff_schema.h>
+#include <util/generic/yexception.h>
+
+namespace DFormats {
+
+// Skiff schema compiled into a flat list of instructions. Values are walked by a loop over
+// the instructions instead of a recursive descent with a switch on wire type at every node.
+// Tuples are inlined and adjacent fixed-width values are merged, variant alternatives and
+// repeated elements are subroutines called through the targets table.
+//
+// The program is run with a cursor over the data providing:
+//   void Take(size_t len) - consumes len bytes;
+//   template <typename T> T Load() - consumes sizeof(T) bytes and returns their value
+class TSkiffProgram {
+public:
+    enum class EOp : uint8_t {
+        Fixed,       // Arg bytes
+        String32,    // ui32 length followed by data
+        Variant8,    // ui8 tag, then subroutine Targets[Arg + tag]
+        Variant16,   // ui16 tag, then subroutine Targets[Arg + tag]
+        Repeated8,   // ui8 tag and subroutine Targets[Arg + tag] until end of sequence tag
+        Repeated16,  // ui16 tag and subroutine Targets[Arg + tag] until end of sequence tag
+        Return
+    };
+
+    struct TInstruction {
+        EOp Op;
+        uint32_t Arg = 0;
+        uint32_t TargetsCount = 0;
+    };
+
+public:
+    TSkiffProgram() = default;
+
+    // Adds a subroutine walking values of the schema and returns its entry
+    size_t Compile(const NSkiff::TSkiffSchemaPtr& schema);
+
+    template <typename TCursor>
+    void Run(size_t entry, TCursor& cursor) const;
+
+    // Size of the serialized value starting at data
+    size_t DataSize(size_t entry, const char* data) const;
+
+private:
+    struct TPendingTarget {
+        size_t Target;
+        NSkiff::TSkiffSchemaPtr Schema;
+    };
+
+    size_t EmitSubroutine(const NSkiff::TSkiffSchemaPtr& schema, std::vector<TPendingTarget>& pending);
+    void EmitInline(const NSkiff::TSkiffSchemaPtr& schema, std::vector<TPendingTarget>& pending);
+    void EmitCall(EOp op, const NSkiff::TSkiffSchemaPtr& schema, std::vector<TPendingTarget>& pending);
+
+    template <typename TTag, typename TCursor>
+    size_t LoadTag(const TInstruction& instruction, TCursor& cursor) const;
+
+    static constexpr size_t InlineStackSize = 32;
+
+private:
+    std::vector<TInstruction> Code_;
+    std::vector<uint32_t> Targets_;
+    size_t MaxDepth_ = 0;  // Maximal number of nested calls
+};
+
+template <typename TTag, typename TCursor>
+size_t TSkiffProgram::LoadTag(const TInstruction& instruction, TCursor& cursor) const {
+    const size_t tag = cursor.template Load<TTag>();
+    // End of sequence tag has no target, it's valid only for repeated variants
+    const bool endOfSequence = tag == NSkiff::EndOfSequenceTag<TTag>() &&
+                               (instruction.Op == EOp::Repeated8 || instruction.Op == EOp::Repeated16);
+    Y_ENSURE(tag < instruction.TargetsCount || endOfSequence,
+             "Skiff tag " << tag << " is out of range [0, " << instruction.TargetsCount << ")");
+    return tag;
+}
+
+template <typename TCursor>
+void TSkiffProgram::Run(size_t entry, TCursor& cursor) const {
+    // Return addresses. Repeated instructions return to themselves to read the next tag
+    uint32_t inlineStack[InlineStackSize];
+    std::vector<uint32_t> heapStack;
+    uint32_t* stack = inlineStack;
+    if (MaxDepth_ > InlineStackSize) {
+        heapStack.resize(MaxDepth_);
+        stack = heapStack.data();
+    }
+
+    size_t depth = 0;
+    size_t pc = entry;
+
+    while (true) {
+        const auto& instruction = Code_[pc];
+
+        switch (instruction.Op) {
+        case EOp::Fixed:
+            cursor.Take(instruction.Arg);
+            ++pc;
+            break;
+        case EOp::String32:
+            cursor.Take(cursor.template Load<uint32_t>());
+            ++pc;
+            break;
+        case EOp::Variant8:
+            stack[depth++] = pc + 1;
+            pc = Targets_[instruction.Arg + LoadTag<uint8_t>(instruction, cursor)];
+            break;
+        case EOp::Variant16:
+            stack[depth++] = pc + 1;
+            pc = Targets_[instruction.Arg + LoadTag<uint16_t>(instruction, cursor)];
+            break;
+        case EOp::Repeated8: {
+            const auto tag = LoadTag<uint8_t>(instruction, cursor);
+            if (tag == NSkiff::EndOfSequenceTag<uint8_t>()) {
+                ++pc;
+            } else {
+                stack[depth++] = pc;
+                pc = Targets_[instruction.Arg + tag];
+            }
+            break;
+        }
+        case EOp::Repeated16: {
+            const auto tag = LoadTag<uint16_t>(instruction, cursor);
+            if (tag == NSkiff::EndOfSequenceTag<uint16_t>()) {
+                ++pc;
+            } else {
+                stack[depth++] = pc;
+                pc = Targets_[instruction.Arg + tag];
+            }
+            break;
+        }
+        case EOp::Return:
+            if (depth == 0) {
+                return;
+            }
+            pc = stack[--depth];
+            break;
+        }
+    }
+}
+
+}
@@ -1,26 +1,161 @@
 #include "skiff_reader.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include <dformats/common/util.h>
+
 using namespace DFormats;
 
+namespace {
+
+template <typename T>
+T LoadValue(const char* data) {
+    T res;
+    std::memcpy(&res, data, sizeof(T));
+    return res;
+}
+
+// data points to the value of predicate's column in Skiff wire format
+bool MatchesSkiffValue(const TResolvedPredicate& predicate, const char* data) {
+    using NTi::ETypeName;
+
+    switch (predicate.Type) {
+    case ETypeName::Bool:
+        return predicate.Matches(LoadValue<uint8_t>(data) != 0);
+    case ETypeName::Int8:
+        return predicate.Matches(LoadValue<int8_t>(data));
+    case ETypeName::Int16:
+        return predicate.Matches(LoadValue<int16_t>(data));
+    case ETypeName::Int32:
+        return predicate.Matches(LoadValue<int32_t>(data));
+    case ETypeName::Int64:
+        return predicate.Matches(LoadValue<int64_t>(data));
+    case ETypeName::Uint8:
+        return predicate.Matches(LoadValue<uint8_t>(data));
+    case ETypeName::Uint16:
+        return predicate.Matches(LoadValue<uint16_t>(data));
+    case ETypeName::Uint32:
+        return predicate.Matches(LoadValue<uint32_t>(data));
+    case ETypeName::Uint64:
+        return predicate.Matches(LoadValue<uint64_t>(data));
+    case ETypeName::Float:
+    case ETypeName::Double:
+        return predicate.Matches(LoadValue<double>(data));  // Floats are passed as doubles
+    case ETypeName::String:
+    case ETypeName::Utf8:
+        return predicate.Matches(std::string_view(data + 4, LoadValue<uint32_t>(data)));
+    default:
+        return false;
+    }
+}
+
+}
+
 ///// TSkiffRowReader
 
 TSkiffRowReader::TSkiffRowReader(::TIntrusivePtr<TRawTableReader> underlying,
-                                 std::vector<TTableSchema> schemas, ReadingOptions options)
+                                 std::vector<TTableSchema> schemas, ReadingOptions options,
+                                 TSkiffReaderOptions readerOptions)
   : Underlying_(underlying)
   , TableSchemas_(std::move(schemas))
-  , ReadingOptions_(options) {
+  , ReadingOptions_(options)
+  , ReaderOptions_(readerOptions) {
+
+    if (IsBuffered()) {
+        Block_.Reserve(ReaderOptions_.BlockSize);
+    }
 
     SkiffSchemas_.reserve(TableSchemas_.size());
+    RowLayouts_.reserve(TableSchemas_.size());
     for (const auto& tableSchema: TableSchemas_) {
         SkiffSchemas_.push_back(SkiffSchemaFromTableSchema(tableSchema));
+        RowLayouts_.push_back(MakeSkiffLayout(TableSchemaToStructType(tableSchema)));
+
+        RowEntries_.push_back(Program_.Compile(SkiffSchemas_.back()));
+        auto& fieldEntries = FieldEntries_.emplace_back();
+        for (const auto& fieldSchema : SkiffSchemas_.back()->GetChildren()) {
+            fieldEntries.push_back(Program_.Compile(fieldSchema));
+        }
     }
 
     CalculateUnitable();
     Next();
 }
 
+TSkiffRowReader::~TSkiffRowReader() {
+    ReleaseBorrowedRow();
+}
+
+void TSkiffRowReader::ReleaseBorrowedRow() {
+    if (!BorrowedRow_) {
+        return;
+    }
+
+    if (BorrowedRow_.use_count() > 1) {
+        BorrowedRow_->Detach();
+    }
+    BorrowedRow_.reset();
+}
+
+size_t TSkiffRowReader::FillBlock(size_t len) {
+    size_t available = Block_.Size() - BlockPos_;
+    if (available >= len || UnderlyingExhausted_) {
+        return available;
+    }
+
+    // Unparsed tail is moved to the beginning of the block, so a row crossing
+    // the block boundary becomes contiguous after the refill
+    if (BlockPos_ != 0) {
+        Block_.Chop(0, BlockPos_);
+        BlockPos_ = 0;
+    }
+
+    const size_t capacity = std::max(ReaderOptions_.BlockSize, len);
+    Block_.Reserve(capacity);
+
+    while (Block_.Size() < len) {
+        auto readBytes = Underlying_->Read(Block_.Data() + Block_.Size(), capacity - Block_.Size());
+        if (readBytes == 0) {
+            UnderlyingExhausted_ = true;
+            break;
+        }
+        Block_.Advance(readBytes);
+    }
+
+    return Block_.Size();
+}
+
+bool TSkiffRowReader::EnsureAvailable(size_t len, bool allowEOS) {
+    if (Y_LIKELY(Block_.Size() - BlockPos_ >= len)) {
+        return true;
+    }
+
+    auto available = FillBlock(len);
+
+    if (available == 0 && len != 0) {
+        Y_ENSURE(allowEOS, "Premature end of stream");
+        return false;
+    }
+
+    Y_ENSURE(available >= len, "Premature end of stream. Expected " << 
+        std::to_string(len) << " bytes, but only " << std::to_string(available) << " can be read");
+
+    return true;
+}
+
 template <class T>
 bool TSkiffRowReader::ReadFromStream(T* dst, size_t len, bool allowEOS) {
+    if (IsBuffered()) {
+        if (!EnsureAvailable(len, allowEOS)) {
+            return false;
+        }
+
+        std::memcpy(static_cast<void*>(dst), Block_.Data() + BlockPos_, len);
+        BlockPos_ += len;
+        return true;
+    }
+
     auto readBytes = Underlying_->Load(static_cast<void*>(dst), len);
 
     if (readBytes == 0 && len != 0) {
@@ -35,9 +170,27 @@ bool TSkiffRowReader::ReadFromStream(T* dst, size_t len, bool allowEOS) {
 }
 
 bool TSkiffRowReader::SkipFromStream(size_t len, bool allowEOS) {
-    auto readBytes = Underlying_->Skip(len);
+    size_t readBytes = 0;
+
+    if (IsBuffered()) {
+        size_t available = Block_.Size() - BlockPos_;
+
+        if (len <= available || len <= ReaderOptions_.BlockSize) {
+            if (!EnsureAvailable(len, allowEOS)) {
+                return false;
+            }
+            BlockPos_ += len;
+            return true;
+        }
+
+        // Values larger than the block are skipped in the underlying stream without buffering
+        BlockPos_ = Block_.Size();
+        readBytes = available + Underlying_->Skip(len - available);
+    } else {
+        readBytes = Underlying_->Skip(len);
+    }
 
-    if (readBytes == 0) {
+    if (readBytes == 0 && len != 0) {
         Y_ENSURE(allowEOS, "Premature end of stream");
         return false;
     }
@@ -92,233 +245,291 @@ void TSkiffRowReader::ReadContext() {
 }
 
 IRowPtr TSkiffRowReader::ReadRow() {
-    const auto& fieldSchemas = SkiffSchemas_[ReadingContext_.TableIndex]->GetChildren(); 
+    const auto tableIndex = ReadingContext_.TableIndex;
+    const auto& fieldEntries = FieldEntries_[tableIndex];
+    const auto& unitable = Unitable_[tableIndex];
+
+    if (IsBuffered()) {
+        std::vector<ptrdiff_t> fieldsOffsets;
+        auto rowData = TakeRowFromBlock(fieldsOffsets);
+
+        if (ReaderOptions_.BorrowRows) {
+            BorrowedRow_ = std::make_shared<TSkiffRow>(RowLayouts_[tableIndex], rowData, std::move(fieldsOffsets));
+            return BorrowedRow_;
+        }
+
+        return std::make_shared<TSkiffRow>(
+            RowLayouts_[tableIndex], TBuffer(rowData.data(), rowData.size()), std::move(fieldsOffsets));
+    }
 
     TBuffer buf;
     std::vector<ptrdiff_t> fieldsOffsets = { 0 };
-    fieldsOffsets.reserve(fieldSchemas.size());
+    fieldsOffsets.reserve(fieldEntries.size());
 
-    for (size_t i = 0; i < fieldSchemas.size(); ++i) {
-        if (size_t canUniteBytes = Unitable_[ReadingContext_.TableIndex][i]) {
+    for (size_t i = 0; i < fieldEntries.size(); ++i) {
+        if (size_t canUniteBytes = unitable[i]) {
             buf.Advance(canUniteBytes);
             ReadFromStream(buf.Data() + fieldsOffsets.back(), canUniteBytes);
 
-            for (; Unitable_[ReadingContext_.TableIndex][i]; ++i) {
-                fieldsOffsets.push_back(fieldsOffsets.back() +
-                    Unitable_[ReadingContext_.TableIndex][i] - 
-                    Unitable_[ReadingContext_.TableIndex][i + 1]);
+            for (; unitable[i]; ++i) {
+                fieldsOffsets.push_back(fieldsOffsets.back() + unitable[i] - unitable[i + 1]);
             }
             --i;
         } else {
-            fieldsOffsets.push_back(fieldsOffsets.back() + ReadData(fieldSchemas[i], buf));
+            fieldsOffsets.push_back(fieldsOffsets.back() + ReadData(fieldEntries[i], buf));
         }
     }
     fieldsOffsets.pop_back();
 
     Valid_ = false;
 
-    return std::make_shared<TSkiffRow>(
-        TableSchemas_[ReadingContext_.TableIndex], std::move(buf), std::move(fieldsOffsets));
+    return std::make_shared<TSkiffRow>(RowLayouts_[tableIndex], std::move(buf), std::move(fieldsOffsets));
+}
+
+TSkiffRawRow TSkiffRowReader::ReadRawRow() {
+    Y_ENSURE(IsBuffered(), "Raw rows can be read with buffering only");
+    Y_ENSURE(Valid_, "Trying to read row from invalid reader");
+
+    ReleaseBorrowedRow();
+    auto rowData = TakeRowFromBlock(ScratchOffsets_);
+
+    // The block belongs to the reader and isn't read again, so the row may be modified in place
+    return TSkiffRawRow(Block_.Data() + BlockPos_ - rowData.size(), rowData.size(), ScratchOffsets_);
+}
+
+std::string_view TSkiffRowReader::TakeRowFromBlock(std::vector<ptrdiff_t>& fieldsOffsets) {
+    const auto& fieldEntries = FieldEntries_[ReadingContext_.TableIndex];
+    const auto& unitable = Unitable_[ReadingContext_.TableIndex];
+
+    // Whole row is made available in the block first, so it can be copied at once (or not copied at all)
+    fieldsOffsets.clear();
+    fieldsOffsets.reserve(fieldEntries.size());
+    size_t rowSize = 0;
+
+    for (size_t i = 0; i < fieldEntries.size();) {
+        if (size_t canUniteBytes = unitable[i]) {
+            EnsureAvailable(rowSize + canUniteBytes);
+
+            for (; unitable[i]; ++i) {
+                fieldsOffsets.push_back(rowSize);
+                rowSize += unitable[i] - unitable[i + 1];
+            }
+        } else {
+            fieldsOffsets.push_back(rowSize);
+            rowSize += PeekData(fieldEntries[i], rowSize);
+            ++i;
+        }
+    }
+
+    std::string_view rowData(Block_.Data() + BlockPos_, rowSize);
+    BlockPos_ += rowSize;
+    Valid_ = false;
+
+    return rowData;
 }
 
-size_t TSkiffRowReader::ReadData(const NSkiff::TSkiffSchemaPtr skiffSchema, TBuffer& dst) {
-    size_t readBytesCount = 0;
-
-    switch (skiffSchema->GetWireType()) {
-    // Simple types
-    case NSkiff::EWireType::Int8:
-    case NSkiff::EWireType::Uint8:
-    case NSkiff::EWireType::Boolean:
-        dst.Advance(1);
-        ReadFromStream(dst.Pos() - 1, 1);
-        readBytesCount = 1;
-        break;
-    case NSkiff::EWireType::Int16:
-    case NSkiff::EWireType::Uint16:
-        dst.Advance(2);
-        ReadFromStream(dst.Pos() - 2, 2);
-        readBytesCount = 2;
-        break;
-    case NSkiff::EWireType::Int32:
-    case NSkiff::EWireType::Uint32:
-        dst.Advance(4);
-        ReadFromStream(dst.Pos() - 4, 4);
-        readBytesCount = 4;
-        break;
-    case NSkiff::EWireType::Int64:
-    case NSkiff::EWireType::Uint64:
-    case NSkiff::EWireType::Double:
-        dst.Advance(8);
-        ReadFromStream(dst.Pos() - 8, 8);
-        readBytesCount = 8;
-        break;
-    case NSkiff::EWireType::Int128:
-    case NSkiff::EWireType::Uint128:
-        dst.Advance(16);
-        ReadFromStream(dst.Pos() - 16, 16);
-        readBytesCount = 16;
-        break;
-    case NSkiff::EWireType::Int256:
-    case NSkiff::EWireType::Uint256:
-        dst.Advance(32);
-        ReadFromStream(dst.Pos() - 32, 32);
-        readBytesCount = 32;
-        break;
-    case NSkiff::EWireType::String32:
-    case NSkiff::EWireType::Yson32:
-        uint32_t length;
-        ReadFromStream(&length);
-        dst.Append(reinterpret_cast<char*>(&length), 4);
-        dst.Advance(length);
-        ReadFromStream(dst.Pos() - length, length);
-        readBytesCount = length + 4;
-        break;
-
-    // Complex types
-    case NSkiff::EWireType::Tuple: {
-        const auto& fields = skiffSchema->GetChildren();
-        for (size_t i = 0; i < fields.size(); ++i) {
-            readBytesCount += ReadData(fields[i], dst);
+size_t TSkiffRowReader::ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                                 std::vector<TReadingContext>* contexts) {
+    if (!IsBuffered()) {
+        return IRowReader::ReadRows(rows, maxCount, contexts);
+    }
+
+    if (contexts) {
+        contexts->clear();
+    }
+
+    // Rows of a batch are never borrowed: the block may be refilled while the batch is read
+    ReleaseBorrowedRow();
+
+    size_t count = 0;
+    for (; count < maxCount && Valid_; ++count, Next()) {
+        if (count == rows.size()) {
+            rows.emplace_back();
         }
-        break;
-    }
-    case NSkiff::EWireType::Variant8: {
-        uint8_t tag8;
-        ReadFromStream(&tag8);
-        dst.Append(reinterpret_cast<char*>(&tag8), 1);
-        readBytesCount += 1 + ReadData(skiffSchema->GetChildren()[tag8], dst);
-        break;
-    }
-    case NSkiff::EWireType::Variant16: {
-        uint16_t tag16;
-        ReadFromStream(&tag16);
-        dst.Append(reinterpret_cast<char*>(&tag16), 2);
-        readBytesCount += 2 + ReadData(skiffSchema->GetChildren()[tag16], dst);
-        break;
-    }
-    case NSkiff::EWireType::RepeatedVariant8: {
-        uint8_t rtag8;
-        while (true) {
-            ReadFromStream(&rtag8);
-            dst.Append(reinterpret_cast<char*>(&rtag8), 1);
-            readBytesCount += 1;
-            
-            if (rtag8 == NSkiff::EndOfSequenceTag<ui8>()) break;
-
-            readBytesCount += ReadData(skiffSchema->GetChildren()[rtag8], dst);
+
+        const auto tableIndex = ReadingContext_.TableIndex;
+        auto& row = rows[count];
+        auto* skiffRow = row.use_count() == 1 ? dynamic_cast<TSkiffRow*>(row.get()) : nullptr;
+
+        auto rowData = TakeRowFromBlock(ScratchOffsets_);
+
+        if (skiffRow && skiffRow->Layout() == RowLayouts_[tableIndex]) {
+            skiffRow->Assign(rowData, ScratchOffsets_);
+        } else {
+            row = std::make_shared<TSkiffRow>(
+                RowLayouts_[tableIndex], TBuffer(rowData.data(), rowData.size()), ScratchOffsets_);
         }
-        break;
-    }
-    case NSkiff::EWireType::RepeatedVariant16: {
-        uint16_t rtag16;
-        while (true) {
-            ReadFromStream(&rtag16);
-            dst.Append(reinterpret_cast<char*>(&rtag16), 2);
-            readBytesCount += 2;
-            
-            if (rtag16 == NSkiff::EndOfSequenceTag<ui8>()) break;
-
-            readBytesCount += ReadData(skiffSchema->GetChildren()[rtag16], dst);
+
+        if (contexts) {
+            contexts->push_back(ReadingContext_);
         }
-        break;
-    }
-    default:
-        break;
     }
 
-    return readBytesCount;
+    rows.resize(count);
+    return count;
 }
 
-void TSkiffRowReader::SkipData(const NSkiff::TSkiffSchemaPtr skiffSchema) {
-    switch (skiffSchema->GetWireType()) {
-    // Simple types
-    case NSkiff::EWireType::Int8:
-    case NSkiff::EWireType::Uint8:
-    case NSkiff::EWireType::Boolean:
-        SkipFromStream(1);
-        break;
-    case NSkiff::EWireType::Int16:
-    case NSkiff::EWireType::Uint16:
-        SkipFromStream(2);
-        break;
-    case NSkiff::EWireType::Int32:
-    case NSkiff::EWireType::Uint32:
-        SkipFromStream(4);
-        break;
-    case NSkiff::EWireType::Int64:
-    case NSkiff::EWireType::Uint64:
-    case NSkiff::EWireType::Double:
-        SkipFromStream(8);
-        break;
-    case NSkiff::EWireType::Int128:
-    case NSkiff::EWireType::Uint128:
-        SkipFromStream(16);
-        break;
-    case NSkiff::EWireType::Int256:
-    case NSkiff::EWireType::Uint256:
-        SkipFromStream(32);
-        break;
-    case NSkiff::EWireType::String32:
-    case NSkiff::EWireType::Yson32: {
-        uint32_t length;
-        ReadFromStream(&length);
-        SkipFromStream(length);
-        break;
-    }
-
-    // Complex types
-    case NSkiff::EWireType::Tuple:
-        for (auto childSkiffSchema : skiffSchema->GetChildren()) {
-            SkipData(childSkiffSchema);
+size_t TSkiffRowReader::PeekData(size_t entry, size_t offset) {
+    struct TPeekCursor {
+        TSkiffRowReader* Reader;
+        size_t Offset;
+
+        void Take(size_t len) {
+            Reader->EnsureAvailable(Offset + len);
+            Offset += len;
         }
-        break;
-    case NSkiff::EWireType::Variant8: {
-        uint8_t tag8;
-        ReadFromStream(&tag8);
-        SkipData(skiffSchema->GetChildren()[tag8]);
-        break;
-    }
-    case NSkiff::EWireType::Variant16: {
-        uint16_t tag16;
-        ReadFromStream(&tag16);
-        SkipData(skiffSchema->GetChildren()[tag16]);
-        break;
-    }
-    case NSkiff::EWireType::RepeatedVariant8: {
-        uint8_t rtag8;
-        while (true) {
-            ReadFromStream(&rtag8);
-            if (rtag8 == NSkiff::EndOfSequenceTag<ui8>()) break;
-            SkipData(skiffSchema->GetChildren()[rtag8]);
+
+        template <typename T>
+        T Load() {
+            Reader->EnsureAvailable(Offset + sizeof(T));
+
+            T res;
+            std::memcpy(&res, Reader->Block_.Data() + Reader->BlockPos_ + Offset, sizeof(T));
+            Offset += sizeof(T);
+            return res;
         }
-        break;
-    }
-    case NSkiff::EWireType::RepeatedVariant16: {
-        uint16_t rtag16;
-        while (true) {
-            ReadFromStream(&rtag16);
-            if (rtag16 == NSkiff::EndOfSequenceTag<ui16>()) break;
-            SkipData(skiffSchema->GetChildren()[rtag16]);
+    };
+
+    TPeekCursor cursor{this, offset};
+    Program_.Run(entry, cursor);
+
+    return cursor.Offset - offset;
+}
+
+size_t TSkiffRowReader::ReadData(size_t entry, TBuffer& dst) {
+    struct TReadCursor {
+        TSkiffRowReader* Reader;
+        TBuffer& Dst;
+
+        void Take(size_t len) {
+            Dst.Advance(len);
+            Reader->ReadFromStream(Dst.Pos() - len, len);
         }
-        break;
-    }
-    default:
-        break;
-    }
+
+        template <typename T>
+        T Load() {
+            T res;
+            Reader->ReadFromStream(&res);
+            Dst.Append(reinterpret_cast<const char*>(&res), sizeof(T));
+            return res;
+        }
+    };
+
+    const auto sizeBefore = dst.Size();
+
+    TReadCursor cursor{this, dst};
+    Program_.Run(entry, cursor);
+
+    return dst.Size() - sizeBefore;
+}
+
+void TSkiffRowReader::SkipData(size_t entry) {
+    struct TSkipCursor {
+        TSkiffRowReader* Reader;
+
+        void Take(size_t len) {
+            Reader->SkipFromStream(len);
+        }
+
+        template <typename T>
+        T Load() {
+            T res;
+            Reader->ReadFromStream(&res);
+            return res;
+        }
+    };
+
+    TSkipCursor cursor{this};
+    Program_.Run(entry, cursor);
 }
 
 void TSkiffRowReader::Next() {
+    ReleaseBorrowedRow();
+
     if (!EndOfStream_ && Valid_) {
-        SkipData(SkiffSchemas_[ReadingContext_.TableIndex]);
+        SkipData(RowEntries_[ReadingContext_.TableIndex]);
     }
 
     ReadContext();
+    SkipRejected();
 
     if (!EndOfStream_) {
         Valid_ = true;
     }
 } 
 
+void TSkiffRowReader::SkipRejected() {
+    // Key switch before a rejected row is a key switch before the next accepted one,
+    // otherwise reducers would merge groups of the keys
+    bool afterKeySwitch = false;
+
+    while (HasFilter_ && !EndOfStream_ && !MatchesFilter()) {
+        afterKeySwitch |= IsAfterKeySwitch();
+        SkipData(RowEntries_[ReadingContext_.TableIndex]);
+        ReadContext();
+    }
+
+    if (afterKeySwitch && !EndOfStream_) {
+        ReadingContext_.AfterKeySwitch = true;
+    }
+}
+
+bool TSkiffRowReader::PushDownFilter(const TRowFilter& filter) {
+    if (!IsBuffered()) {
+        return false;
+    }
+
+    Filter_.clear();
+    for (const auto& tableSchema : TableSchemas_) {
+        auto predicates = ResolveFilter(filter, tableSchema);
+        std::stable_sort(predicates.begin(), predicates.end(), [] (const auto& lhs, const auto& rhs) {
+            return lhs.Column < rhs.Column;
+        });
+        Filter_.push_back(std::move(predicates));
+    }
+    HasFilter_ = !filter.Empty();
+
+    if (Valid_ && HasFilter_) {
+        ReleaseBorrowedRow();
+        SkipRejected();
+    }
+
+    return true;
+}
+
+bool TSkiffRowReader::MatchesFilter() {
+    const auto tableIndex = ReadingContext_.TableIndex;
+    const auto& fieldEntries = FieldEntries_[tableIndex];
+    const auto& unitable = Unitable_[tableIndex];
+
+    // Row isn't consumed: offsets of fields are found in the block like in TakeRowFromBlock
+    size_t offset = 0;
+    size_t field = 0;
+
+    for (const auto& predicate : Filter_[tableIndex]) {
+        for (; field < predicate.Column; ++field) {
+            offset += unitable[field] ? unitable[field] - unitable[field + 1] : PeekData(fieldEntries[field], offset);
+        }
+
+        // Makes the whole value available. Block may be refilled here, so data is taken afterwards
+        PeekData(fieldEntries[field], offset);
+        const char* data = Block_.Data() + BlockPos_ + offset;
+
+        if (predicate.IsOptional) {
+            if (*data == 0) {
+                return false;
+            }
+            ++data;
+        }
+
+        if (!MatchesSkiffValue(predicate, data)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool TSkiffRowReader::IsValid() const {
     return Valid_;
 }
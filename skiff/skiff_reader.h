@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstring>
+
+#include <util/system/yassert.h>
 #include <yt/cpp/mapreduce/interface/skiff_row.h>
 #include <yt/cpp/mapreduce/interface/client.h>
 #include <yt/cpp/mapreduce/interface/io.h>
@@ -8,21 +11,94 @@
 #include <yt/cpp/mapreduce/io/stream_table_reader.h>
 #include <yt/yt/client/tablet_client/public.h>
 
+#include "skiff_program.h"
 #include "skiff_schema.h"
 #include "skiff_types.h"
 #include <dformats/interface/io.h>
 
 namespace DFormats {
 
+struct TSkiffReaderOptions {
+    // Size of blocks pulled from the underlying stream at once. Rows are parsed out of the block
+    // with plain memory copies. Zero disables buffering: every field is loaded from the stream directly
+    size_t BlockSize = 1 << 20;
+
+    // ReadRow() returns rows borrowing memory of the input block instead of copying it. Such row is
+    // detached (copied into its own buffer) on modification or if it's still referenced on Next().
+    // Has no effect without buffering
+    bool BorrowRows = false;
+};
+
+// Row read from the input block without creating a row object. Fixed-width fields may be changed
+// in place, so the row can be passed to TSkiffRowWriter::WriteRawRow without copying. Values are
+// accessed in wire format: floats are stored as doubles, optional fields start with a tag byte.
+// Valid until the reader moves to the next row
+class TSkiffRawRow {
+public:
+    TSkiffRawRow(char* data, size_t size, const std::vector<ptrdiff_t>& fieldsOffsets)
+      : Data_(data), Size_(size), FieldsOffsets_(&fieldsOffsets) { }
+
+    inline std::string_view Data() const {
+        return {Data_, Size_};
+    }
+
+    inline size_t FieldsCount() const {
+        return FieldsOffsets_->size();
+    }
+
+    inline size_t FieldSize(size_t ind) const {
+        return (ind + 1 < FieldsCount() ? (*FieldsOffsets_)[ind + 1] : Size_) - (*FieldsOffsets_)[ind];
+    }
+
+    template <typename T>
+    inline T GetValue(size_t ind) const {
+        Y_ASSERT(sizeof(T) <= FieldSize(ind));
+
+        T res;
+        std::memcpy(&res, Data_ + (*FieldsOffsets_)[ind], sizeof(T));
+        return res;
+    }
+
+    inline std::string_view GetString(size_t ind) const {
+        return SkiffDeserializeString(Data_ + (*FieldsOffsets_)[ind]);
+    }
+
+    // Only values of the same size may be written, so the layout of the row is kept
+    template <typename T>
+    inline void SetValue(size_t ind, T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Y_ASSERT(sizeof(T) <= FieldSize(ind));
+
+        std::memcpy(Data_ + (*FieldsOffsets_)[ind], &value, sizeof(T));
+    }
+
+private:
+    char* Data_;
+    size_t Size_;
+    const std::vector<ptrdiff_t>* FieldsOffsets_;
+};
+
 class TSkiffRowReader : public IRowReader {
 public:
     TSkiffRowReader(::TIntrusivePtr<TRawTableReader> underlying, std::vector<TTableSchema> schemas,
-        ReadingOptions options = static_cast<ReadingOptions>(0));
+        ReadingOptions options = static_cast<ReadingOptions>(0), TSkiffReaderOptions readerOptions = {});
 
     TSkiffRowReader(TSkiffRowReader&& rhs) = default;
     TSkiffRowReader& operator=(TSkiffRowReader&& rhs) = default;
 
+    ~TSkiffRowReader() override;
+
     IRowPtr ReadRow() override;
+
+    // Reads the current row without creating a row object. Requires buffering
+    TSkiffRawRow ReadRawRow();
+
+    size_t ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                    std::vector<TReadingContext>* contexts) override;
+    using IRowReader::ReadRows;
+
+    // Supported with buffering only. Predicates are evaluated on the row's bytes in the block
+    bool PushDownFilter(const TRowFilter& filter) override;
     
     bool IsValid() const override;
     bool IsEndOfStream() const override;
@@ -37,9 +113,19 @@ protected:
     template <class T>
     bool ReadFromStream(T* dst, size_t len = sizeof(T), bool allowEOS = false);
     bool SkipFromStream(size_t len, bool allowEOS = false);
-    size_t ReadData(NSkiff::TSkiffSchemaPtr skiffSchema, TBuffer& dst);
-    void SkipData(NSkiff::TSkiffSchemaPtr skiffSchema);
+    bool EnsureAvailable(size_t len, bool allowEOS = false);
+    size_t FillBlock(size_t len);
+    inline bool IsBuffered() const { return ReaderOptions_.BlockSize != 0; }
+    // Values are walked by subroutines of Program_ starting at the given entry
+    size_t ReadData(size_t entry, TBuffer& dst);
+    size_t PeekData(size_t entry, size_t offset);
+    std::string_view TakeRowFromBlock(std::vector<ptrdiff_t>& fieldsOffsets);
+    void ReleaseBorrowedRow();
+    void SkipData(size_t entry);
     void ReadContext();
+    bool MatchesFilter();
+    // Moves to the first row matching the filter starting from the current one
+    void SkipRejected();
 
     NSkiff::TSkiffSchemaPtr GetSkiffSchema(size_t tableIndex) const;
     void CalculateUnitable();
@@ -48,7 +134,24 @@ private:
     ::TIntrusivePtr<TRawTableReader> Underlying_;
     std::vector<TTableSchema> TableSchemas_;
     std::vector<NSkiff::TSkiffSchemaPtr> SkiffSchemas_;
+    std::vector<TSkiffLayoutPtr> RowLayouts_;
+
+    // Decoding program of all tables with entries of whole rows and of each field
+    TSkiffProgram Program_;
+    std::vector<size_t> RowEntries_;
+    std::vector<std::vector<size_t>> FieldEntries_;
+
     const ReadingOptions ReadingOptions_;
+    const TSkiffReaderOptions ReaderOptions_;
+
+    // Data loaded from Underlying_ but not parsed yet lays in Block_ after BlockPos_
+    TBuffer Block_;
+    size_t BlockPos_ = 0;
+    bool UnderlyingExhausted_ = false;
+
+    // Last row returned with BorrowRows option. Detached before the block is overwritten
+    std::shared_ptr<TSkiffRow> BorrowedRow_;
+    std::vector<ptrdiff_t> ScratchOffsets_;
 
     TReadingContext ReadingContext_;
     bool Valid_ = false;
@@ -56,6 +159,10 @@ private:
 
     // For reading optimization. Contains how many bytes may be read unitedly from stream
     TVector<TVector<size_t>> Unitable_;
+
+    // Predicates of each table sorted by column. Rows not matching them are skipped by Next()
+    std::vector<std::vector<TResolvedPredicate>> Filter_;
+    bool HasFilter_ = false;
 };
 
 }
@@ -1,5 +1,7 @@
 #include "skiff_schema.h"
 
+#include <library/cpp/skiff/skiff.h>
+
 namespace DFormats {
 
 NSkiff::TSkiffSchemaPtr SkiffSchemaFromTypeV3(NTi::TTypePtr type) {
@@ -151,4 +153,43 @@ int64_t SkiffSchemaStaticSize(const NSkiff::TSkiffSchemaPtr& schema) {
     }
 }
 
+size_t AddField(const NSkiff::TSkiffSchemaPtr& fieldSkiffSchema, TBuffer& dst) {
+    auto offset = dst.Size();
+
+    switch (fieldSkiffSchema->GetWireType()) {
+    case NSkiff::EWireType::String32:
+    case NSkiff::EWireType::Yson32:
+        dst.Append("\00\00\00\00", 4);
+        break;
+    case NSkiff::EWireType::Tuple:
+        for (auto childSkiffSchema : fieldSkiffSchema->GetChildren()) {
+            AddField(childSkiffSchema, dst);
+        }
+        break;
+    case NSkiff::EWireType::Variant8:
+        dst.Append("\00", 1);
+        AddField(fieldSkiffSchema->GetChildren()[0], dst);
+        break;
+    case NSkiff::EWireType::Variant16:
+        dst.Append("\00\00", 2);
+        AddField(fieldSkiffSchema->GetChildren()[0], dst);
+        break;
+    case NSkiff::EWireType::RepeatedVariant8: {
+        auto rtag8 = NSkiff::EndOfSequenceTag<uint8_t>();
+        dst.Append(reinterpret_cast<char*>(&rtag8), 1);
+        break;
+    }
+    case NSkiff::EWireType::RepeatedVariant16: {
+        auto rtag16 = NSkiff::EndOfSequenceTag<uint16_t>();
+        dst.Append(reinterpret_cast<char*>(&rtag16), 2);
+        break;
+    }
+    default:
+        dst.Advance(SkiffSchemaStaticSize(fieldSkiffSchema));
+        break;
+    }
+
+    return offset;
+}
+
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <yt/cpp/mapreduce/client/skiff.h>
+#include <util/generic/buffer.h>
 
 using namespace NYT;
 
@@ -11,4 +12,7 @@ NSkiff::TSkiffSchemaPtr SkiffSchemaFromTableSchema(const TTableSchema& tableSche
 
 int64_t SkiffSchemaStaticSize(const NSkiff::TSkiffSchemaPtr& schema);
 
+// Appends default serialization of the schema to dst and returns its offset
+size_t AddField(const NSkiff::TSkiffSchemaPtr& fieldSkiffSchema, TBuffer& dst);
+
 }
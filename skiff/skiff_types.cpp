@@ -1,37 +1,57 @@
 #include "skiff_types.h"
 
 #include <library/cpp/skiff/skiff.h>
+#include <utility>
+
 #include <dformats/common/util.h>
+#include <dformats/interface/statistics.h>
 
 namespace DFormats {
 
 template <typename... Args>
-std::shared_ptr<TSkiffData> CreateSkiffData(const NTi::TTypePtr& type, Args&&... args) {
-    switch (type->StripTags()->GetTypeName()) {
+std::shared_ptr<TSkiffData> CreateSkiffData(const TSkiffLayoutPtr& layout, Args&&... args) {
+    switch (layout->TypeName()) {
     case NTi::ETypeName::Struct:
-        return std::make_shared<TSkiffStruct>(type, std::forward<Args>(args)...);
+        return std::make_shared<TSkiffStruct>(layout, std::forward<Args>(args)...);
         break;
     case NTi::ETypeName::Tuple:
-        return std::make_shared<TSkiffTuple>(type, std::forward<Args>(args)...);
+        return std::make_shared<TSkiffTuple>(layout, std::forward<Args>(args)...);
         break;
     case NTi::ETypeName::List:
-        return std::make_shared<TSkiffList>(type, std::forward<Args>(args)...);
+        return std::make_shared<TSkiffList>(layout, std::forward<Args>(args)...);
         break;
     case NTi::ETypeName::Dict:
-        return std::make_shared<TSkiffDict>(type, std::forward<Args>(args)...);
+        return std::make_shared<TSkiffDict>(layout, std::forward<Args>(args)...);
         break;
     case NTi::ETypeName::Variant:
-        return std::make_shared<TSkiffVariant>(type, std::forward<Args>(args)...);
+        return std::make_shared<TSkiffVariant>(layout, std::forward<Args>(args)...);
         break;
     case NTi::ETypeName::Optional:
-        return std::make_shared<TSkiffOptional>(type, std::forward<Args>(args)...);
+        return std::make_shared<TSkiffOptional>(layout, std::forward<Args>(args)...);
         break;
     default:
-        return std::make_shared<TSkiffData>(type, std::forward<Args>(args)...);
+        return std::make_shared<TSkiffData>(layout, std::forward<Args>(args)...);
         break;
     }
 }
 
+// Empty ranges are dropped, adjacent ones are merged
+inline void AppendSegment(TSkiffSegments& segments, const char* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    if (!segments.empty()) {
+        auto& last = segments.back();
+        if (static_cast<const char*>(last.buf) + last.len == data) {
+            last.len += size;
+            return;
+        }
+    }
+
+    segments.emplace_back(data, size);
+}
+
 std::string SkiffSerializeString(std::string_view str) {
     std::string res;
 
@@ -46,148 +66,48 @@ std::string_view SkiffDeserializeString(const char* skiffStr) {
     return {skiffStr + 4, *reinterpret_cast<const uint32_t*>(skiffStr)};
 }
 
-size_t AddField(const NSkiff::TSkiffSchemaPtr& fieldSkiffSchema, TBuffer& dst) {
-    auto offset = dst.Size();
-
-    switch (fieldSkiffSchema->GetWireType()) {
-    case NSkiff::EWireType::String32:
-    case NSkiff::EWireType::Yson32:
-        dst.Append("\00\00\00\00", 4);
-        break;
-    case NSkiff::EWireType::Tuple:
-        for (auto childSkiffSchema : fieldSkiffSchema->GetChildren()) {
-            AddField(childSkiffSchema, dst);
-        }
-        break;
-    case NSkiff::EWireType::Variant8:
-        dst.Append("\00", 1);
-        AddField(fieldSkiffSchema->GetChildren()[0], dst);
-        break;
-    case NSkiff::EWireType::Variant16:
-        dst.Append("\00\00", 2);
-        AddField(fieldSkiffSchema->GetChildren()[0], dst);
-        break;
-    case NSkiff::EWireType::RepeatedVariant8: {
-        auto rtag8 = TSkiffVariant::Terminal8Tag();
-        dst.Append(reinterpret_cast<char*>(&rtag8), 1);
-        break;
-    }
-    case NSkiff::EWireType::RepeatedVariant16: {
-        auto rtag16 = TSkiffVariant::Terminal16Tag();
-        dst.Append(reinterpret_cast<char*>(&rtag16), 2);
-        break;
-    }
-    default:
-        dst.Advance(SkiffSchemaStaticSize(fieldSkiffSchema));
-        break;
-    }
-
-    return offset;
-}
-
-size_t SkiffDataSize(const NSkiff::TSkiffSchemaPtr& schema, const char* serialization) {
-    switch (schema->GetWireType()) {
-    case NSkiff::EWireType::String32:
-    case NSkiff::EWireType::Yson32:
-        return *reinterpret_cast<const uint32_t*>(serialization) + 4;
-    case NSkiff::EWireType::Tuple:
-    {
-        size_t res = 0;
-        for (const auto& childSchema : schema->GetChildren()) {
-            res += SkiffDataSize(childSchema, serialization + res);
-        }
-        return res;
-    }
-    case NSkiff::EWireType::Variant8:
-    {
-        auto tag = *reinterpret_cast<const uint8_t*>(serialization);
-        return SkiffDataSize(schema->GetChildren()[tag], serialization + 1) + 1;
-    }
-    case NSkiff::EWireType::Variant16:
-    {
-        auto tag = *reinterpret_cast<const uint16_t*>(serialization);
-        return SkiffDataSize(schema->GetChildren()[tag], serialization + 2) + 2;
-    }
-    case NSkiff::EWireType::RepeatedVariant8:
-    {
-        size_t res = 0;
-
-        uint8_t tag;
-        while ((tag = *reinterpret_cast<const uint8_t*>(serialization + res)) != 
-               NSkiff::EndOfSequenceTag<uint8_t>()) {
-            
-            res += SkiffDataSize(schema->GetChildren()[tag], serialization + res + 1) + 1;
-        }
-
-        return res + 1;
-    }
-    case NSkiff::EWireType::RepeatedVariant16:
-    {
-        size_t res = 0;
-
-        uint16_t tag;
-        while ((tag = *reinterpret_cast<const uint16_t*>(serialization + res)) != 
-               NSkiff::EndOfSequenceTag<uint16_t>()) {
-            
-            res += SkiffDataSize(schema->GetChildren()[tag], serialization + res + 2) + 2;
-        }
-
-        return res + 2;
-    }
-    default:
-        return SkiffSchemaStaticSize(schema);
-    }
-}
-
-std::vector<ptrdiff_t> CalculateOffsets(const NSkiff::TSkiffSchemaList& schemas, std::string_view buf) {
-    std::vector<ptrdiff_t> res { 0 };
-    res.reserve(schemas.size() + 1);
-
-    size_t currentTotalOffset = 0;
-
-    for (const auto& childSchema : schemas) {
-        currentTotalOffset += SkiffDataSize(childSchema, buf.data() + currentTotalOffset);
-        res.emplace_back(currentTotalOffset);
-    }
-
-    res.pop_back();
-
-    return std::move(res);
-}
-
 // TSkiffData
 
-TSkiffData::TSkiffData(NTi::TTypePtr schema) : Schema_(schema) {
-    AddField(SkiffSchemaFromTypeV3(Schema_), Data_);
-}
+TSkiffData::TSkiffData(NTi::TTypePtr schema) : TSkiffData(MakeSkiffLayout(std::move(schema))) { }
 
 TSkiffData::TSkiffData(NTi::TTypePtr schema, TBuffer&& buf)
-  : Schema_(std::move(schema)), Data_(std::move(buf)) { }
+  : TSkiffData(MakeSkiffLayout(std::move(schema)), std::move(buf)) { }
+
+TSkiffData::TSkiffData(TSkiffLayoutPtr layout)
+  : Layout_(std::move(layout)), Data_(Layout_->DefaultData()) { }
 
-TSkiffData::TSkiffData(const TSkiffData& rhs) : Schema_(rhs.Schema_), Data_(rhs.Data_) { }
+TSkiffData::TSkiffData(TSkiffLayoutPtr layout, TBuffer&& buf)
+  : Layout_(std::move(layout)), Data_(std::move(buf)) { }
+
+TSkiffData::TSkiffData(const TSkiffData& rhs) : Layout_(rhs.Layout_), Data_(rhs.Data_) { }
 
 TSkiffData::TSkiffData(TSkiffData&& rhs)
-  : Schema_(std::move(rhs.Schema_)), Data_(std::move(rhs.Data_)) { }
+  : Layout_(std::move(rhs.Layout_)), Data_(std::move(rhs.Data_)) { }
 
 TSkiffData& TSkiffData::operator=(const TSkiffData& rhs) {
-    Schema_ = rhs.Schema_;
+    Layout_ = rhs.Layout_;
     Data_ = rhs.Data_;
 
     return *this;
 }
 
 TSkiffData& TSkiffData::operator=(TSkiffData&& rhs) {
-    Schema_ = std::move(rhs.Schema_);
+    Layout_ = std::move(rhs.Layout_);
     Data_ = std::move(rhs.Data_);
 
     return *this;
 }
 
 size_t TSkiffData::Rebuild() {
+    // Unmodified objects aren't rebuilt, but borrowed ones still copy their data here
+    const bool modified = NeedRebuild();
     SoftRebuild();
 
     if (NeedRebuild()) {
         HardRebuild();
+        ++FormatCounters().SkiffHardRebuildsCount;
+    } else if (modified) {
+        ++FormatCounters().SkiffSoftRebuildsCount;
     }
 
     return Buffer().Size();
@@ -211,6 +131,21 @@ TBuffer TSkiffData::Serialize() const && {
     return SerializeImpl();
 }
 
+std::string_view TSkiffData::SerializedView() {
+    Rebuild();
+    return {Data_.Data(), Data_.Size()};
+}
+
+void TSkiffData::AppendSegments(TSkiffSegments& segments) const {
+    AppendSegment(segments, Data_.Data(), Data_.Size());
+}
+
+void TSkiffData::SerializeTo(IOutputStream& out) const {
+    TSkiffSegments segments;
+    AppendSegments(segments);
+    out.Write(segments.data(), segments.size());
+}
+
 // TSkiffVariant
 
 uint8_t TSkiffVariant::Terminal8Tag() {
@@ -225,20 +160,25 @@ TSkiffVariant::TSkiffVariant(NTi::TTypePtr schema) : TSkiffData(schema) { }
 TSkiffVariant::TSkiffVariant(NTi::TTypePtr schema, TBuffer&& buf) 
   : TSkiffData(schema, std::move(buf)) { } 
 
+TSkiffVariant::TSkiffVariant(TSkiffLayoutPtr layout) : TSkiffData(std::move(layout)) { }
+
+TSkiffVariant::TSkiffVariant(TSkiffLayoutPtr layout, TBuffer&& buf)
+  : TSkiffData(std::move(layout), std::move(buf)) { }
+
 template <class T>
 TSkiffVariant::TSkiffVariant(NTi::TTypePtr schema, uint16_t tag, T&& data) : TSkiffVariant(schema) {
     SetValue(tag, std::forward<T>(data));
 }
 
 TSkiffVariant::TSkiffVariant(const TSkiffVariant& rhs)
-  : TSkiffData(rhs.GetSchema(), rhs.Serialize()) { }
+  : TSkiffData(rhs.Layout(), rhs.Serialize()) { }
 
 TSkiffVariant::TSkiffVariant(TSkiffVariant&& rhs)
-  : TSkiffData(rhs.GetSchema(), std::move(rhs.Buffer()))
+  : TSkiffData(rhs.Layout(), std::move(rhs.Buffer()))
   , ObjectiveValue_(std::move(rhs.ObjectiveValue_)) { }
 
 TSkiffVariant& TSkiffVariant::operator=(const TSkiffVariant& rhs) {
-    TSkiffData::operator=(TSkiffData(rhs.GetSchema(), rhs.Serialize()));
+    TSkiffData::operator=(TSkiffData(rhs.Layout(), rhs.Serialize()));
     ObjectiveValue_.reset();
 
     return *this;
@@ -264,13 +204,7 @@ size_t TSkiffVariant::VariantNumber() const {
 }
 
 size_t TSkiffVariant::VariantsCount() const {
-    auto variantSchema = GetSchema()->StripTags()->AsVariant();
-
-    if (variantSchema->IsVariantOverTuple()) {
-        return variantSchema->GetUnderlyingType()->AsTuple()->GetElements().size();
-    } else {
-        return variantSchema->GetUnderlyingType()->AsStruct()->GetMembers().size();
-    }
+    return Layout()->ChildrenCount();
 }
 
 bool TSkiffVariant::IsTerminal() const {
@@ -285,7 +219,8 @@ void TSkiffVariant::EmplaceVariant(size_t number) {
 
     Buffer().Clear();
     Buffer().Append(reinterpret_cast<const char*>(&number), tagSize);
-    AddField(SkiffSchemaFromTypeV3(GetChildType(number)), Buffer());
+    const auto& defaultData = GetChildLayout(number)->DefaultData();
+    Buffer().Append(defaultData.Data(), defaultData.Size());
 }
 
 size_t TSkiffVariant::TagSize() const {
@@ -319,7 +254,7 @@ TSkiffDataConstPtr TSkiffVariant::GetSkiffDataPtr(size_t ind) const {
     auto tagSize = TagSize();
     TBuffer data(Buffer().Begin() + tagSize, Buffer().Size() - tagSize);
 
-    return ObjectiveValue_ = CreateSkiffData(GetChildType(ind), std::move(data));
+    return ObjectiveValue_ = CreateSkiffData(GetChildLayout(ind), std::move(data));
 }
 
 TSkiffDataPtr& TSkiffVariant::GetSkiffDataPtr(size_t ind) {
@@ -333,18 +268,12 @@ TSkiffDataPtr& TSkiffVariant::GetSkiffDataPtr(size_t ind) {
 
     auto tagSize = TagSize();
 
-    return ObjectiveValue_ = CreateSkiffData(GetChildType(ind),
+    return ObjectiveValue_ = CreateSkiffData(GetChildLayout(ind),
         TBuffer(Buffer().Data() + tagSize, Buffer().Size() - tagSize));
 }
 
-NTi::TTypePtr TSkiffVariant::GetChildType(size_t ind) const {
-    auto variantSchema = GetSchema()->StripTags()->AsVariant();
-
-    if (variantSchema->IsVariantOverTuple()) {
-        return variantSchema->GetUnderlyingType()->AsTuple()->GetElements()[ind].GetType();
-    } else {
-        return variantSchema->GetUnderlyingType()->AsStruct()->GetMembers()[ind].GetType();
-    }
+const TSkiffLayoutPtr& TSkiffVariant::GetChildLayout(size_t ind) const {
+    return Layout()->Child(ind);
 }
 
 bool TSkiffVariant::NeedRebuild() const {
@@ -365,6 +294,16 @@ TBuffer TSkiffVariant::SerializeImpl() const {
     return res;
 }
 
+void TSkiffVariant::AppendSegments(TSkiffSegments& segments) const {
+    if (!ObjectiveValue_) {
+        AppendSegment(segments, Buffer().Data(), Buffer().Size());
+        return;
+    }
+
+    AppendSegment(segments, Buffer().Data(), TagSize());
+    ObjectiveValue_->AppendSegments(segments);
+}
+
 void TSkiffVariant::SoftRebuild() {
     HardRebuild();
 }
@@ -388,6 +327,11 @@ TSkiffOptional::TSkiffOptional(NTi::TTypePtr schema) : TSkiffVariant(std::move(s
 TSkiffOptional::TSkiffOptional(NTi::TTypePtr schema, TBuffer&& buf)
   : TSkiffVariant(std::move(schema), std::move(buf)) { }
 
+TSkiffOptional::TSkiffOptional(TSkiffLayoutPtr layout) : TSkiffVariant(std::move(layout)) { }
+
+TSkiffOptional::TSkiffOptional(TSkiffLayoutPtr layout, TBuffer&& buf)
+  : TSkiffVariant(std::move(layout), std::move(buf)) { }
+
 TSkiffOptional::TSkiffOptional(const TSkiffOptional& rhs)
   : TSkiffVariant(rhs) { }
 
@@ -446,66 +390,62 @@ TSkiffDataPtr& TSkiffOptional::GetSkiffDataPtr(bool ind) {
     return GetSkiffDataPtr(static_cast<size_t>(ind));
 }
 
-NTi::TTypePtr TSkiffOptional::GetChildType(bool ind) const {
-    return ind ? GetSchema()->StripTags()->AsOptional()->GetItemType() : NTi::Null();
-}
-
-NTi::TTypePtr TSkiffOptional::GetChildType(size_t ind) const {
-    return GetChildType(static_cast<bool>(ind));
+const TSkiffLayoutPtr& TSkiffOptional::GetChildLayout(bool ind) const {
+    return GetChildLayout(static_cast<size_t>(ind));
 }
 
 // TSkiffList
 
-TSkiffList::TSkiffList(NTi::TTypePtr schema) : TSkiffData(std::move(schema)) { }
+TSkiffList::TSkiffList(NTi::TTypePtr schema) : TSkiffList(MakeSkiffLayout(std::move(schema))) { }
 
 TSkiffList::TSkiffList(NTi::TTypePtr schema, TBuffer&& buf)
-  : TSkiffData(std::move(schema), std::move(buf)) {
-
-    auto skiffSchema = SkiffSchemaFromTypeV3(GetSchema());
-    auto elemSchema = skiffSchema->GetChildren()[0];
+  : TSkiffList(MakeSkiffLayout(std::move(schema)), std::move(buf)) { }
 
-    ElementsOffsets_.push_back(0);
+TSkiffList::TSkiffList(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> elementsOffsets)
+  : TSkiffList(MakeSkiffLayout(std::move(schema)), std::move(buf), std::move(elementsOffsets)) { }
 
-    while (*reinterpret_cast<const uint8_t*>(Buffer().Data() + ElementsOffsets_.back()) !=
-           TSkiffVariant::Terminal8Tag()) {
+TSkiffList::TSkiffList(TSkiffLayoutPtr layout)
+  : TSkiffData(std::move(layout))
+  , ElementsOffsets_({ 0 }) { }
 
-        ElementsOffsets_.push_back(ElementsOffsets_.back() + 
-            SkiffDataSize(elemSchema, Buffer().Data() + ElementsOffsets_.back() + 1) + 1);
-    }
+TSkiffList::TSkiffList(TSkiffLayoutPtr layout, TBuffer&& buf)
+  : TSkiffData(std::move(layout), std::move(buf)) {
 
-    ObjectiveValues_.assign(ElementsOffsets_.size() - 1, nullptr);
+    CalculateElementsOffsets();
 }
 
-TSkiffList::TSkiffList(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> elementsOffsets)
-  : TSkiffData(std::move(schema), std::move(buf))
+TSkiffList::TSkiffList(TSkiffLayoutPtr layout, TBuffer&& buf, std::vector<ptrdiff_t> elementsOffsets)
+  : TSkiffData(std::move(layout), std::move(buf))
   , ElementsOffsets_(std::move(elementsOffsets)) { }
 
-TSkiffList::TSkiffList(const TSkiffList& rhs) : TSkiffData(rhs.GetSchema(), {}) {
+TSkiffList::TSkiffList(const TSkiffList& rhs) : TSkiffData(rhs.Layout(), {}) {
     *this = rhs;
 }
 
-TSkiffList::TSkiffList(TSkiffList&& rhs) : TSkiffData(rhs.GetSchema(), {}) {
+TSkiffList::TSkiffList(TSkiffList&& rhs) : TSkiffData(rhs.Layout(), {}) {
     *this = std::move(rhs);
 }
 
 TSkiffList& TSkiffList::operator=(const TSkiffList& rhs) {
-    TSkiffData::operator=(TSkiffData(rhs.GetSchema(), rhs.Serialize()));
+    TSkiffData::operator=(TSkiffData(rhs.Layout(), rhs.Serialize()));
+    CalculateElementsOffsets();
+
+    return *this;
+}
 
-    auto skiffSchema = SkiffSchemaFromTypeV3(GetSchema());
-    auto elemSchema = skiffSchema->GetChildren()[0];
+void TSkiffList::CalculateElementsOffsets() {
+    const auto& elemLayout = GetChildLayout(0);
 
-    ElementsOffsets_.push_back(0);
+    ElementsOffsets_.assign(1, 0);
 
     while (*reinterpret_cast<const uint8_t*>(Buffer().Data() + ElementsOffsets_.back()) !=
            TSkiffVariant::Terminal8Tag()) {
 
         ElementsOffsets_.push_back(ElementsOffsets_.back() + 
-            SkiffDataSize(elemSchema, Buffer().Data() + ElementsOffsets_.back() + 1) + 1);
+            elemLayout->DataSize(Buffer().Data() + ElementsOffsets_.back() + 1) + 1);
     }
 
     ObjectiveValues_.assign(ElementsOffsets_.size() - 1, nullptr);
-
-    return *this;
 }
 
 TSkiffList& TSkiffList::operator=(TSkiffList&& rhs) {
@@ -545,7 +485,9 @@ void TSkiffList::Extend() {
     ObjectiveValues_.emplace_back();
 
     *reinterpret_cast<uint8_t*>(Buffer().End() - 1) = 0;
-    AddField(SkiffSchemaFromTypeV3(GetChildType(0)), Buffer());
+
+    const auto& defaultData = GetChildLayout(0)->DefaultData();
+    Buffer().Append(defaultData.Data(), defaultData.Size());
 
     ElementsOffsets_.push_back(Buffer().Size());
     Buffer().Append(TSkiffVariant::Terminal8Tag());
@@ -568,7 +510,7 @@ TSkiffDataConstPtr TSkiffList::GetSkiffDataPtr(size_t ind) const {
 
     TBuffer data(GetRawDataPtr(ind), ElementsOffsets_[ind + 1] - ElementsOffsets_[ind] - 1);
 
-    return ObjectiveValues_[ind] = CreateSkiffData(GetChildType(ind), std::move(data));
+    return ObjectiveValues_[ind] = CreateSkiffData(GetChildLayout(ind), std::move(data));
 }
 
 TSkiffDataPtr& TSkiffList::GetSkiffDataPtr(size_t ind) {
@@ -578,11 +520,11 @@ TSkiffDataPtr& TSkiffList::GetSkiffDataPtr(size_t ind) {
 
     TBuffer data(GetRawDataPtr(ind), ElementsOffsets_[ind + 1] - ElementsOffsets_[ind] - 1);
 
-    return ObjectiveValues_[ind] = CreateSkiffData(GetChildType(ind), std::move(data));
+    return ObjectiveValues_[ind] = CreateSkiffData(GetChildLayout(ind), std::move(data));
 }
 
-NTi::TTypePtr TSkiffList::GetChildType(size_t /* ind */) const {
-    return GetSchema()->StripTags()->AsList()->GetItemType();
+const TSkiffLayoutPtr& TSkiffList::GetChildLayout(size_t /* ind */) const {
+    return Layout()->Child(0);
 }
 
 bool TSkiffList::NeedRebuild() const {
@@ -613,6 +555,23 @@ TBuffer TSkiffList::SerializeImpl() const {
     return res;
 }
 
+void TSkiffList::AppendSegments(TSkiffSegments& segments) const {
+    // Unmodified elements between modified ones make a single segment together with their tags
+    size_t cleanBegin = 0;
+
+    for (size_t i = 0; i < Size(); ++i) {
+        if (ObjectiveValues_[i]) {
+            const size_t dataBegin = ElementsOffsets_[i] + 1;
+            AppendSegment(segments, Buffer().Data() + cleanBegin, dataBegin - cleanBegin);
+
+            ObjectiveValues_[i]->AppendSegments(segments);
+            cleanBegin = ElementsOffsets_[i + 1];
+        }
+    }
+
+    AppendSegment(segments, Buffer().Data() + cleanBegin, Buffer().Size() - cleanBegin);
+}
+
 void TSkiffList::SoftRebuild() {
     for (size_t i = 0; i < Size(); ++i) {
         if (ObjectiveValues_[i]) {
@@ -665,55 +624,62 @@ void TSkiffList::HardRebuild() {
 
 // TSkiffTuple
 
-TSkiffTuple::TSkiffTuple(NTi::TTypePtr schema) : TSkiffData(schema, {}) {
-    auto skiffSchema = SkiffSchemaFromTypeV3(schema);
-    const auto& children = skiffSchema->GetChildren();
+TSkiffTuple::TSkiffTuple(NTi::TTypePtr schema) : TSkiffTuple(MakeSkiffLayout(std::move(schema))) { }
 
-    FieldsDataOffsets_.reserve(children.size());
-    ObjectiveValues_.assign(children.size(), nullptr);
+TSkiffTuple::TSkiffTuple(NTi::TTypePtr schema, TBuffer&& buf)
+  : TSkiffTuple(MakeSkiffLayout(std::move(schema)), std::move(buf)) { }
 
-    for (const auto& child : children) {
-        FieldsDataOffsets_.emplace_back(AddField(child, Buffer()));
-    }
-}
+TSkiffTuple::TSkiffTuple(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffTuple(MakeSkiffLayout(std::move(schema)), std::move(buf), std::move(fieldsOffsets)) { }
 
-TSkiffTuple::TSkiffTuple(NTi::TTypePtr schema, TBuffer&& buf)
-  : TSkiffData(std::move(schema), std::move(buf)) {
+TSkiffTuple::TSkiffTuple(NTi::TTypePtr schema, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffTuple(MakeSkiffLayout(std::move(schema)), borrowed, std::move(fieldsOffsets)) { }
 
-    auto skiffSchema = SkiffSchemaFromTypeV3(GetSchema());
-    const auto& children = skiffSchema->GetChildren();
+TSkiffTuple::TSkiffTuple(TSkiffLayoutPtr layout)
+  : TSkiffData(std::move(layout))
+  , FieldsDataOffsets_(Layout()->DefaultOffsets())
+  , ObjectiveValues_(FieldsDataOffsets_.size()) {
+}
 
-    FieldsDataOffsets_ = CalculateOffsets(children, {Buffer().Data(), Buffer().Size()});
-    ObjectiveValues_.assign(children.size(), nullptr);
+TSkiffTuple::TSkiffTuple(TSkiffLayoutPtr layout, TBuffer&& buf)
+  : TSkiffData(std::move(layout), std::move(buf))
+  , FieldsDataOffsets_(Layout()->FieldsOffsets({Buffer().Data(), Buffer().Size()}))
+  , ObjectiveValues_(FieldsDataOffsets_.size()) {
 }
 
-TSkiffTuple::TSkiffTuple(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets)
-  : TSkiffData(std::move(schema), std::move(buf))
+TSkiffTuple::TSkiffTuple(TSkiffLayoutPtr layout, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffData(std::move(layout), std::move(buf))
   , FieldsDataOffsets_(std::move(fieldsOffsets))
   , ObjectiveValues_(FieldsDataOffsets_.size()) {
 }
 
-TSkiffTuple::TSkiffTuple(const TSkiffTuple& rhs) : TSkiffData(rhs.GetSchema(), rhs.Serialize()) {
-    auto skiffSchema = SkiffSchemaFromTypeV3(GetSchema());
-    const auto& children = skiffSchema->GetChildren();
+TSkiffTuple::TSkiffTuple(TSkiffLayoutPtr layout, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffData(std::move(layout), {})
+  , FieldsDataOffsets_(std::move(fieldsOffsets))
+  , ObjectiveValues_(FieldsDataOffsets_.size())
+  , Borrowed_(borrowed) {
+}
 
-    FieldsDataOffsets_ = CalculateOffsets(children, {Buffer().Data(), Buffer().Size()});
-    ObjectiveValues_.assign(children.size(), nullptr);
+TSkiffTuple::TSkiffTuple(const TSkiffTuple& rhs) : TSkiffData(rhs.Layout(), rhs.Serialize()) {
+    // Offsets stay the same unless some fields have been modified
+    FieldsDataOffsets_ = rhs.NeedRebuild() ? Layout()->FieldsOffsets({Buffer().Data(), Buffer().Size()})
+                                           : rhs.FieldsDataOffsets_;
+    ObjectiveValues_.assign(FieldsDataOffsets_.size(), nullptr);
 }
 
 TSkiffTuple::TSkiffTuple(TSkiffTuple&& rhs)
-  : TSkiffData(rhs.GetSchema(), std::move(rhs.Buffer()))
+  : TSkiffData(rhs.Layout(), std::move(rhs.Buffer()))
   , FieldsDataOffsets_(std::move(rhs.FieldsDataOffsets_))
-  , ObjectiveValues_(std::move(rhs.ObjectiveValues_)) { }
+  , ObjectiveValues_(std::move(rhs.ObjectiveValues_))
+  , Borrowed_(std::exchange(rhs.Borrowed_, {})) { }
 
 TSkiffTuple& TSkiffTuple::operator=(const TSkiffTuple& rhs) {
-    TSkiffData::operator=(TSkiffData(rhs.GetSchema(), rhs.Serialize()));
-
-    auto skiffSchema = SkiffSchemaFromTypeV3(GetSchema());
-    const auto& children = skiffSchema->GetChildren();
+    TSkiffData::operator=(TSkiffData(rhs.Layout(), rhs.Serialize()));
+    Borrowed_ = {};
 
-    FieldsDataOffsets_ = CalculateOffsets(children, {Buffer().Data(), Buffer().Size()});
-    ObjectiveValues_.assign(children.size(), nullptr);
+    FieldsDataOffsets_ = rhs.NeedRebuild() ? Layout()->FieldsOffsets({Buffer().Data(), Buffer().Size()})
+                                           : rhs.FieldsDataOffsets_;
+    ObjectiveValues_.assign(FieldsDataOffsets_.size(), nullptr);
 
     return *this;
 }
@@ -721,6 +687,7 @@ TSkiffTuple& TSkiffTuple::operator=(const TSkiffTuple& rhs) {
 TSkiffTuple& TSkiffTuple::operator=(TSkiffTuple&& rhs) {
     FieldsDataOffsets_ = std::move(rhs.FieldsDataOffsets_);
     ObjectiveValues_ = std::move(rhs.ObjectiveValues_);
+    Borrowed_ = std::exchange(rhs.Borrowed_, {});
 
     TSkiffData::operator=(std::move(rhs));
 
@@ -735,14 +702,57 @@ size_t TSkiffTuple::FieldsCount() const {
     return ObjectiveValues_.size();
 }
 
+void TSkiffTuple::Detach() {
+    if (!IsBorrowed()) {
+        return;
+    }
+
+    Buffer().Clear();
+    Buffer().Append(Borrowed_.data(), Borrowed_.size());
+    Borrowed_ = {};
+}
+
+void TSkiffTuple::Assign(std::string_view data, const std::vector<ptrdiff_t>& fieldsOffsets) {
+    Borrowed_ = {};
+
+    Buffer().Clear();
+    Buffer().Append(data.data(), data.size());
+
+    FieldsDataOffsets_ = fieldsOffsets;
+    ObjectiveValues_.assign(FieldsDataOffsets_.size(), nullptr);
+}
+
+std::string_view TSkiffTuple::SerializedView() {
+    // Unmodified borrowed data is returned as is, without detaching
+    if (IsBorrowed() && !NeedRebuild()) {
+        return Borrowed_;
+    }
+
+    return TSkiffData::SerializedView();
+}
+
+void TSkiffTuple::AppendSegments(TSkiffSegments& segments) const {
+    // Unmodified fields between modified ones make a single segment
+    size_t cleanBegin = 0;
+
+    for (size_t i = 0; i < FieldsCount(); ++i) {
+        if (ObjectiveValues_[i]) {
+            AppendSegment(segments, DataBegin() + cleanBegin, FieldsDataOffsets_[i] - cleanBegin);
+
+            ObjectiveValues_[i]->AppendSegments(segments);
+            cleanBegin = FieldsDataOffsets_[i] + FieldDataSize(i);
+        }
+    }
+
+    AppendSegment(segments, DataBegin() + cleanBegin, DataSize() - cleanBegin);
+}
+
 const char* TSkiffTuple::GetRawDataPtr(size_t ind) const {
-    return ObjectiveValues_[ind] ? TSkiffData::GetBuffer(*ObjectiveValues_[ind]).Data()
-                                 : Buffer().Data() + FieldsDataOffsets_[ind];
+    return FieldData(ind);
 }
 
 char* TSkiffTuple::GetRawDataPtr(size_t ind) {
-    return ObjectiveValues_[ind] ? TSkiffData::GetBuffer(*ObjectiveValues_[ind]).Data()
-                                 : Buffer().Data() + FieldsDataOffsets_[ind];
+    return MutableFieldData(ind);
 }
 
 TSkiffDataConstPtr TSkiffTuple::GetSkiffDataPtr(size_t ind) const {
@@ -750,11 +760,9 @@ TSkiffDataConstPtr TSkiffTuple::GetSkiffDataPtr(size_t ind) const {
         return ObjectiveValues_[ind];
     }
 
-    TBuffer data(GetRawDataPtr(ind),
-        (ind < FieldsCount() - 1 ? FieldsDataOffsets_[ind + 1] : Buffer().Size()) - 
-        FieldsDataOffsets_[ind]);
+    TBuffer data(DataBegin() + FieldsDataOffsets_[ind], FieldDataSize(ind));
 
-    return ObjectiveValues_[ind] = CreateSkiffData(GetChildType(ind), std::move(data));
+    return ObjectiveValues_[ind] = CreateSkiffData(GetChildLayout(ind), std::move(data));
 }
 
 TSkiffDataPtr& TSkiffTuple::GetSkiffDataPtr(size_t ind) {
@@ -762,15 +770,13 @@ TSkiffDataPtr& TSkiffTuple::GetSkiffDataPtr(size_t ind) {
         return ObjectiveValues_[ind];
     }
 
-    TBuffer data(GetRawDataPtr(ind),
-        (ind < FieldsCount() - 1 ? FieldsDataOffsets_[ind + 1] : Buffer().Size()) - 
-        FieldsDataOffsets_[ind]);
+    TBuffer data(DataBegin() + FieldsDataOffsets_[ind], FieldDataSize(ind));
 
-    return ObjectiveValues_[ind] = CreateSkiffData(GetChildType(ind), std::move(data));
+    return ObjectiveValues_[ind] = CreateSkiffData(GetChildLayout(ind), std::move(data));
 }
 
-NTi::TTypePtr TSkiffTuple::GetChildType(size_t ind) const {
-    return GetSchema()->StripTags()->AsTuple()->GetElements()[ind].GetType();
+const TSkiffLayoutPtr& TSkiffTuple::GetChildLayout(size_t ind) const {
+    return Layout()->Child(ind);
 }
 
 bool TSkiffTuple::NeedRebuild() const {
@@ -780,7 +786,7 @@ bool TSkiffTuple::NeedRebuild() const {
 
 TBuffer TSkiffTuple::SerializeImpl() const {
     if (!NeedRebuild()) {
-        return Buffer();
+        return IsBorrowed() ? TBuffer(Borrowed_.data(), Borrowed_.size()) : Buffer();
     }
 
     TBuffer res;
@@ -790,8 +796,7 @@ TBuffer TSkiffTuple::SerializeImpl() const {
             TBuffer data = ObjectiveValues_[i]->Serialize();
             res.Append(data.Data(), data.Size());
         } else {
-            res.Append(GetRawDataPtr(i), (i < FieldsCount() - 1 ? FieldsDataOffsets_[i + 1] 
-                                          : Buffer().Size()) - FieldsDataOffsets_[i]);
+            res.Append(GetRawDataPtr(i), FieldDataSize(i));
         }
     }
 
@@ -799,6 +804,8 @@ TBuffer TSkiffTuple::SerializeImpl() const {
 }
 
 void TSkiffTuple::SoftRebuild() {
+    Detach();
+
     for (size_t i = 0; i < FieldsCount(); ++i) {
         if (ObjectiveValues_[i]) {
             size_t currentSerializationSize = (i < FieldsCount() - 1 ? FieldsDataOffsets_[i + 1] 
@@ -822,6 +829,8 @@ void TSkiffTuple::SoftRebuild() {
 }
 
 void TSkiffTuple::HardRebuild() {
+    Detach();
+
     TBuffer res;
     std::vector<ptrdiff_t> newOffsets = { 0 };
     newOffsets.reserve(FieldsDataOffsets_.size());
@@ -848,48 +857,39 @@ void TSkiffTuple::HardRebuild() {
 
 // TSkiffStruct
 
-TSkiffStruct::TIndexesMap TSkiffStruct::BuildIndexesMap(NTi::TStructTypePtr type) {
-    TIndexesMap res;
+TSkiffStruct::TSkiffStruct(NTi::TTypePtr schema) : TSkiffTuple(std::move(schema)) { }
 
-    for (const auto& field : type->GetMembers()) {
-        res[field.GetName()] = res.size();
-    }
+TSkiffStruct::TSkiffStruct(NTi::TTypePtr schema, TBuffer&& buf)
+  : TSkiffTuple(std::move(schema), std::move(buf)) { }
 
-    return std::move(res);
-}
+TSkiffStruct::TSkiffStruct(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffTuple(std::move(schema), std::move(buf), std::move(fieldsOffsets)) { }
 
-TSkiffStruct::TSkiffStruct(NTi::TTypePtr schema)
-  : TSkiffTuple(std::move(schema))
-  , IndexesMap_(BuildIndexesMap(GetSchema()->StripTags()->AsStruct())) { }
+TSkiffStruct::TSkiffStruct(NTi::TTypePtr schema, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffTuple(std::move(schema), borrowed, std::move(fieldsOffsets)) { }
 
-TSkiffStruct::TSkiffStruct(NTi::TTypePtr schema, TBuffer&& buf)
-  : TSkiffTuple(std::move(schema), std::move(buf))
-  , IndexesMap_(BuildIndexesMap(GetSchema()->StripTags()->AsStruct())) { }
+TSkiffStruct::TSkiffStruct(TSkiffLayoutPtr layout) : TSkiffTuple(std::move(layout)) { }
 
+TSkiffStruct::TSkiffStruct(TSkiffLayoutPtr layout, TBuffer&& buf)
+  : TSkiffTuple(std::move(layout), std::move(buf)) { }
 
-TSkiffStruct::TSkiffStruct(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets)
-  : TSkiffTuple(std::move(schema), std::move(buf), std::move(fieldsOffsets))
-  , IndexesMap_(BuildIndexesMap(GetSchema()->StripTags()->AsStruct())) { }
+TSkiffStruct::TSkiffStruct(TSkiffLayoutPtr layout, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffTuple(std::move(layout), std::move(buf), std::move(fieldsOffsets)) { }
 
-TSkiffStruct::TSkiffStruct(const TSkiffStruct& rhs)
-  : TSkiffTuple(rhs)
-  , IndexesMap_(rhs.IndexesMap_) { }
+TSkiffStruct::TSkiffStruct(TSkiffLayoutPtr layout, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffTuple(std::move(layout), borrowed, std::move(fieldsOffsets)) { }
 
-TSkiffStruct::TSkiffStruct(TSkiffStruct&& rhs)
-  : TSkiffTuple(std::move(rhs))
-  , IndexesMap_(std::move(rhs.IndexesMap_)) { }
+TSkiffStruct::TSkiffStruct(const TSkiffStruct& rhs) : TSkiffTuple(rhs) { }
+
+TSkiffStruct::TSkiffStruct(TSkiffStruct&& rhs) : TSkiffTuple(std::move(rhs)) { }
 
 TSkiffStruct& TSkiffStruct::operator=(const TSkiffStruct& rhs) {
-    IndexesMap_ = rhs.IndexesMap_;
     TSkiffTuple::operator=(rhs);
-
     return *this;
 }
 
 TSkiffStruct& TSkiffStruct::operator=(TSkiffStruct&& rhs) {
-    IndexesMap_ = std::move(rhs.IndexesMap_);
     TSkiffTuple::operator=(std::move(rhs));
-
     return *this;
 }
 
@@ -909,27 +909,23 @@ std::vector<std::string> TSkiffStruct::FieldsNames() const {
 }
 
 const char* TSkiffStruct::GetRawDataPtr(std::string_view ind) const {
-    return GetRawDataPtr(IndexesMap_.at(ind));
+    return GetRawDataPtr(IndexesMap().at(ind));
 }
 
 char* TSkiffStruct::GetRawDataPtr(std::string_view ind) {
-    return GetRawDataPtr(IndexesMap_.at(ind));
+    return GetRawDataPtr(IndexesMap().at(ind));
 }
 
 TSkiffDataConstPtr TSkiffStruct::GetSkiffDataPtr(std::string_view ind) const {
-    return GetSkiffDataPtr(IndexesMap_.at(ind));
+    return GetSkiffDataPtr(IndexesMap().at(ind));
 }
 
 TSkiffDataPtr& TSkiffStruct::GetSkiffDataPtr(std::string_view ind) {
-    return GetSkiffDataPtr(IndexesMap_.at(ind));
-}
-
-NTi::TTypePtr TSkiffStruct::GetChildType(std::string_view ind) const {
-    return GetSchema()->StripTags()->AsStruct()->GetMember(ind).GetType();
+    return GetSkiffDataPtr(IndexesMap().at(ind));
 }
 
-NTi::TTypePtr TSkiffStruct::GetChildType(size_t ind) const {
-    return GetSchema()->StripTags()->AsStruct()->GetMembers()[ind].GetType();
+const TSkiffLayoutPtr& TSkiffStruct::GetChildLayout(std::string_view ind) const {
+    return GetChildLayout(IndexesMap().at(ind));
 }
 
 // TSkiffDict
@@ -938,12 +934,6 @@ IDictPtr TSkiffDict::CopyDict() const {
     return std::make_shared<TSkiffDict>(*this);
 }
 
-NTi::TTypePtr TSkiffDict::GetChildType(size_t) const {
-    auto dictSchema = GetSchema()->StripTags()->AsDict();
-    return NTi::Struct({NTi::TStructType::TOwnedMember("key", dictSchema->GetKeyType()),
-                       NTi::TStructType::TOwnedMember("value", dictSchema->GetValueType())});
-}
-
 // TSkiffRow
 
 TSkiffRow::TSkiffRow(NTi::TTypePtr schema) : TSkiffStruct(std::move(schema)) { }
@@ -954,6 +944,20 @@ TSkiffRow::TSkiffRow(NTi::TTypePtr schema, TBuffer&& buf)
 TSkiffRow::TSkiffRow(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets)
   : TSkiffStruct(std::move(schema), std::move(buf), std::move(fieldsOffsets)) { }
 
+TSkiffRow::TSkiffRow(NTi::TTypePtr schema, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffStruct(std::move(schema), borrowed, std::move(fieldsOffsets)) { }
+
+TSkiffRow::TSkiffRow(TSkiffLayoutPtr layout) : TSkiffStruct(std::move(layout)) { }
+
+TSkiffRow::TSkiffRow(TSkiffLayoutPtr layout, TBuffer&& buf)
+  : TSkiffStruct(std::move(layout), std::move(buf)) { }
+
+TSkiffRow::TSkiffRow(TSkiffLayoutPtr layout, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffStruct(std::move(layout), std::move(buf), std::move(fieldsOffsets)) { }
+
+TSkiffRow::TSkiffRow(TSkiffLayoutPtr layout, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets)
+  : TSkiffStruct(std::move(layout), borrowed, std::move(fieldsOffsets)) { }
+
 TSkiffRow::TSkiffRow(const NYT::TTableSchema& schema)
   : TSkiffRow(TableSchemaToStructType(schema)) { }
 
@@ -981,8 +985,4 @@ IRowPtr TSkiffRow::CopyRow() const {
     return std::make_shared<TSkiffRow>(*this); 
 }
 
-NTi::TTypePtr TSkiffRow::GetChildType(size_t ind) const {
-    return GetSchema()->StripTags()->AsStruct()->GetMembers()[ind].GetType();
-}
-
 }
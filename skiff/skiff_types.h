@@ -9,10 +9,12 @@
 #include <library/cpp/skiff/skiff_schema.h>
 #include <library/cpp/type_info/type.h>
 #include <util/generic/buffer.h>
+#include <util/stream/output.h>
 #include <util/generic/vector.h>
 
 #include <dformats/interface/types.h>
 #include <dformats/skiff/skiff_schema.h>
+#include <dformats/skiff/skiff_layout.h>
 
 namespace DFormats {
 
@@ -27,6 +29,8 @@ class TSkiffOptional;
 using TSkiffDataPtr = std::shared_ptr<TSkiffData>;
 using TSkiffDataConstPtr = std::shared_ptr<const TSkiffData>;
 
+using TSkiffSegments = std::vector<IOutputStream::TPart>;
+
 std::string SkiffSerializeString(std::string_view str);
 std::string_view SkiffDeserializeString(const char* skiffStr);
 
@@ -37,6 +41,8 @@ class TSkiffData {
 public:
     TSkiffData(NTi::TTypePtr schema);
     TSkiffData(NTi::TTypePtr schema, TBuffer&& buf);
+    TSkiffData(TSkiffLayoutPtr layout);
+    TSkiffData(TSkiffLayoutPtr layout, TBuffer&& buf);
     TSkiffData(const TSkiffData& rhs);
     TSkiffData(TSkiffData&& rhs);
 
@@ -46,11 +52,15 @@ public:
     virtual ~TSkiffData() = default;
 
     inline NTi::TTypePtr GetSchema() const {
-        return Schema_;
+        return Layout_->Type();
     }
 
     inline NSkiff::TSkiffSchemaPtr SkiffSchema() const {
-        return SkiffSchemaFromTypeV3(Schema_);
+        return Layout_->SkiffSchema();
+    }
+
+    inline const TSkiffLayoutPtr& Layout() const {
+        return Layout_;
     }
 
     inline virtual bool NeedRebuild() const {
@@ -64,6 +74,18 @@ public:
     TBuffer Serialize() &&;
     TBuffer Serialize() const &&;
 
+    // Rebuilds object if needed and returns its serialization without copying.
+    // The view is valid until the object is modified
+    virtual std::string_view SerializedView();
+
+    // Appends serialization of the object as a list of memory ranges: unmodified spans of object's
+    // data interleaved with serializations of modified nested objects. Ranges point into the object
+    // and are valid until it's modified
+    virtual void AppendSegments(TSkiffSegments& segments) const;
+
+    // Writes the segments to the stream at once, without concatenating them
+    void SerializeTo(IOutputStream& out) const;
+
     inline virtual void SoftRebuild() {}
     inline virtual void HardRebuild() {
         Data_ = std::move(SerializeImpl());
@@ -89,7 +111,7 @@ protected:
     }
 
 private:
-    NTi::TTypePtr Schema_;
+    TSkiffLayoutPtr Layout_;
     TBuffer Data_;
 };
 
@@ -97,51 +119,51 @@ template <typename IndexType>
 class ISkiffIndexed : virtual public IBaseIndexed<IndexType> {
 protected:
     bool GetBool(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Bool, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const bool*>(GetRawDataPtr(ind));
     }
     int8_t GetInt8(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Int8, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const int8_t*>(GetRawDataPtr(ind));
     }
     int16_t GetInt16(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Int16, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const int16_t*>(GetRawDataPtr(ind));
     }
     int32_t GetInt32(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Int32, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const int32_t*>(GetRawDataPtr(ind));
     }
     int64_t GetInt64(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Int64 || type == NTi::ETypeName::Interval ||
                  type == NTi::ETypeName::Interval64, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const int64_t*>(GetRawDataPtr(ind));
     }
     uint8_t GetUInt8(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Uint8, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const uint8_t*>(GetRawDataPtr(ind));
     }
     uint16_t GetUInt16(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Uint16 || 
                  type == NTi::ETypeName::Date, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const uint16_t*>(GetRawDataPtr(ind));
     }
     uint32_t GetUInt32(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Uint32 || type == NTi::ETypeName::TzDate ||
                  type == NTi::ETypeName::TzDatetime || type == NTi::ETypeName::Datetime ||
                  type == NTi::ETypeName::Date32, "Type missmatch while getting skiff value");
@@ -149,7 +171,7 @@ protected:
         return *reinterpret_cast<const uint32_t*>(GetRawDataPtr(ind));
     }
     uint64_t GetUInt64(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Uint64 || type == NTi::ETypeName::Timestamp ||
                  type == NTi::ETypeName::TzTimestamp || type == NTi::ETypeName::Timestamp64 ||
                  type == NTi::ETypeName::Datetime64, "Type missmatch while getting skiff value");
@@ -157,20 +179,20 @@ protected:
         return *reinterpret_cast<const uint64_t*>(GetRawDataPtr(ind));
     }
     float GetFloat(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Float, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const float*>(GetRawDataPtr(ind));
     }
     double GetDouble(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Double, "Type missmatch while getting skiff value");
 
         return *reinterpret_cast<const double*>(GetRawDataPtr(ind));
     }
 
     std::string_view GetString(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
 
         if (type == NTi::ETypeName::Uuid) {
             return {GetRawDataPtr(ind), 16};
@@ -183,88 +205,88 @@ protected:
         return SkiffDeserializeString(GetRawDataPtr(ind));
     }
     IStructConstPtr GetStruct(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Struct, "Type missmatch while getting skiff value");
 
         return std::dynamic_pointer_cast<const IBaseStruct>(GetSkiffDataPtr(ind));
     }
     ITupleConstPtr GetTuple(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Tuple, "Type missmatch while getting skiff value");
 
         return std::dynamic_pointer_cast<const IBaseTuple>(GetSkiffDataPtr(ind));
     }
     IListConstPtr GetList(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::List, "Type missmatch while getting skiff value");
 
         return std::dynamic_pointer_cast<const IBaseList>(GetSkiffDataPtr(ind));
     }
     IDictConstPtr GetDict(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Dict, "Type missmatch while getting skiff value");
 
         return std::dynamic_pointer_cast<const IBaseDict>(GetSkiffDataPtr(ind));
     }
     IVariantConstPtr GetVariant(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Variant, "Type missmatch while getting skiff value");
 
         return std::dynamic_pointer_cast<const IBaseVariant>(GetSkiffDataPtr(ind));
     }
     IOptionalConstPtr GetOptional(IndexType ind) const override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Optional, "Type missmatch while getting skiff value");
 
         return std::dynamic_pointer_cast<const IBaseOptional>(GetSkiffDataPtr(ind));
     }
 
     void SetBool(IndexType ind, bool value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Bool, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<bool*>(GetRawDataPtr(ind)) = value;
     }
     void SetInt8(IndexType ind, int8_t value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Int8, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<int8_t*>(GetRawDataPtr(ind)) = value;
     }
     void SetInt16(IndexType ind, int16_t value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Int16, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<int16_t*>(GetRawDataPtr(ind)) = value;
     }
     void SetInt32(IndexType ind, int32_t value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Int32, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<int32_t*>(GetRawDataPtr(ind)) = value;
     }
     void SetInt64(IndexType ind, int64_t value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Int64 || type == NTi::ETypeName::Interval ||
                  type == NTi::ETypeName::Interval64, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<int64_t*>(GetRawDataPtr(ind)) = value;
     }
     void SetUInt8(IndexType ind, uint8_t value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Uint8, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<uint8_t*>(GetRawDataPtr(ind)) = value;
     }
     void SetUInt16(IndexType ind, uint16_t value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Uint16 || 
                  type == NTi::ETypeName::Date, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<uint16_t*>(GetRawDataPtr(ind)) = value;
     }
     void SetUInt32(IndexType ind, uint32_t value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Uint32 || type == NTi::ETypeName::TzDate ||
                  type == NTi::ETypeName::TzDatetime || type == NTi::ETypeName::Datetime ||
                  type == NTi::ETypeName::Date32, "Type missmatch while setting skiff value");
@@ -272,7 +294,7 @@ protected:
         *reinterpret_cast<uint32_t*>(GetRawDataPtr(ind)) = value;
     }
     void SetUInt64(IndexType ind, uint64_t value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Uint64 || type == NTi::ETypeName::Timestamp ||
                  type == NTi::ETypeName::TzTimestamp || type == NTi::ETypeName::Timestamp64 ||
                  type == NTi::ETypeName::Datetime64, "Type missmatch while setting skiff value");
@@ -280,19 +302,19 @@ protected:
         *reinterpret_cast<uint64_t*>(GetRawDataPtr(ind)) = value;
     }
     void SetFloat(IndexType ind, float value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Float, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<float*>(GetRawDataPtr(ind)) = value;
     }
     void SetDouble(IndexType ind, double value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Double, "Type missmatch while setting skiff value");
 
         *reinterpret_cast<double*>(GetRawDataPtr(ind)) = value;
     }
     void SetString(IndexType ind, std::string_view value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
 
         if (type == NTi::ETypeName::Uuid) {
             Y_ENSURE(value.size() == 16, "Invalid UUID data size");
@@ -306,41 +328,41 @@ protected:
 
         auto serialization = SkiffSerializeString(value);
         *GetSkiffDataPtr(ind) = 
-            std::move(TSkiffData(GetChildType(ind)->StripTags(), {serialization.data(), serialization.size()}));
+            std::move(TSkiffData(GetChildLayout(ind), {serialization.data(), serialization.size()}));
     }
     void SetStruct(IndexType ind, IStructConstPtr value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Struct, "Type missmatch while setting skiff value");
 
         *std::dynamic_pointer_cast<TSkiffStruct>(GetSkiffDataPtr(ind)) = *std::dynamic_pointer_cast<const TSkiffStruct>(value);
     }
     void SetTuple(IndexType ind, ITupleConstPtr value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Tuple, "Type missmatch while setting skiff value");
 
         
         *std::dynamic_pointer_cast<TSkiffTuple>(GetSkiffDataPtr(ind)) = *std::dynamic_pointer_cast<const TSkiffTuple>(value);
     }
     void SetList(IndexType ind, IListConstPtr value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::List, "Type missmatch while setting skiff value");
 
         *std::dynamic_pointer_cast<TSkiffList>(GetSkiffDataPtr(ind)) = *std::dynamic_pointer_cast<const TSkiffList>(value);
     }
     void SetDict(IndexType ind, IDictConstPtr value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Dict, "Type missmatch while setting skiff value");
 
         *std::dynamic_pointer_cast<TSkiffDict>(GetSkiffDataPtr(ind)) = *std::dynamic_pointer_cast<const TSkiffDict>(value);
     }
     void SetVariant(IndexType ind, IVariantConstPtr value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Variant, "Type missmatch while setting skiff value");
 
         *std::dynamic_pointer_cast<TSkiffVariant>(GetSkiffDataPtr(ind)) = *std::dynamic_pointer_cast<const TSkiffVariant>(value);
     }
     void SetOptional(IndexType ind, IOptionalConstPtr value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Optional, "Type missmatch while setting skiff value");
 
         *std::dynamic_pointer_cast<TSkiffOptional>(GetSkiffDataPtr(ind)) = *std::dynamic_pointer_cast<const TSkiffOptional>(value);
@@ -351,37 +373,37 @@ protected:
         SetString(ind, std::string_view(value));
     }
     void SetStruct(IndexType ind, IStructPtr&& value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Struct, "Type missmatch while setting skiff value");
 
         GetSkiffDataPtr(ind) = std::dynamic_pointer_cast<TSkiffData>(value);
     }
     void SetTuple(IndexType ind, ITuplePtr&& value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Tuple, "Type missmatch while setting skiff value");
 
         GetSkiffDataPtr(ind) = std::dynamic_pointer_cast<TSkiffData>(value);
     }
     void SetList(IndexType ind, IListPtr&& value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::List, "Type missmatch while setting skiff value");
 
         GetSkiffDataPtr(ind) = std::dynamic_pointer_cast<TSkiffData>(value);
     }
     void SetDict(IndexType ind, IDictPtr&& value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Dict, "Type missmatch while setting skiff value");
 
         GetSkiffDataPtr(ind) = std::dynamic_pointer_cast<TSkiffData>(value);
     }
     void SetVariant(IndexType ind, IVariantPtr&& value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Variant, "Type missmatch while setting skiff value");
 
         GetSkiffDataPtr(ind) = std::dynamic_pointer_cast<TSkiffData>(value);
     }
     void SetOptional(IndexType ind, IOptionalPtr&& value) override {
-        auto type = GetChildType(ind)->StripTags()->GetTypeName();
+        auto type = GetChildTypeName(ind);
         Y_ENSURE(type == NTi::ETypeName::Optional, "Type missmatch while setting skiff value");
 
         GetSkiffDataPtr(ind) = std::dynamic_pointer_cast<TSkiffData>(value);
@@ -394,13 +416,19 @@ protected:
     virtual TSkiffDataConstPtr GetSkiffDataPtr(IndexType) const = 0;
     virtual TSkiffDataPtr& GetSkiffDataPtr(IndexType) = 0;
 
-    virtual NTi::TTypePtr GetChildType(IndexType) const = 0;
+    virtual const TSkiffLayoutPtr& GetChildLayout(IndexType) const = 0;
+
+    inline NTi::ETypeName GetChildTypeName(IndexType ind) const {
+        return GetChildLayout(ind)->TypeName();
+    }
 };
 
 class TSkiffVariant : public TSkiffData, virtual public ISkiffIndexed<size_t>, virtual public IBaseVariant {
 public:
     TSkiffVariant(NTi::TTypePtr schema);
     TSkiffVariant(NTi::TTypePtr schema, TBuffer&& buf);
+    TSkiffVariant(TSkiffLayoutPtr layout);
+    TSkiffVariant(TSkiffLayoutPtr layout, TBuffer&& buf);
     TSkiffVariant(const TSkiffVariant& rhs);
     TSkiffVariant(TSkiffVariant&& rhs);
 
@@ -420,13 +448,14 @@ public:
     void EmplaceVariant(size_t number) override;
 
     bool NeedRebuild() const override;
+    void AppendSegments(TSkiffSegments& segments) const override;
 
 protected:
     const char* GetRawDataPtr(size_t ind) const override;
     char* GetRawDataPtr(size_t ind) override;
     TSkiffDataConstPtr GetSkiffDataPtr(size_t ind) const override;
     TSkiffDataPtr& GetSkiffDataPtr(size_t ind) override;
-    NTi::TTypePtr GetChildType(size_t ind) const override;
+    const TSkiffLayoutPtr& GetChildLayout(size_t ind) const override;
 
     TBuffer SerializeImpl() const override;
     void SoftRebuild() override;
@@ -450,6 +479,8 @@ class TSkiffOptional : public TSkiffVariant, virtual public ISkiffIndexed<bool>,
 public:
     TSkiffOptional(NTi::TTypePtr schema);
     TSkiffOptional(NTi::TTypePtr schema, TBuffer&& buf);
+    TSkiffOptional(TSkiffLayoutPtr layout);
+    TSkiffOptional(TSkiffLayoutPtr layout, TBuffer&& buf);
     TSkiffOptional(const TSkiffOptional& rhs);
     TSkiffOptional(TSkiffOptional&& rhs);
 
@@ -471,13 +502,13 @@ public:
 protected:
     using TSkiffVariant::GetRawDataPtr;
     using TSkiffVariant::GetSkiffDataPtr;
-    NTi::TTypePtr GetChildType(size_t ind) const override;
+    using TSkiffVariant::GetChildLayout;
 
     const char* GetRawDataPtr(bool) const override;
     char* GetRawDataPtr(bool) override;
     TSkiffDataConstPtr GetSkiffDataPtr(bool) const override;
     TSkiffDataPtr& GetSkiffDataPtr(bool) override;
-    NTi::TTypePtr GetChildType(bool) const override;
+    const TSkiffLayoutPtr& GetChildLayout(bool) const override;
 };
 
 class TSkiffList : public TSkiffData, virtual public ISkiffIndexed<size_t>, virtual public IBaseList {
@@ -485,6 +516,9 @@ public:
     TSkiffList(NTi::TTypePtr schema);
     TSkiffList(NTi::TTypePtr schema, TBuffer&& buf);
     TSkiffList(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> elementsOffsets);
+    TSkiffList(TSkiffLayoutPtr layout);
+    TSkiffList(TSkiffLayoutPtr layout, TBuffer&& buf);
+    TSkiffList(TSkiffLayoutPtr layout, TBuffer&& buf, std::vector<ptrdiff_t> elementsOffsets);
     TSkiffList(const TSkiffList& rhs);
     TSkiffList(TSkiffList&& rhs);
 
@@ -500,18 +534,21 @@ public:
     void Extend() override;
 
     bool NeedRebuild() const override;
+    void AppendSegments(TSkiffSegments& segments) const override;
 
 protected:
     const char* GetRawDataPtr(size_t ind) const override;
     char* GetRawDataPtr(size_t ind) override;
     TSkiffDataConstPtr GetSkiffDataPtr(size_t ind) const override;
     TSkiffDataPtr& GetSkiffDataPtr(size_t ind) override;
-    NTi::TTypePtr GetChildType(size_t ind) const override;
+    const TSkiffLayoutPtr& GetChildLayout(size_t ind) const override;
 
     TBuffer SerializeImpl() const override;
     void SoftRebuild() override;
     void HardRebuild() override;
 
+    void CalculateElementsOffsets();
+
     inline std::vector<TSkiffDataPtr>& ObjectiveValues() const {
         return ObjectiveValues_;
     }
@@ -534,6 +571,11 @@ public:
     TSkiffTuple(NTi::TTypePtr schema);
     TSkiffTuple(NTi::TTypePtr schema, TBuffer&& buf);
     TSkiffTuple(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffTuple(NTi::TTypePtr schema, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffTuple(TSkiffLayoutPtr layout);
+    TSkiffTuple(TSkiffLayoutPtr layout, TBuffer&& buf);
+    TSkiffTuple(TSkiffLayoutPtr layout, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffTuple(TSkiffLayoutPtr layout, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets);
 
     TSkiffTuple(const TSkiffTuple& rhs);
     TSkiffTuple(TSkiffTuple&& rhs);
@@ -546,12 +588,38 @@ public:
 
     bool NeedRebuild() const override;
 
+    // Borrowed object reads memory owned by someone else (e.g. input block of TSkiffRowReader).
+    // The data is copied into object's own buffer on the first modification or by Detach()
+    inline bool IsBorrowed() const {
+        return Borrowed_.data() != nullptr;
+    }
+    void Detach();
+
+    // Replaces object's data with a copy of the given serialization reusing already allocated memory
+    void Assign(std::string_view data, const std::vector<ptrdiff_t>& fieldsOffsets);
+
+    std::string_view SerializedView() override;
+    void AppendSegments(TSkiffSegments& segments) const override;
+
+    // Data of the field without type checks and virtual calls. For callers which validated
+    // the type of the field beforehand, e.g. TTypedRow
+    inline const char* FieldData(size_t ind) const {
+        return ObjectiveValues_[ind] ? TSkiffData::GetBuffer(*ObjectiveValues_[ind]).Data()
+                                     : DataBegin() + FieldsDataOffsets_[ind];
+    }
+    inline char* MutableFieldData(size_t ind) {
+        Detach();
+
+        return ObjectiveValues_[ind] ? TSkiffData::GetBuffer(*ObjectiveValues_[ind]).Data()
+                                     : Buffer().Data() + FieldsDataOffsets_[ind];
+    }
+
 protected:
     const char* GetRawDataPtr(size_t ind) const override;
     char* GetRawDataPtr(size_t ind) override;
     TSkiffDataConstPtr GetSkiffDataPtr(size_t ind) const override;
     TSkiffDataPtr& GetSkiffDataPtr(size_t ind) override;
-    NTi::TTypePtr GetChildType(size_t ind) const override;
+    const TSkiffLayoutPtr& GetChildLayout(size_t ind) const override;
 
     TBuffer SerializeImpl() const override;
     void SoftRebuild() override;
@@ -569,9 +637,20 @@ protected:
         return FieldsDataOffsets_;
     }
 
+    inline const char* DataBegin() const {
+        return IsBorrowed() ? Borrowed_.data() : Buffer().Data();
+    }
+    inline size_t DataSize() const {
+        return IsBorrowed() ? Borrowed_.size() : Buffer().Size();
+    }
+    inline size_t FieldDataSize(size_t ind) const {
+        return (ind < FieldsCount() - 1 ? FieldsDataOffsets_[ind + 1] : DataSize()) - FieldsDataOffsets_[ind];
+    }
+
 private:
     std::vector<ptrdiff_t> FieldsDataOffsets_;
     mutable std::vector<TSkiffDataPtr> ObjectiveValues_;
+    std::string_view Borrowed_;
 
 public:
     inline void print_offsets() const {
@@ -594,6 +673,11 @@ public:
     TSkiffStruct(NTi::TTypePtr schema);
     TSkiffStruct(NTi::TTypePtr schema, TBuffer&& buf);
     TSkiffStruct(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffStruct(NTi::TTypePtr schema, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffStruct(TSkiffLayoutPtr layout);
+    TSkiffStruct(TSkiffLayoutPtr layout, TBuffer&& buf);
+    TSkiffStruct(TSkiffLayoutPtr layout, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffStruct(TSkiffLayoutPtr layout, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets);
 
     TSkiffStruct(const TSkiffStruct& rhs);
     TSkiffStruct(TSkiffStruct&& rhs);
@@ -605,7 +689,7 @@ public:
 
     std::vector<std::string> FieldsNames() const override;
 
-    using TIndexesMap = std::unordered_map<std::string_view, size_t>;
+    using TIndexesMap = TSkiffLayout::TIndexesMap;
 
     using TSkiffTuple::GetValue;
     using IBaseStruct::GetValue;
@@ -615,22 +699,17 @@ public:
 protected:
     using TSkiffTuple::GetRawDataPtr;
     using TSkiffTuple::GetSkiffDataPtr;
-
-    NTi::TTypePtr GetChildType(size_t ind) const override;
+    using TSkiffTuple::GetChildLayout;
 
     const char* GetRawDataPtr(std::string_view ind) const override;
     char* GetRawDataPtr(std::string_view ind) override;
     TSkiffDataConstPtr GetSkiffDataPtr(std::string_view ind) const override;
     TSkiffDataPtr& GetSkiffDataPtr(std::string_view ind) override;
-    NTi::TTypePtr GetChildType(std::string_view ind) const override;
+    const TSkiffLayoutPtr& GetChildLayout(std::string_view ind) const override;
 
     inline const TIndexesMap& IndexesMap() const {
-        return IndexesMap_;
+        return Layout()->IndexesMap();
     }
-
-    static TIndexesMap BuildIndexesMap(NTi::TStructTypePtr type);
-private:
-    TIndexesMap IndexesMap_;
 };
 
 class TSkiffDict : virtual public TSkiffList, virtual public IBaseDict {
@@ -646,9 +725,6 @@ public:
 
     IDictPtr CopyDict() const override;
 
-protected:
-    NTi::TTypePtr GetChildType(size_t) const override;
-
 private:
     inline IListPtr CopyList() const override {
         return TSkiffList::CopyList();
@@ -660,6 +736,11 @@ public:
     TSkiffRow(NTi::TTypePtr schema);
     TSkiffRow(NTi::TTypePtr schema, TBuffer&& buf);
     TSkiffRow(NTi::TTypePtr schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffRow(NTi::TTypePtr schema, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffRow(TSkiffLayoutPtr layout);
+    TSkiffRow(TSkiffLayoutPtr layout, TBuffer&& buf);
+    TSkiffRow(TSkiffLayoutPtr layout, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets);
+    TSkiffRow(TSkiffLayoutPtr layout, std::string_view borrowed, std::vector<ptrdiff_t> fieldsOffsets);
     TSkiffRow(const NYT::TTableSchema& schema);
     TSkiffRow(const NYT::TTableSchema& schema, TBuffer&& buf);
     TSkiffRow(const NYT::TTableSchema& schema, TBuffer&& buf, std::vector<ptrdiff_t> fieldsOffsets);
@@ -675,11 +756,6 @@ public:
     using IBaseRow::GetValue;
     using IBaseRow::SetValue;
 
-protected:
-    using TSkiffStruct::GetChildType;
-
-    NTi::TTypePtr GetChildType(size_t ind) const override;
-
 private:
     inline ITuplePtr CopyTuple() const override {
         return TSkiffTuple::CopyTuple();
@@ -1,30 +1,63 @@
 #include "skiff_writer.h"
 
+#include <dformats/common/util.h>
+
 namespace DFormats {
 
 TSkiffRowWriter::TSkiffRowWriter(THolder<IProxyOutput> output, std::vector<NYT::TTableSchema> schemas)
-  : Underlying_(std::move(output)), TableSchemas_(std::move(schemas)) { }
+  : Underlying_(std::move(output)), TableSchemas_(std::move(schemas)), RowPools_(TableSchemas_.size()) {
+
+    RowLayouts_.reserve(TableSchemas_.size());
+    for (const auto& tableSchema : TableSchemas_) {
+        RowLayouts_.push_back(MakeSkiffLayout(TableSchemaToStructType(tableSchema)));
+    }
+}
 
 void TSkiffRowWriter::WriteRow(const IRowConstPtr& row, size_t tableIndex) {
-    auto* stream = Underlying_->GetStream(tableIndex);
-    auto serialization = std::dynamic_pointer_cast<const TSkiffRow>(row)->Serialize();
+    WriteSegments(dynamic_cast<const TSkiffRow&>(*row), tableIndex);
+}
 
-    stream->Write(&tableIndex, 2);
-    stream->Write(serialization.Data(), serialization.Size());
+void TSkiffRowWriter::WriteRow(IRowPtr&& row, size_t tableIndex) {
+    // Row isn't rebuilt: it's either reused and reassigned or dropped after writing
+    WriteSegments(dynamic_cast<const TSkiffRow&>(*row), tableIndex);
+
+    RecycleRow(std::move(row), tableIndex);
+}
+
+void TSkiffRowWriter::WriteSegments(const TSkiffData& row, size_t tableIndex) {
+    Segments_.clear();
+    Segments_.emplace_back(&tableIndex, 2);
+    row.AppendSegments(Segments_);
 
+    Underlying_->GetStream(tableIndex)->Write(Segments_.data(), Segments_.size());
     Underlying_->OnRowFinished(tableIndex);
 }
 
-void TSkiffRowWriter::WriteRow(IRowPtr&& row, size_t tableIndex) {
+void TSkiffRowWriter::WriteRawRow(std::string_view data, size_t tableIndex) {
     auto* stream = Underlying_->GetStream(tableIndex);
-    auto serialization = std::move(*std::dynamic_pointer_cast<TSkiffRow>(row)).Serialize();
 
     stream->Write(&tableIndex, 2);
-    stream->Write(serialization.Data(), serialization.Size());
+    stream->Write(data.data(), data.size());
 
     Underlying_->OnRowFinished(tableIndex);
 }
 
+void TSkiffRowWriter::RecycleRow(IRowPtr&& row, size_t tableIndex) {
+    // Only rows created by CreateObjectForWrite and not referenced by anyone else can be reused
+    if (row.use_count() != 1) {
+        return;
+    }
+
+    auto& skiffRow = dynamic_cast<TSkiffRow&>(*row);
+    const auto& layout = RowLayouts_[tableIndex];
+    if (skiffRow.Layout() != layout) {
+        return;
+    }
+
+    skiffRow.Assign({layout->DefaultData().Data(), layout->DefaultData().Size()}, layout->DefaultOffsets());
+    RowPools_[tableIndex].Release(std::move(row));
+}
+
 void TSkiffRowWriter::FinishTable(size_t tableIndex) {
     Underlying_->GetStream(tableIndex)->Finish();
 }
@@ -42,7 +75,11 @@ const NYT::TTableSchema& TSkiffRowWriter::GetTableSchema(size_t tableIndex) cons
 }
 
 IRowPtr TSkiffRowWriter::CreateObjectForWrite(size_t tableIndex) const {
-    return std::make_shared<TSkiffRow>(GetTableSchema(tableIndex));
+    if (auto row = RowPools_[tableIndex].Acquire()) {
+        return row;
+    }
+
+    return std::make_shared<TSkiffRow>(RowLayouts_[tableIndex]);
 }
 
 }
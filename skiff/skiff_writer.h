@@ -6,6 +6,7 @@
 #include "skiff_schema.h"
 #include "skiff_types.h"
 #include <dformats/interface/io.h>
+#include <dformats/common/row_pool.h>
 
 using namespace NYT;
 
@@ -19,14 +20,26 @@ public:
     void WriteRow(IRowPtr&& row, size_t tableIndex) override;
     void FinishTable(size_t tableIndex) override;
 
+    // Writes serialized row of the table as is, e.g. TSkiffRawRow::Data()
+    void WriteRawRow(std::string_view data, size_t tableIndex) override;
+
     enum Format Format() const override;
     size_t GetTablesCount() const override;
     const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
     IRowPtr CreateObjectForWrite(size_t tableIndex) const override;
 
+private:
+    void WriteSegments(const TSkiffData& row, size_t tableIndex);
+    void RecycleRow(IRowPtr&& row, size_t tableIndex);
+
 private:
     THolder<IProxyOutput> Underlying_;
     std::vector<NYT::TTableSchema> TableSchemas_;
+    std::vector<TSkiffLayoutPtr> RowLayouts_;
+    mutable std::vector<TRowPool> RowPools_;
+
+    // Segments of the row being written, kept to reuse memory
+    TSkiffSegments Segments_;
 };
 
 }
@@ -0,0 +1,51 @@
+#include "test_util.h"
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <dformats/arrow/arrow_reader.h>
+#include <dformats/yson/yson_reader.h>
+
+using namespace DFormats;
+
+namespace {
+
+std::vector<NYT::TNode> ReadYson(const NYT::TTableSchema& schema, size_t rowsCount) {
+    TYsonRowReader reader(MakeInput(GenerateData(Format::Yson, schema, rowsCount)), {schema});
+    return ReadNodes(reader);
+}
+
+}
+
+Y_UNIT_TEST_SUITE(ArrowReader) {
+    // Rows span several record batches of the generated stream
+    Y_UNIT_TEST(GeneratedScalarRowsMatchYson) {
+        const auto schema = MakeScalarSchema();
+
+        TArrowRowReader reader(MakeInput(GenerateData(Format::Arrow, schema, 300)), {schema});
+        AssertRowsEqual(ReadNodes(reader), ReadYson(schema, 300));
+    }
+
+    Y_UNIT_TEST(GeneratedComplexRowsMatchYson) {
+        const auto schema = MakeComplexSchema();
+
+        TArrowRowReader reader(MakeInput(GenerateData(Format::Arrow, schema, 300)), {schema});
+        AssertRowsEqual(ReadNodes(reader), ReadYson(schema, 300));
+    }
+
+    Y_UNIT_TEST(ReadRowsMatchesReadRow) {
+        const auto schema = MakeScalarSchema();
+        const auto data = GenerateData(Format::Arrow, schema, 300);
+
+        TArrowRowReader reader(MakeInput(data), {schema});
+
+        std::vector<NYT::TNode> actual;
+        std::vector<IRowPtr> rows;
+        while (reader.ReadRows(rows, 50, nullptr) > 0) {
+            for (const auto& row : rows) {
+                actual.push_back(RowToNode(*row, schema));
+            }
+        }
+
+        AssertRowsEqual(actual, ReadYson(schema, 300));
+    }
+}
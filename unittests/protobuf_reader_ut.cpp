@@ -0,0 +1,255 @@
+#include "test_util.h"
+
+#include <limits>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <dformats/protobuf/protobuf_reader.h>
+#include <dformats/protobuf/protobuf_lazy_reader.h>
+#include <dformats/yson/yson_reader.h>
+
+using namespace DFormats;
+
+namespace {
+
+// Message encoded by hand. Signed ints are sign-extended to 64 bits as Protobuf does for int32 fields
+class TProtoBuilder {
+public:
+    TProtoBuilder& Int(ui32 field, i64 value) {
+        return Varint(field, static_cast<ui64>(value));
+    }
+
+    TProtoBuilder& Varint(ui32 field, ui64 value) {
+        PutVarint(field << 3);
+        PutVarint(value);
+        return *this;
+    }
+
+    TProtoBuilder& Double(ui32 field, double value) {
+        PutVarint(field << 3 | 1);
+        Data_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    TProtoBuilder& Bytes(ui32 field, TStringBuf value) {
+        PutVarint(field << 3 | 2);
+        PutVarint(value.size());
+        Data_.append(value);
+        return *this;
+    }
+
+    TProtoBuilder& Message(ui32 field, const TProtoBuilder& value) {
+        return Bytes(field, value.Data());
+    }
+
+    TProtoBuilder& Raw(TStringBuf data) {
+        Data_.append(data);
+        return *this;
+    }
+
+    const TString& Data() const {
+        return Data_;
+    }
+
+private:
+    void PutVarint(ui64 value) {
+        while (value >= 0x80) {
+            Data_.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        Data_.push_back(static_cast<char>(value));
+    }
+
+private:
+    TString Data_;
+};
+
+TString Lenval(const std::vector<TProtoBuilder>& messages) {
+    TString res;
+    for (const auto& message : messages) {
+        const ui32 length = message.Data().size();
+        res.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        res.append(message.Data());
+    }
+
+    return res;
+}
+
+NYT::TTableSchema MakeProtobufSchema() {
+    auto schema = MakeScalarSchema();
+    for (const auto& column : MakeComplexSchema().Columns()) {
+        schema.AddColumn(column);
+    }
+
+    return schema;
+}
+
+std::shared_ptr<TProtobufRowFactory> MakeFactory(const NYT::TTableSchema& schema) {
+    return std::make_shared<TProtobufRowFactory>(std::vector<NYT::TTableSchema>{schema});
+}
+
+std::vector<NYT::TNode> ReadEager(TString data, const NYT::TTableSchema& schema, TProtobufReaderOptions options = {}) {
+    TProtobufRowReader reader(MakeInput(std::move(data)), MakeFactory(schema), std::vector<size_t>{0}, options);
+    return ReadNodes(reader);
+}
+
+std::vector<NYT::TNode> ReadLazy(TString data, const NYT::TTableSchema& schema, size_t blockSize = 1 << 20) {
+    TProtobufLazyRowReader reader(MakeInput(std::move(data)), MakeFactory(schema), std::vector<size_t>{0}, blockSize);
+    return ReadNodes(reader);
+}
+
+std::vector<TProtobufReaderOptions> ReaderOptionsToTest() {
+    TProtobufReaderOptions arena;
+    arena.UseArena = true;
+    arena.ArenaRowsLimit = 8;
+
+    TProtobufReaderOptions reuse;
+    reuse.ReuseRows = true;
+
+    return {TProtobufReaderOptions(), arena, reuse};
+}
+
+// Every reader gives the expected rows, the lazy one with blocks smaller than rows too
+void AssertAllReadersEqual(const TString& data, const NYT::TTableSchema& schema,
+                           const std::vector<NYT::TNode>& expected) {
+    for (const auto& options : ReaderOptionsToTest()) {
+        AssertRowsEqual(ReadEager(data, schema, options), expected);
+    }
+
+    AssertRowsEqual(ReadLazy(data, schema), expected);
+    AssertRowsEqual(ReadLazy(data, schema, 16), expected);
+}
+
+}
+
+Y_UNIT_TEST_SUITE(ProtobufReader) {
+    Y_UNIT_TEST(GeneratedRowsMatchYson) {
+        const auto schema = MakeProtobufSchema();
+
+        TYsonRowReader ysonReader(MakeInput(GenerateData(Format::Yson, schema, 300)), {schema});
+        const auto expected = ReadNodes(ysonReader);
+        UNIT_ASSERT_VALUES_EQUAL(expected.size(), 300);
+
+        AssertAllReadersEqual(GenerateData(Format::Protobuf, schema, 300), schema, expected);
+    }
+
+    Y_UNIT_TEST(NegativeVarints) {
+        const auto schema = MakeSchema({
+            {"int8", NTi::Int8()}, {"int16", NTi::Int16()}, {"int32", NTi::Int32()}, {"int64", NTi::Int64()},
+            {"optional", NTi::Optional(NTi::Int32())}, {"list", NTi::List(NTi::Int32())}});
+
+        const i64 minInt16 = std::numeric_limits<i16>::min();
+        const i64 minInt32 = std::numeric_limits<i32>::min();
+        const i64 maxInt32 = std::numeric_limits<i32>::max();
+        const i64 minInt64 = std::numeric_limits<i64>::min();
+
+        const auto data = Lenval({
+            TProtoBuilder()
+                .Int(1, -128).Int(2, -1).Int(3, minInt32).Int(4, minInt64)
+                .Int(5, -2).Int(6, -1).Int(6, 0).Int(6, maxInt32).Int(6, minInt32),
+            TProtoBuilder()
+                .Int(1, 127).Int(2, minInt16).Int(3, -1).Int(4, -1)});
+
+        const std::vector<NYT::TNode> expected = {
+            NYT::TNode()("int8", -128)("int16", -1)("int32", minInt32)("int64", minInt64)("optional", -2)
+                ("list", NYT::TNode::CreateList().Add(-1).Add(0).Add(maxInt32).Add(minInt32)),
+            NYT::TNode()("int8", 127)("int16", minInt16)("int32", -1)("int64", -1)
+                ("optional", NYT::TNode::CreateEntity())("list", NYT::TNode::CreateList())};
+
+        AssertAllReadersEqual(data, schema, expected);
+    }
+
+    Y_UNIT_TEST(SplitSubMessages) {
+        const auto schema = MakeSchema({
+            {"struct", NTi::Struct({{"foo", NTi::Int32()}, {"bar", NTi::String()}, {"items", NTi::List(NTi::Int64())}})},
+            {"optional", NTi::Optional(NTi::Struct({{"x", NTi::Double()}, {"y", NTi::Optional(NTi::Int64())}}))},
+            {"id", NTi::Int64()}});
+
+        // Occurrences of a message field are merged: scalars are taken from the last one, repeated fields are joined
+        const auto data = Lenval({
+            TProtoBuilder()
+                .Message(1, TProtoBuilder().Int(1, 1).Int(3, 10))
+                .Message(2, TProtoBuilder().Double(1, 0.5))
+                .Int(3, 5)
+                .Message(1, TProtoBuilder().Bytes(2, "bar").Int(3, 11).Int(1, -2))
+                .Message(2, TProtoBuilder().Int(2, -7)),
+            TProtoBuilder()
+                .Message(1, TProtoBuilder().Int(1, 3).Bytes(2, "first"))
+                .Message(1, TProtoBuilder().Bytes(2, "second"))
+                .Int(3, 6)});
+
+        const auto expected = ParseNodes(
+            "{struct={foo=-2;bar=\"bar\";items=[10;11]};optional={x=0.5;y=-7};id=5};"
+            "{struct={foo=3;bar=\"second\";items=[]};optional=#;id=6}");
+
+        AssertAllReadersEqual(data, schema, expected);
+    }
+
+    Y_UNIT_TEST(NestedVariantsAndRepeatedFields) {
+        auto inner = NTi::Variant(NTi::Struct({{"x", NTi::String()}, {"y", NTi::Double()}}));
+        const auto schema = MakeSchema({
+            {"variant", NTi::Variant(NTi::Struct({
+                {"a", NTi::Int32()},
+                {"b", NTi::Struct({{"items", NTi::List(NTi::Int64())}, {"inner", inner}})}}))},
+            {"list", NTi::List(NTi::Struct({{"id", NTi::Uint32()}, {"tags", NTi::List(NTi::String())}}))},
+            {"dict", NTi::Dict(NTi::String(), NTi::Int32())}});
+
+        // Items of repeated fields are interleaved with other fields
+        const auto data = Lenval({
+            TProtoBuilder()
+                .Message(2, TProtoBuilder().Varint(1, 7).Bytes(2, "a").Bytes(2, ""))
+                .Message(3, TProtoBuilder().Bytes(1, "k").Int(2, -1))
+                .Message(1, TProtoBuilder().Int(1, -3))
+                .Message(2, TProtoBuilder().Varint(1, 8))
+                .Message(3, TProtoBuilder().Bytes(1, "l").Int(2, 2)),
+            TProtoBuilder()
+                .Message(1, TProtoBuilder().Message(2, TProtoBuilder()
+                    .Int(1, 1)
+                    .Message(2, TProtoBuilder().Double(2, 2.5))
+                    .Int(1, -2)))});
+
+        const auto expected = ParseNodes(
+            "{variant=[0u;-3];list=[{id=7u;tags=[\"a\";\"\"]};{id=8u;tags=[]}];dict=[[\"k\";-1];[\"l\";2]]};"
+            "{variant=[1u;{items=[1;-2];inner=[1u;2.5]}];list=[];dict=[]}");
+
+        AssertAllReadersEqual(data, schema, expected);
+    }
+
+    Y_UNIT_TEST(TruncatedInput) {
+        const auto schema = MakeProtobufSchema();
+
+        // Rows of the same spec don't depend on the rows count, so the last row starts where the shorter data ends
+        const auto full = GenerateData(Format::Protobuf, schema, 11);
+        const size_t lastRow = GenerateData(Format::Protobuf, schema, 10).size();
+        UNIT_ASSERT(lastRow + sizeof(ui32) < full.size());
+
+        for (size_t size : {lastRow + 2, lastRow + sizeof(ui32), lastRow + sizeof(ui32) + 1, full.size() - 1}) {
+            const auto data = full.substr(0, size);
+
+            for (const auto& options : ReaderOptionsToTest()) {
+                UNIT_ASSERT_EXCEPTION(ReadEager(data, schema, options), yexception);
+            }
+            UNIT_ASSERT_EXCEPTION(ReadLazy(data, schema), yexception);
+            UNIT_ASSERT_EXCEPTION(ReadLazy(data, schema, 16), yexception);
+        }
+    }
+
+    Y_UNIT_TEST(TruncatedMessage) {
+        const auto schema = MakeSchema({{"int32", NTi::Int32()}, {"string", NTi::String()}});
+
+        // Framing is intact, but the message ends inside a value
+        const std::vector<TString> messages = {
+            TProtoBuilder().Bytes(2, "s").Raw("\x08\xFF").Data(),
+            TProtoBuilder().Int(1, -1).Raw("\x12\x05" "ab").Data(),
+            TProtoBuilder().Bytes(2, "s").Raw("\x08" "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x01").Data()};
+
+        for (const auto& message : messages) {
+            const auto data = Lenval({TProtoBuilder().Raw(message)});
+
+            for (const auto& options : ReaderOptionsToTest()) {
+                UNIT_ASSERT_EXCEPTION(ReadEager(data, schema, options), yexception);
+            }
+            UNIT_ASSERT_EXCEPTION(ReadLazy(data, schema), yexception);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#include "test_util.h"
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <dformats/skiff/skiff_reader.h>
+#include <dformats/yson/yson_reader.h>
+
+using namespace DFormats;
+
+namespace {
+
+// Rows encoded by hand. Rows have no row index, like the generator's ones
+class TSkiffBuilder {
+public:
+    TSkiffBuilder& Row() {
+        return Put<ui16>(0).Put<ui8>(0);
+    }
+
+    template <typename T>
+    TSkiffBuilder& Put(T value) {
+        Data_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        return *this;
+    }
+
+    TSkiffBuilder& String(TStringBuf value) {
+        Put<ui32>(value.size());
+        Data_.append(value);
+        return *this;
+    }
+
+    TSkiffBuilder& Item() {
+        return Put<ui8>(0);
+    }
+
+    TSkiffBuilder& EndList() {
+        return Put<ui8>(0xFF);
+    }
+
+    const TString& Data() const {
+        return Data_;
+    }
+
+private:
+    TString Data_;
+};
+
+// Columns of both shared schemas and nested types Protobuf doesn't support
+NYT::TTableSchema MakeSkiffSchema() {
+    auto schema = MakeComplexSchema();
+    for (const auto& column : MakeScalarSchema().Columns()) {
+        schema.AddColumn(column);
+    }
+
+    return schema
+        .AddColumn(NYT::TColumnSchema().Name("tuple").TypeV3(NTi::Tuple({{NTi::Int16()}, {NTi::Optional(NTi::Utf8())}})))
+        .AddColumn(NYT::TColumnSchema().Name("nested_lists").TypeV3(NTi::List(NTi::List(NTi::Int64()))))
+        .AddColumn(NYT::TColumnSchema().Name("dict_of_lists").TypeV3(NTi::Dict(NTi::String(), NTi::List(NTi::Bool()))));
+}
+
+NYT::TTableSchema MakeVariantSchema() {
+    auto item = NTi::Variant(NTi::Tuple({{NTi::String()}, {NTi::Int64()}}));
+    auto nested = NTi::Struct({{"items", NTi::List(item)}, {"flag", NTi::Bool()}});
+
+    return MakeSchema({
+        {"v", NTi::Variant(NTi::Struct({{"a", NTi::Int32()}, {"b", nested}}))},
+        {"lists", NTi::List(NTi::List(NTi::Int64()))},
+        {"o", NTi::Optional(NTi::Variant(NTi::Tuple({{NTi::Double()}, {NTi::String()}})))}});
+}
+
+std::vector<NYT::TNode> ReadSkiff(TString data, const NYT::TTableSchema& schema, TSkiffReaderOptions options = {}) {
+    TSkiffRowReader reader(MakeInput(std::move(data)), {schema}, static_cast<ReadingOptions>(0), options);
+    return ReadNodes(reader);
+}
+
+std::vector<NYT::TNode> ReadYson(TString data, const NYT::TTableSchema& schema) {
+    TYsonRowReader reader(MakeInput(std::move(data)), {schema});
+    return ReadNodes(reader);
+}
+
+std::vector<TSkiffReaderOptions> ReaderOptionsToTest() {
+    TSkiffReaderOptions unbuffered;
+    unbuffered.BlockSize = 0;
+
+    // Rows span several blocks
+    TSkiffReaderOptions smallBlocks;
+    smallBlocks.BlockSize = 64;
+
+    TSkiffReaderOptions borrowing;
+    borrowing.BorrowRows = true;
+
+    return {unbuffered, smallBlocks, TSkiffReaderOptions(), borrowing};
+}
+
+}
+
+Y_UNIT_TEST_SUITE(SkiffReader) {
+    Y_UNIT_TEST(GeneratedRowsMatchYson) {
+        const auto schema = MakeSkiffSchema();
+        const auto expected = ReadYson(GenerateData(Format::Yson, schema, 300), schema);
+        UNIT_ASSERT_VALUES_EQUAL(expected.size(), 300);
+
+        const auto data = GenerateData(Format::Skiff, schema, 300);
+        for (const auto& options : ReaderOptionsToTest()) {
+            AssertRowsEqual(ReadSkiff(data, schema, options), expected);
+        }
+    }
+
+    Y_UNIT_TEST(ReadRowsMatchesReadRow) {
+        const auto schema = MakeSkiffSchema();
+        const auto data = GenerateData(Format::Skiff, schema, 100);
+
+        for (const auto& options : ReaderOptionsToTest()) {
+            TSkiffRowReader reader(MakeInput(data), {schema}, static_cast<ReadingOptions>(0), options);
+
+            std::vector<NYT::TNode> actual;
+            std::vector<IRowPtr> rows;
+            while (reader.ReadRows(rows, 7, nullptr) > 0) {
+                for (const auto& row : rows) {
+                    actual.push_back(RowToNode(*row, schema));
+                }
+            }
+
+            AssertRowsEqual(actual, ReadSkiff(data, schema, options));
+        }
+    }
+
+    Y_UNIT_TEST(NestedVariants) {
+        const auto schema = MakeVariantSchema();
+
+        TSkiffBuilder skiff;
+        skiff.Row()
+            .Put<ui8>(0).Put<i32>(-7)
+            .Item().Item().Put<i64>(1).Item().Put<i64>(2).EndList()
+                .Item().EndList()
+                .Item().Item().Put<i64>(3).EndList()
+                .EndList()
+            .Put<ui8>(0);
+        skiff.Row()
+            .Put<ui8>(1)
+                .Item().Put<ui8>(0).String("x").Item().Put<ui8>(1).Put<i64>(-5).EndList()
+                .Put<ui8>(1)
+            .EndList()
+            .Put<ui8>(1).Put<ui8>(1).String("s");
+        skiff.Row()
+            .Put<ui8>(1).EndList().Put<ui8>(0)
+            .Item().EndList().EndList()
+            .Put<ui8>(1).Put<ui8>(0).Put<double>(2.5);
+
+        const auto expected = ParseNodes(
+            "{v=[0u;-7];lists=[[1;2];[];[3]];o=#};"
+            "{v=[1u;{items=[[0u;\"x\"];[1u;-5]];flag=%true}];lists=[];o=[1u;\"s\"]};"
+            "{v=[1u;{items=[];flag=%false}];lists=[[]];o=[0u;2.5]}");
+
+        const auto yson = ReadYson(
+            "{v=[\"a\";-7];lists=[[1;2];[];[3]];o=#};"
+            "{v=[\"b\";{items=[[0u;\"x\"];[1u;-5]];flag=%true}];lists=[];o=[1u;\"s\"]};"
+            "{v=[\"b\";{items=[];flag=%false}];lists=[[]];o=[0u;2.5]};", schema);
+        AssertRowsEqual(yson, expected);
+
+        for (const auto& options : ReaderOptionsToTest()) {
+            AssertRowsEqual(ReadSkiff(skiff.Data(), schema, options), expected);
+        }
+    }
+
+    Y_UNIT_TEST(TruncatedInput) {
+        const auto schema = MakeSkiffSchema();
+
+        // Rows of the same spec don't depend on the rows count, so the last row starts where the shorter data ends
+        const auto full = GenerateData(Format::Skiff, schema, 11);
+        const size_t lastRow = GenerateData(Format::Skiff, schema, 10).size();
+        UNIT_ASSERT(lastRow < full.size());
+
+        for (size_t size : {lastRow + 1, lastRow + 3, lastRow + 4, full.size() - 1}) {
+            for (const auto& options : ReaderOptionsToTest()) {
+                UNIT_ASSERT_EXCEPTION(ReadSkiff(full.substr(0, size), schema, options), yexception);
+            }
+        }
+    }
+}
@@ -0,0 +1,225 @@
+#include "test_util.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/yson/node/node_io.h>
+
+#include <util/generic/yexception.h>
+#include <util/stream/str.h>
+
+#include <dformats/common/util.h>
+
+namespace DFormats {
+
+namespace {
+
+template <typename TIndex>
+NYT::TNode ValueToNode(const IBaseIndexed<TIndex>& object, TIndex ind, const NTi::TTypePtr& type);
+
+NYT::TNode StructToNode(const IBaseStruct& object, const NTi::TStructType* type) {
+    auto res = NYT::TNode::CreateMap();
+    for (const auto& member : type->GetMembers()) {
+        res[member.GetName()] = ValueToNode<std::string_view>(object, member.GetName(), member.GetType());
+    }
+
+    return res;
+}
+
+template <typename TIndex>
+NYT::TNode ValueToNode(const IBaseIndexed<TIndex>& object, TIndex ind, const NTi::TTypePtr& type) {
+    switch (type->GetTypeName()) {
+    case NTi::ETypeName::Bool:
+        return object.template GetValue<bool>(ind);
+    case NTi::ETypeName::Int8:
+        return static_cast<i64>(object.template GetValue<int8_t>(ind));
+    case NTi::ETypeName::Int16:
+        return static_cast<i64>(object.template GetValue<int16_t>(ind));
+    case NTi::ETypeName::Int32:
+        return static_cast<i64>(object.template GetValue<int32_t>(ind));
+    case NTi::ETypeName::Int64:
+        return static_cast<i64>(object.template GetValue<int64_t>(ind));
+    case NTi::ETypeName::Uint8:
+        return static_cast<ui64>(object.template GetValue<uint8_t>(ind));
+    case NTi::ETypeName::Uint16:
+        return static_cast<ui64>(object.template GetValue<uint16_t>(ind));
+    case NTi::ETypeName::Uint32:
+        return static_cast<ui64>(object.template GetValue<uint32_t>(ind));
+    case NTi::ETypeName::Uint64:
+        return static_cast<ui64>(object.template GetValue<uint64_t>(ind));
+    case NTi::ETypeName::Float:
+        return static_cast<double>(object.template GetValue<float>(ind));
+    case NTi::ETypeName::Double:
+        return object.template GetValue<double>(ind);
+    case NTi::ETypeName::String:
+    case NTi::ETypeName::Utf8:
+        return TString(object.template GetValue<std::string_view>(ind));
+
+    case NTi::ETypeName::Optional: {
+        auto optional = object.template GetValue<IOptionalConstPtr>(ind);
+        if (!optional->HasValue()) {
+            return NYT::TNode::CreateEntity();
+        }
+        return ValueToNode<bool>(*optional, true, type->AsOptional()->GetItemType());
+    }
+    case NTi::ETypeName::List: {
+        auto list = object.template GetValue<IListConstPtr>(ind);
+
+        auto res = NYT::TNode::CreateList();
+        for (size_t i = 0; i < list->Size(); ++i) {
+            res.Add(ValueToNode<size_t>(*list, i, type->AsList()->GetItemType()));
+        }
+        return res;
+    }
+    case NTi::ETypeName::Dict: {
+        auto dict = object.template GetValue<IDictConstPtr>(ind);
+
+        auto res = NYT::TNode::CreateList();
+        for (size_t i = 0; i < dict->Size(); ++i) {
+            auto entry = dict->GetValue<IStructConstPtr>(i);
+            res.Add(NYT::TNode::CreateList()
+                .Add(ValueToNode<std::string_view>(*entry, "key", type->AsDict()->GetKeyType()))
+                .Add(ValueToNode<std::string_view>(*entry, "value", type->AsDict()->GetValueType())));
+        }
+        return res;
+    }
+    case NTi::ETypeName::Struct:
+        return StructToNode(*object.template GetValue<IStructConstPtr>(ind), type->AsStruct());
+    case NTi::ETypeName::Tuple: {
+        auto tuple = object.template GetValue<ITupleConstPtr>(ind);
+
+        auto res = NYT::TNode::CreateList();
+        const auto& elements = type->AsTuple()->GetElements();
+        for (size_t i = 0; i < elements.size(); ++i) {
+            res.Add(ValueToNode<size_t>(*tuple, i, elements[i].GetType()));
+        }
+        return res;
+    }
+    case NTi::ETypeName::Variant: {
+        auto variant = object.template GetValue<IVariantConstPtr>(ind);
+        const size_t number = variant->VariantNumber();
+
+        auto underlying = type->AsVariant()->GetUnderlyingType();
+        auto alternative = underlying->IsTuple() ?
+            underlying->AsTuple()->GetElements()[number].GetType() :
+            underlying->AsStruct()->GetMembers()[number].GetType();
+
+        return NYT::TNode::CreateList()
+            .Add(static_cast<ui64>(number))
+            .Add(ValueToNode<size_t>(*variant, number, alternative));
+    }
+    default:
+        ythrow yexception() << "Type isn't supported by tests";
+    }
+}
+
+}
+
+// TStringTableReader
+
+TStringTableReader::TStringTableReader(TString data) : Data_(std::move(data)) { }
+
+bool TStringTableReader::Retry(const TMaybe<ui32>&, const TMaybe<ui64>&, const std::exception_ptr&) {
+    return false;
+}
+
+void TStringTableReader::ResetRetries() { }
+
+bool TStringTableReader::HasRangeIndices() const {
+    return false;
+}
+
+size_t TStringTableReader::DoRead(void* buf, size_t len) {
+    len = std::min(len, Data_.size() - Position_);
+    std::memcpy(buf, Data_.data() + Position_, len);
+    Position_ += len;
+
+    return len;
+}
+
+// Helpers
+
+::TIntrusivePtr<NYT::TRawTableReader> MakeInput(TString data) {
+    return MakeIntrusive<TStringTableReader>(std::move(data));
+}
+
+NYT::TTableSchema MakeSchema(const std::vector<std::pair<TString, NTi::TTypePtr>>& columns) {
+    NYT::TTableSchema res;
+    for (const auto& [name, type] : columns) {
+        res.AddColumn(NYT::TColumnSchema().Name(name).TypeV3(type));
+    }
+
+    return res;
+}
+
+NYT::TTableSchema MakeScalarSchema() {
+    return MakeSchema({
+        {"int8", NTi::Int8()}, {"int16", NTi::Int16()}, {"int32", NTi::Int32()}, {"int64", NTi::Int64()},
+        {"uint8", NTi::Uint8()}, {"uint16", NTi::Uint16()}, {"uint32", NTi::Uint32()}, {"uint64", NTi::Uint64()},
+        {"float", NTi::Float()}, {"double", NTi::Double()}, {"bool", NTi::Bool()},
+        {"string", NTi::String()}, {"utf8", NTi::Utf8()}});
+}
+
+NYT::TTableSchema MakeComplexSchema() {
+    return MakeSchema({
+        {"optional", NTi::Optional(NTi::String())},
+        {"list", NTi::List(NTi::Double())},
+        {"struct", NTi::Struct({{"foo", NTi::Int32()}, {"bar", NTi::String()}})},
+        {"dict", NTi::Dict(NTi::Int64(), NTi::String())},
+        {"list_of_structs", NTi::List(NTi::Struct({
+            {"id", NTi::Uint32()}, {"tags", NTi::List(NTi::String())}}))},
+        {"optional_struct", NTi::Optional(NTi::Struct({
+            {"x", NTi::Float()}, {"y", NTi::Optional(NTi::Int64())}}))}});
+}
+
+TDataSpec MakeTestSpec() {
+    TDataSpec res;
+    res.Default.MinStringLength = 0;
+    res.Default.MaxStringLength = 16;
+    res.Default.NullRatio = 0.3;
+    res.Default.MinListSize = 0;
+    res.Default.MaxListSize = 4;
+    res.ArrowBatchSize = 64;
+
+    return res;
+}
+
+TString GenerateData(enum Format format, const NYT::TTableSchema& schema, size_t rowsCount, TDataSpec spec) {
+    TString res;
+    TStringOutput output(res);
+    TDataGenerator(schema, std::move(spec)).Generate(format, &output, rowsCount);
+
+    return res;
+}
+
+NYT::TNode RowToNode(const IBaseRow& row, const NYT::TTableSchema& schema) {
+    auto type = TableSchemaToStructType(schema);
+    return StructToNode(row, type->AsStruct());
+}
+
+std::vector<NYT::TNode> ReadNodes(IRowReader& reader) {
+    std::vector<NYT::TNode> res;
+    for (; reader.IsValid(); reader.Next()) {
+        const auto& schema = reader.GetTableSchema(reader.GetReadingContext().TableIndex);
+        res.push_back(RowToNode(*reader.ReadRow(), schema));
+    }
+
+    return res;
+}
+
+std::vector<NYT::TNode> ParseNodes(TStringBuf yson) {
+    const auto list = NYT::NodeFromYsonString(TString("[") + yson + "]");
+    return std::vector<NYT::TNode>(list.AsList().begin(), list.AsList().end());
+}
+
+void AssertRowsEqual(const std::vector<NYT::TNode>& actual, const std::vector<NYT::TNode>& expected) {
+    UNIT_ASSERT_VALUES_EQUAL(actual.size(), expected.size());
+
+    for (size_t i = 0; i < actual.size(); ++i) {
+        UNIT_ASSERT_C(actual[i] == expected[i], "Row " << i << " differs: " <<
+            NYT::NodeToYsonString(actual[i]) << " != " << NYT::NodeToYsonString(expected[i]));
+    }
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include <yt/cpp/mapreduce/interface/io.h>
+#include <library/cpp/yson/node/node.h>
+
+#include <util/generic/string.h>
+
+#include <dformats/interface/io.h>
+#include <dformats/benchmarks/data_generator/lib/generator.h>
+
+namespace DFormats {
+
+// Job's input stream over data owned by the reader
+class TStringTableReader : public NYT::TRawTableReader {
+public:
+    explicit TStringTableReader(TString data);
+
+    bool Retry(const TMaybe<ui32>& rangeIndex, const TMaybe<ui64>& rowIndex,
+               const std::exception_ptr& error) override;
+    void ResetRetries() override;
+    bool HasRangeIndices() const override;
+
+protected:
+    size_t DoRead(void* buf, size_t len) override;
+
+private:
+    TString Data_;
+    size_t Position_ = 0;
+};
+
+::TIntrusivePtr<NYT::TRawTableReader> MakeInput(TString data);
+
+NYT::TTableSchema MakeSchema(const std::vector<std::pair<TString, NTi::TTypePtr>>& columns);
+
+// Column of each scalar type
+NYT::TTableSchema MakeScalarSchema();
+// Nested optionals, lists, structs and dicts. Every format supports them, Protobuf included
+NYT::TTableSchema MakeComplexSchema();
+
+// Short strings and lists and frequent nulls, so rows of small tests cover all the shapes
+TDataSpec MakeTestSpec();
+
+TString GenerateData(enum Format format, const NYT::TTableSchema& schema, size_t rowsCount,
+                     TDataSpec spec = MakeTestSpec());
+
+// Row read through the row interface. Values are converted by the schema, so rows of different formats
+// compare equal if their values are the same: ints are widened, floats are converted to doubles,
+// optionals are entities or values, dicts are lists of [key; value] and variants are [number; value]
+NYT::TNode RowToNode(const IBaseRow& row, const NYT::TTableSchema& schema);
+
+// Rest of the rows of the reader
+std::vector<NYT::TNode> ReadNodes(IRowReader& reader);
+
+// Rows of YSON list fragment
+std::vector<NYT::TNode> ParseNodes(TStringBuf yson);
+
+// Fails the test at the first differing row, printing both rows as YSON
+void AssertRowsEqual(const std::vector<NYT::TNode>& actual, const std::vector<NYT::TNode>& expected);
+
+}
@@ -4,6 +4,12 @@ namespace DFormats {
 
 TYsonRowReader::TYsonRowReader(::TIntrusivePtr<TRawTableReader> input, std::vector<TTableSchema> schemas)
   : Underlying_(new TNodeTableReader(std::move(input))), TableSchemas_(std::move(schemas)) {
+
+    RowTypes_.reserve(TableSchemas_.size());
+    for (const auto& tableSchema : TableSchemas_) {
+        RowTypes_.push_back(TableSchemaToStructType(tableSchema));
+    }
+
     RefreshReadingContext();
 }
 
@@ -23,7 +29,40 @@ void TYsonRowReader::Next() {
 IRowPtr TYsonRowReader::ReadRow()  {
     TNode node;
     Underlying_->MoveRow(&node);
-    return std::make_shared<TYsonRow>(TableSchemas_[ReadingContext_.TableIndex], std::move(node));
+    return std::make_shared<TYsonRow>(RowTypes_[ReadingContext_.TableIndex], std::move(node));
+}
+
+size_t TYsonRowReader::ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                                std::vector<TReadingContext>* contexts) {
+    if (contexts) {
+        contexts->clear();
+    }
+
+    size_t count = 0;
+    for (; count < maxCount && Underlying_->IsValid(); ++count, Next()) {
+        if (count == rows.size()) {
+            rows.emplace_back();
+        }
+
+        const auto& rowType = RowTypes_[ReadingContext_.TableIndex];
+        auto& row = rows[count];
+        auto* ysonRow = row.use_count() == 1 ? dynamic_cast<TYsonRow*>(row.get()) : nullptr;
+
+        if (ysonRow && ysonRow->GetSchema().Get() == rowType.Get()) {
+            Underlying_->MoveRow(&ysonRow->Underlying());
+        } else {
+            TNode node;
+            Underlying_->MoveRow(&node);
+            row = std::make_shared<TYsonRow>(rowType, std::move(node));
+        }
+
+        if (contexts) {
+            contexts->push_back(ReadingContext_);
+        }
+    }
+
+    rows.resize(count);
+    return count;
 }
 
 const TReadingContext& TYsonRowReader::GetReadingContext() const {
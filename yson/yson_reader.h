@@ -17,6 +17,9 @@ public:
     TYsonRowReader& operator=(TYsonRowReader&& rhs) = default;
 
     IRowPtr ReadRow() override;
+    size_t ReadRows(std::vector<IRowPtr>& rows, size_t maxCount,
+                    std::vector<TReadingContext>* contexts) override;
+    using IRowReader::ReadRows;
 
     bool IsValid() const override;
     bool IsEndOfStream() const override;
@@ -33,6 +36,7 @@ private:
 private:
     std::unique_ptr<TNodeTableReader> Underlying_;
     std::vector<TTableSchema> TableSchemas_;
+    std::vector<NTi::TTypePtr> RowTypes_;
     TReadingContext ReadingContext_;
 };
 
@@ -146,7 +146,7 @@ IStructPtr TYsonStruct::CopyStruct() const {
 
 std::vector<std::string> TYsonStruct::FieldsNames() const {
     std::vector<std::string> res;
-    res.reserve(Underlying().AsMap().size());
+    res.reserve(GetSchema()->AsStruct()->GetMembers().size());
     
     for (const auto& field : GetSchema()->AsStruct()->GetMembers()) {
         res.emplace_back(field.GetName());
@@ -463,11 +463,13 @@ TYsonRow::TYsonRow(TYsonRow&& rhs) : TYsonStruct(static_cast<TYsonStruct&&>(rhs)
     
 TYsonRow& TYsonRow::operator=(const TYsonRow& rhs) {
     TYsonStruct::operator=(rhs);
+    Columns_.clear();
     return *this;
 }
 
 TYsonRow& TYsonRow::operator=(TYsonRow&& rhs) {
     TYsonStruct::operator=(static_cast<TYsonStruct&&>(rhs));
+    Columns_.clear();
     return *this;
 }
 
@@ -475,16 +477,63 @@ IRowPtr TYsonRow::CopyRow() const {
     return std::make_shared<TYsonRow>(*this); 
 }
 
+const TNode& TYsonRow::Underlying() const {
+    return TYsonData::Underlying();
+}
+
+TNode& TYsonRow::Underlying() {
+    Columns_.clear();
+    return TYsonData::Underlying();
+}
+
+TNode&& TYsonRow::Release() {
+    Columns_.clear();
+    return TYsonData::Release();
+}
+
+void TYsonRow::AssignColumns(const TNode& values) {
+    auto& node = TYsonData::Underlying();
+    for (const auto& [name, value] : values.AsMap()) {
+        node[name] = value;
+    }
+}
+
 NTi::TTypePtr TYsonRow::GetSchema(size_t ind) const {
     return GetSchema()->AsStruct()->GetMembers()[ind].GetType();
 }
 
 const TNode& TYsonRow::GetData(size_t ind) const {
-    return GetData(GetSchema()->AsStruct()->GetMembers()[ind].GetName());
+    if (ind < Columns_.size() && Columns_[ind]) {
+        return *Columns_[ind];
+    }
+
+    const auto& name = GetSchema()->AsStruct()->GetMembers()[ind].GetName();
+    const auto& node = TYsonData::Underlying();
+    const auto* column = node.IsMap() ? node.AsMap().FindPtr(name) : nullptr;
+    if (!column) {
+        return GetData(name);
+    }
+
+    ResolveColumn(ind, column);
+    return *column;
 }
 
 TNode& TYsonRow::GetData(size_t ind) {
-    return GetData(GetSchema()->AsStruct()->GetMembers()[ind].GetName());
+    if (ind < Columns_.size() && Columns_[ind]) {
+        return *Columns_[ind];
+    }
+
+    auto& column = TYsonData::Underlying()[GetSchema()->AsStruct()->GetMembers()[ind].GetName()];
+    ResolveColumn(ind, &column);
+    return column;
+}
+
+void TYsonRow::ResolveColumn(size_t ind, const TNode* column) const {
+    if (Columns_.empty()) {
+        Columns_.resize(GetSchema()->AsStruct()->GetMembers().size(), nullptr);
+    }
+    // Written through only by the non-const accessor of this row
+    Columns_[ind] = const_cast<TNode*>(column);
 }
 
 }
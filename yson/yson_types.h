@@ -362,6 +362,14 @@ public:
 
     IRowPtr CopyRow() const override;
 
+    const TNode& Underlying() const;
+    // The node may be replaced through the returned reference, so columns resolved by position are dropped
+    TNode& Underlying();
+    TNode&& Release();
+
+    // Assigns values of the map to the columns of the same names. Columns resolved by position stay valid
+    void AssignColumns(const TNode& values);
+
     using TYsonData::GetSchema;
     using TYsonStruct::GetSchema;
 
@@ -372,6 +380,9 @@ protected:
     const TNode& GetData(size_t ind) const override;
     TNode& GetData(size_t ind) override;
 
+private:
+    void ResolveColumn(size_t ind, const TNode* column) const;
+
 protected:
     inline size_t FieldsCount() const override {
         return Underlying().Size();
@@ -382,6 +393,11 @@ protected:
     inline IStructPtr CopyStruct() const override {
         return TYsonStruct::CopyStruct();
     }
+
+private:
+    // Map entries of columns by position, so access by index or column handle skips the name lookup.
+    // Entries of a map node aren't moved on insertion, only replacing the node invalidates them
+    mutable std::vector<TNode*> Columns_;
 };
 
 }
@@ -3,14 +3,42 @@
 namespace DFormats {
 
 TYsonRowWriter::TYsonRowWriter(THolder<IProxyOutput> output, std::vector<TTableSchema> schemas)
-  : Underlying_(new TNodeTableWriter(std::move(output))), TableSchemas_(std::move(schemas)) { }
+  : Underlying_(new TNodeTableWriter(std::move(output)))
+  , TableSchemas_(std::move(schemas))
+  , RowPools_(TableSchemas_.size()) {
+
+    RowTypes_.reserve(TableSchemas_.size());
+    RowTemplates_.reserve(TableSchemas_.size());
+    for (const auto& tableSchema : TableSchemas_) {
+        RowTypes_.push_back(TableSchemaToStructType(tableSchema));
+        RowTemplates_.push_back(ConstructNode(RowTypes_.back()));
+    }
+}
 
 void TYsonRowWriter::WriteRow(const IRowConstPtr& row, size_t tableIndex) {
     Underlying_->AddRow(std::dynamic_pointer_cast<const TYsonRow>(row)->Underlying(), tableIndex);
 }
 
 void TYsonRowWriter::WriteRow(IRowPtr&& row, size_t tableIndex) {
-    Underlying_->AddRow(std::dynamic_pointer_cast<TYsonRow>(row)->Release(), tableIndex);
+    if (row.use_count() != 1) {
+        Underlying_->AddRow(dynamic_cast<TYsonRow&>(*row).Release(), tableIndex);
+        return;
+    }
+
+    Underlying_->AddRow(dynamic_cast<const TYsonRow&>(*row).Underlying(), tableIndex);
+    RecycleRow(std::move(row), tableIndex);
+}
+
+void TYsonRowWriter::RecycleRow(IRowPtr&& row, size_t tableIndex) {
+    auto& ysonRow = dynamic_cast<TYsonRow&>(*row);
+    if (ysonRow.GetSchema().Get() != RowTypes_[tableIndex].Get()) {
+        return;
+    }
+
+    // Values are reassigned one by one, so the map itself is not reallocated
+    ysonRow.AssignColumns(RowTemplates_[tableIndex]);
+
+    RowPools_[tableIndex].Release(std::move(row));
 }
 
 void TYsonRowWriter::FinishTable(size_t tableIndex) {
@@ -30,7 +58,11 @@ const NYT::TTableSchema& TYsonRowWriter::GetTableSchema(size_t tableIndex) const
 }
 
 IRowPtr TYsonRowWriter::CreateObjectForWrite(size_t tableIndex) const {
-    return std::make_shared<TYsonRow>(GetTableSchema(tableIndex));
+    if (auto row = RowPools_[tableIndex].Acquire()) {
+        return row;
+    }
+
+    return std::make_shared<TYsonRow>(RowTypes_[tableIndex]);
 }
 
 }
@@ -4,6 +4,7 @@
 
 #include "yson_types.h"
 #include <dformats/interface/io.h>
+#include <dformats/common/row_pool.h>
 
 using namespace NYT;
 
@@ -25,9 +26,17 @@ public:
     const NYT::TTableSchema& GetTableSchema(size_t tableIndex) const override;
     IRowPtr CreateObjectForWrite(size_t tableIndex) const override;
 
+protected:
+    void RecycleRow(IRowPtr&& row, size_t tableIndex);
+
 protected:
     std::unique_ptr<TNodeTableWriter> Underlying_;
     std::vector<TTableSchema> TableSchemas_;
+    std::vector<NTi::TTypePtr> RowTypes_;
+
+    // Nodes with default values used for resetting rows returned to the pools
+    std::vector<TNode> RowTemplates_;
+    mutable std::vector<TRowPool> RowPools_;
 };
 
 }